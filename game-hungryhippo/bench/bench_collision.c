@@ -0,0 +1,173 @@
+/**
+ * Microbenchmark for find_collision on the game's real shapes, comparing it
+ * against a scalar reference copy of the separating axis test that projects
+ * one vertex at a time and recomputes both centroids on every call (as
+ * find_collision used to).
+ *
+ * Run from the game directory, since the shapes are loaded from static/.
+ */
+#include "bench_util.h"
+#include "collision.h"
+#include "polygon.h"
+#include "shapes_geometry.h"
+#include "vector.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+const char *BENCH_PATH_BALL_SHAPE = "static/ball/ball_collision_shape.csv";
+const char *BENCH_PATH_HIPPO_SHAPES[] = {"static/hippo/shape-chilling.csv",
+                                         "static/hippo/shape-eating.csv",
+                                         "static/hippo/shape-mouth.csv"};
+const size_t BENCH_NUM_HIPPO_SHAPES = 3;
+const double BENCH_BALL_RADIUS = 33.0;
+const size_t BENCH_BALL_RESOLUTION = 40;
+
+typedef collision_info_t (*collision_func_t)(polygon_t *shape1,
+                                             polygon_t *shape2);
+
+/*** REFERENCE IMPLEMENTATION ***/
+
+vector_t reference_centroid(polygon_t *shape) {
+    size_t n = polygon_size(shape);
+    double area = polygon_area(shape);
+    double sum_x = 0;
+    double sum_y = 0;
+    for (size_t i = 0; i < n; i++) {
+        vector_t p1 = polygon_get(shape, i);
+        vector_t p2 = polygon_get(shape, (i + 1) % n);
+        double cross = vec_cross(p1, p2);
+        sum_x += (p1.x + p2.x) * cross;
+        sum_y += (p1.y + p2.y) * cross;
+    }
+    return (vector_t){.x = sum_x / (6 * area), .y = sum_y / (6 * area)};
+}
+
+vector_t reference_projection(vector_t line, polygon_t *shape) {
+    double min = INFINITY;
+    double max = -INFINITY;
+    for (size_t i = 0; i < polygon_size(shape); i++) {
+        double curr_project = vec_dot(line, polygon_get(shape, i));
+        min = fmin(min, curr_project);
+        max = fmax(max, curr_project);
+    }
+    return (vector_t){.x = min, .y = max};
+}
+
+double reference_overlap(vector_t line, polygon_t *shape1, polygon_t *shape2) {
+    vector_t min_max1 = reference_projection(line, shape1);
+    vector_t min_max2 = reference_projection(line, shape2);
+    return fmin(min_max1.y, min_max2.y) - fmax(min_max1.x, min_max2.x);
+}
+
+collision_info_t reference_find_collision(polygon_t *shape1,
+                                          polygon_t *shape2) {
+    polygon_t *shapes[2] = {shape1, shape2};
+    vector_t centroids[2]
+        = {reference_centroid(shape1), reference_centroid(shape2)};
+    double min_overlap = INFINITY;
+    collision_info_t info = {.collided = true};
+
+    for (size_t s = 0; s < 2; s++) {
+        polygon_t *shape = shapes[s];
+        size_t n = polygon_size(shape);
+        for (size_t i = 0; i < n; i++) {
+            vector_t p1 = polygon_get(shape, i);
+            vector_t p2 = polygon_get(shape, (i + 1) % n);
+            // Points out of shape 1 and into shape 2.
+            vector_t axis = find_norm_perpendicular_vec(
+                s == 0 ? vec_subtract(p1, p2) : vec_subtract(p2, p1));
+            double overlap = reference_overlap(axis, shape1, shape2);
+            if (overlap <= 0) {
+                return (collision_info_t){.collided = false};
+            }
+            if (overlap < min_overlap) {
+                vector_t other = centroids[1 - s];
+                double d1 = vec_magnitude(vec_subtract(p1, other));
+                double d2 = vec_magnitude(vec_subtract(p2, other));
+                info.collision_point = d1 < d2 ? p1 : p2;
+                info.axis = axis;
+                min_overlap = overlap;
+            }
+        }
+    }
+    return info;
+}
+
+/*** BENCHMARK ***/
+
+typedef struct collision_bench {
+    collision_func_t func;
+    polygon_t *shape1;
+    polygon_t *shape2;
+} collision_bench_t;
+
+void bench_collision_pair(collision_bench_t *bench, size_t iterations) {
+    size_t collisions = 0;
+    for (size_t i = 0; i < iterations; i++) {
+        collisions += bench->func(bench->shape1, bench->shape2).collided;
+    }
+    bench_use(collisions);
+}
+
+/**
+ * Time find_collision and the reference implementation on the shapes, checking
+ * first that they agree.
+ */
+void bench_shapes(const char *name, polygon_t *shape1, polygon_t *shape2) {
+    collision_info_t expected = reference_find_collision(shape1, shape2);
+    if (find_collision(shape1, shape2).collided != expected.collided) {
+        fprintf(stderr, "Fatal error: collision results disagree.\n");
+        exit(1);
+    }
+
+    char row[128];
+    collision_bench_t bench = {reference_find_collision, shape1, shape2};
+    snprintf(row, sizeof(row), "reference_find_collision/%s", name);
+    bench_run(row, (bench_func_t)bench_collision_pair, &bench);
+    bench.func = find_collision;
+    snprintf(row, sizeof(row), "find_collision/%s", name);
+    bench_run(row, (bench_func_t)bench_collision_pair, &bench);
+}
+
+int main(int argc, char *argv[]) {
+    bench_init(argc, argv);
+
+    for (size_t i = 0; i < BENCH_NUM_HIPPO_SHAPES; i++) {
+        polygon_t *hippo = polygon_init_from_path(BENCH_PATH_HIPPO_SHAPES[i]);
+        vector_t centroid = polygon_centroid(hippo);
+        aabb_t box = polygon_aabb(hippo);
+        polygon_t *balls[2]
+            = {make_circle_polygon(BENCH_BALL_RADIUS,
+                                   BENCH_BALL_RESOLUTION,
+                                   centroid),
+               polygon_init_from_path(BENCH_PATH_BALL_SHAPE)};
+        const char *ball_names[2] = {"40-gon", "ball csv"};
+
+        for (size_t b = 0; b < 2; b++) {
+            char name[64];
+            // Overlapping, so every axis is tested.
+            polygon_set_centroid(balls[b], centroid);
+            snprintf(name,
+                     sizeof(name),
+                     "%s/%s hit",
+                     BENCH_PATH_HIPPO_SHAPES[i] + strlen("static/hippo/"),
+                     ball_names[b]);
+            bench_shapes(name, hippo, balls[b]);
+            // Beside the hippo, so the test exits early.
+            aabb_t ball_box = polygon_aabb(balls[b]);
+            double ball_width = ball_box.max.x - ball_box.min.x;
+            vector_t beside = {box.max.x + ball_width, centroid.y};
+            polygon_set_centroid(balls[b], beside);
+            snprintf(name,
+                     sizeof(name),
+                     "%s/%s miss",
+                     BENCH_PATH_HIPPO_SHAPES[i] + strlen("static/hippo/"),
+                     ball_names[b]);
+            bench_shapes(name, hippo, balls[b]);
+            polygon_free(balls[b]);
+        }
+        polygon_free(hippo);
+    }
+}
@@ -0,0 +1,63 @@
+/**
+ * Benchmark for whole headless games: every tick of the game proper, with
+ * nobody at the keys, so the balls just bounce around the hippos.
+ *
+ * Run from the game directory, since the game loads static/.
+ */
+#include "bench_util.h"
+#include "ehhh.h"
+#include <stdio.h>
+
+const size_t BENCH_PLAYER_COUNT = 4;
+const size_t BENCH_BALLS_PER_ROUND = 30;
+// At the game's default 120 ticks a second.
+const size_t BENCH_TICKS_PER_ROUND = 120 * 30;
+const size_t BENCH_WARMUP_TICKS = 120 * 10;
+
+ehhh_t *make_game(void) {
+    ehhh_t *ehhh = ehhh_init(BENCH_PLAYER_COUNT,
+                             BENCH_BALLS_PER_ROUND,
+                             true,
+                             NULL);
+    // Seeded from the time in ehhh_init, so reseed to spawn the same balls
+    // every time.
+    srand(1);
+    return ehhh;
+}
+
+void bench_game_tick(ehhh_t *ehhh, size_t iterations) {
+    for (size_t i = 0; i < iterations; i++) {
+        // Headless games take one fixed step per tick whatever the dt.
+        ehhh_tick(ehhh, 0);
+    }
+}
+
+void bench_game_round(void *aux, size_t iterations) {
+    for (size_t i = 0; i < iterations; i++) {
+        ehhh_t *ehhh = make_game();
+        bench_game_tick(ehhh, BENCH_TICKS_PER_ROUND);
+        ehhh_free(ehhh);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    bench_init(argc, argv);
+
+    char name[64];
+    // Once every ball is out.
+    ehhh_t *ehhh = make_game();
+    bench_game_tick(ehhh, BENCH_WARMUP_TICKS);
+    snprintf(name,
+             sizeof(name),
+             "game_tick/headless/%zu players %zu balls",
+             BENCH_PLAYER_COUNT,
+             BENCH_BALLS_PER_ROUND);
+    bench_run(name, (bench_func_t)bench_game_tick, ehhh);
+    ehhh_free(ehhh);
+
+    snprintf(name,
+             sizeof(name),
+             "game_round/headless/%zu ticks",
+             BENCH_TICKS_PER_ROUND);
+    bench_run(name, bench_game_round, NULL);
+}
@@ -0,0 +1,53 @@
+/**
+ * Benchmark for list_add and list_remove.
+ */
+#include "bench_util.h"
+#include "list.h"
+#include <stdio.h>
+
+const size_t BENCH_LIST_SIZE = 1000;
+
+void bench_list_add(void *aux, size_t iterations) {
+    list_t *list = list_init(1, NULL);
+    for (size_t i = 0; i < iterations; i++) {
+        list_add(list, list);
+    }
+    bench_use(list_size(list));
+    list_free(list);
+}
+
+void bench_list_remove_back(void *aux, size_t iterations) {
+    list_t *list = list_init(iterations, NULL);
+    for (size_t i = 0; i < iterations; i++) {
+        list_add(list, list);
+    }
+    bench_reset_timer();
+    for (size_t i = 0; i < iterations; i++) {
+        bench_use((uintptr_t)list_remove(list, list_size(list) - 1));
+    }
+    list_free(list);
+}
+
+void bench_list_remove_front(void *aux, size_t iterations) {
+    // Each removal shifts the rest of the list down, so keep its size steady.
+    list_t *list = list_init(BENCH_LIST_SIZE, NULL);
+    for (size_t i = 0; i < BENCH_LIST_SIZE; i++) {
+        list_add(list, list);
+    }
+    bench_reset_timer();
+    for (size_t i = 0; i < iterations; i++) {
+        list_add(list, list_remove(list, 0));
+    }
+    bench_use(list_size(list));
+    list_free(list);
+}
+
+int main(int argc, char *argv[]) {
+    bench_init(argc, argv);
+
+    char name[64];
+    bench_run("list_add", bench_list_add, NULL);
+    bench_run("list_remove/back", bench_list_remove_back, NULL);
+    snprintf(name, sizeof(name), "list_remove/front of %zu", BENCH_LIST_SIZE);
+    bench_run(name, bench_list_remove_front, NULL);
+}
@@ -0,0 +1,127 @@
+/**
+ * Benchmark for physics_tick on N balls bouncing around a walled box, off each
+ * other and the walls, under a little drag.
+ */
+#include "bench_util.h"
+#include "body.h"
+#include "forces.h"
+#include "list.h"
+#include "physics.h"
+#include "polygon.h"
+#include "shapes_geometry.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+const size_t BENCH_BALL_COUNTS[] = {10, 100, 1000};
+const size_t BENCH_NUM_BALL_COUNTS = 3;
+const double BENCH_BALL_RADIUS = 10.0;
+const double BENCH_BALL_SPACING = 30.0;
+const double BENCH_BALL_SPEED = 200.0;
+const double BENCH_WALL_THICKNESS = 50.0;
+const double BENCH_ELASTICITY = 1.0;
+const double BENCH_DRAG = 0.01;
+const double BENCH_DT = 1.0 / 60.0;
+
+typedef struct physics_bench {
+    physics_t *physics;
+    list_t *balls;
+    list_t *walls;
+} physics_bench_t;
+
+body_t *make_box_body(vector_t center, double width, double height) {
+    list_t *shapes = list_init(1, (free_func_t)polygon_free);
+    list_add(shapes, make_rectangle_polygon(center, height, width));
+    return body_init_with_gfx(INFINITY, NULL, NULL, shapes, NULL);
+}
+
+/**
+ * Make a physics layer with 'count' balls in a square grid, each headed off in
+ * its own direction, inside four walls.
+ */
+physics_bench_t make_physics_bench(size_t count, double polygon_resolution) {
+    physics_bench_t bench;
+    bench.physics = physics_init();
+    bench.balls = list_init(count, (free_func_t)body_free);
+    bench.walls = list_init(4, (free_func_t)body_free);
+    size_t side = (size_t)ceil(sqrt(count));
+    double size = side * BENCH_BALL_SPACING;
+
+    srand(1);
+    for (size_t i = 0; i < count; i++) {
+        vector_t center = {(i % side + 0.5) * BENCH_BALL_SPACING,
+                           (i / side + 0.5) * BENCH_BALL_SPACING};
+        body_t *ball = make_circle(BENCH_BALL_RADIUS,
+                                   polygon_resolution,
+                                   center,
+                                   1,
+                                   NULL,
+                                   NULL,
+                                   (rgb_color_t){0});
+        double angle = 2 * M_PI * rand() / RAND_MAX;
+        body_set_velocity(ball,
+                          (vector_t){BENCH_BALL_SPEED * cos(angle),
+                                     BENCH_BALL_SPEED * sin(angle)});
+        list_add(bench.balls, ball);
+    }
+    double t = BENCH_WALL_THICKNESS;
+    double outer = size + 2 * t;
+    list_add(bench.walls,
+             make_box_body((vector_t){size / 2, -t / 2}, outer, t));
+    list_add(bench.walls,
+             make_box_body((vector_t){size / 2, size + t / 2}, outer, t));
+    list_add(bench.walls,
+             make_box_body((vector_t){-t / 2, size / 2}, t, size));
+    list_add(bench.walls,
+             make_box_body((vector_t){size + t / 2, size / 2}, t, size));
+
+    physics_add_bodies(bench.physics, bench.balls);
+    physics_add_bodies(bench.physics, bench.walls);
+    create_physics_collision_rule(bench.physics,
+                                  BENCH_ELASTICITY,
+                                  bench.balls,
+                                  bench.balls,
+                                  NULL,
+                                  NULL);
+    create_physics_collision_rule(bench.physics,
+                                  BENCH_ELASTICITY,
+                                  bench.balls,
+                                  bench.walls,
+                                  NULL,
+                                  NULL);
+    create_group_drag(bench.physics, BENCH_DRAG, bench.balls);
+    return bench;
+}
+
+void free_physics_bench(physics_bench_t *bench) {
+    physics_free(bench->physics);
+    list_free(bench->balls);
+    list_free(bench->walls);
+}
+
+void bench_physics_tick(physics_bench_t *bench, size_t iterations) {
+    for (size_t i = 0; i < iterations; i++) {
+        physics_tick(bench->physics, BENCH_DT);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    bench_init(argc, argv);
+
+    // Exact circles, then 20-gons like the game's older ball shapes.
+    const double RESOLUTIONS[] = {0, 20};
+    for (size_t r = 0; r < 2; r++) {
+        for (size_t i = 0; i < BENCH_NUM_BALL_COUNTS; i++) {
+            char name[64];
+            snprintf(name,
+                     sizeof(name),
+                     "physics_tick/%zu balls/%s",
+                     BENCH_BALL_COUNTS[i],
+                     RESOLUTIONS[r] == 0 ? "circle" : "20-gon");
+            physics_bench_t bench
+                = make_physics_bench(BENCH_BALL_COUNTS[i], RESOLUTIONS[r]);
+            bench_run(name, (bench_func_t)bench_physics_tick, &bench);
+            free_physics_bench(&bench);
+        }
+    }
+}
@@ -0,0 +1,57 @@
+/**
+ * Benchmark for polygon_centroid on the game's real shapes, both when it has
+ * to be worked out and when it is already cached.
+ *
+ * Run from the game directory, since the shapes are loaded from static/.
+ */
+#include "bench_util.h"
+#include "polygon.h"
+#include "shapes_geometry.h"
+#include "vector.h"
+#include <stdio.h>
+#include <string.h>
+
+const char *BENCH_PATH_SHAPES[] = {"static/hippo/shape-chilling.csv",
+                                   "static/hippo/shape-mouth.csv",
+                                   "static/ball/ball_collision_shape.csv"};
+const size_t BENCH_NUM_SHAPES = 3;
+
+void bench_centroid_fresh(polygon_t *polygon, size_t iterations) {
+    vector_t first = polygon_get(polygon, 0);
+    double sum = 0;
+    for (size_t i = 0; i < iterations; i++) {
+        // Any change to the vertices drops the cached centroid.
+        polygon_set(polygon, 0, first);
+        sum += polygon_centroid(polygon).x;
+    }
+    bench_use((uintptr_t)sum);
+}
+
+void bench_centroid_cached(polygon_t *polygon, size_t iterations) {
+    double sum = 0;
+    for (size_t i = 0; i < iterations; i++) {
+        sum += polygon_centroid(polygon).x;
+    }
+    bench_use((uintptr_t)sum);
+}
+
+void bench_shape(const char *name, polygon_t *polygon) {
+    char row[128];
+    snprintf(row, sizeof(row), "polygon_centroid/%s/fresh", name);
+    bench_run(row, (bench_func_t)bench_centroid_fresh, polygon);
+    snprintf(row, sizeof(row), "polygon_centroid/%s/cached", name);
+    bench_run(row, (bench_func_t)bench_centroid_cached, polygon);
+}
+
+int main(int argc, char *argv[]) {
+    bench_init(argc, argv);
+
+    for (size_t i = 0; i < BENCH_NUM_SHAPES; i++) {
+        polygon_t *polygon = polygon_init_from_path(BENCH_PATH_SHAPES[i]);
+        bench_shape(strrchr(BENCH_PATH_SHAPES[i], '/') + 1, polygon);
+        polygon_free(polygon);
+    }
+    polygon_t *circle = make_circle_polygon(33, 40, VEC_ZERO);
+    bench_shape("40-gon", circle);
+    polygon_free(circle);
+}
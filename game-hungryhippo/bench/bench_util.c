@@ -0,0 +1,129 @@
+#include "bench_util.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/*** PRIVATE CONSTS ***/
+// How long a run must take for its timing to count.
+const double _BENCH_MIN_SECONDS = 0.5;
+const size_t _BENCH_MAX_ITERATIONS = 1000000000;
+
+/*** GLOBALS ***/
+const char *_bench_filter = NULL;
+volatile uintptr_t _bench_sink = 0;
+// Since the start of the current run.
+double _bench_start_seconds = 0;
+atomic_size_t _bench_allocs = 0;
+atomic_size_t _bench_bytes = 0;
+
+/*** PRIVATE PROTOTYPES ***/
+
+/**
+ * Return the time in seconds on a clock that only goes forwards.
+ */
+double _bench_now(void);
+
+/**
+ * Note an allocation of 'size' bytes.
+ */
+void _bench_count(size_t size);
+
+// The real allocators, which the benchmarks are linked to call through the
+// wrappers below (see -Wl,--wrap in the Makefile).
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void *__real_aligned_alloc(size_t alignment, size_t size);
+void *__wrap_malloc(size_t size);
+void *__wrap_calloc(size_t count, size_t size);
+void *__wrap_realloc(void *ptr, size_t size);
+void *__wrap_aligned_alloc(size_t alignment, size_t size);
+
+/*** DEFINITIONS ***/
+
+void bench_init(int argc, char *argv[]) {
+    bool header = true;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--no-header") == 0) {
+            header = false;
+        } else {
+            _bench_filter = argv[i];
+        }
+    }
+    if (header) {
+        puts("benchmark,iterations,ns_per_op,allocs_per_op,bytes_per_op");
+    }
+}
+
+void bench_run(const char *name, bench_func_t func, void *aux) {
+    if (_bench_filter != NULL && strstr(name, _bench_filter) == NULL) {
+        return;
+    }
+    size_t iterations = 1;
+    double seconds;
+    while (true) {
+        bench_reset_timer();
+        func(aux, iterations);
+        seconds = _bench_now() - _bench_start_seconds;
+        if (seconds >= _BENCH_MIN_SECONDS
+            || iterations >= _BENCH_MAX_ITERATIONS) {
+            break;
+        }
+        // Aim a bit past the minimum, but don't jump too far on one fast run.
+        double predicted = iterations * 1.2 * _BENCH_MIN_SECONDS
+                           / (seconds > 0 ? seconds : 1e-9);
+        size_t next = predicted > 100.0 * iterations ? 100 * iterations
+                                                     : (size_t)predicted;
+        iterations = next > iterations ? next : iterations + 1;
+    }
+    printf("%s,%zu,%.1f,%.2f,%.1f\n",
+           name,
+           iterations,
+           seconds * 1e9 / iterations,
+           (double)atomic_load(&_bench_allocs) / iterations,
+           (double)atomic_load(&_bench_bytes) / iterations);
+    fflush(stdout);
+}
+
+void bench_reset_timer(void) {
+    atomic_store(&_bench_allocs, 0);
+    atomic_store(&_bench_bytes, 0);
+    _bench_start_seconds = _bench_now();
+}
+
+void bench_use(uintptr_t value) {
+    _bench_sink ^= value;
+}
+
+double _bench_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+void _bench_count(size_t size) {
+    atomic_fetch_add_explicit(&_bench_allocs, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&_bench_bytes, size, memory_order_relaxed);
+}
+
+void *__wrap_malloc(size_t size) {
+    _bench_count(size);
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size) {
+    _bench_count(count * size);
+    return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+    _bench_count(size);
+    return __real_realloc(ptr, size);
+}
+
+void *__wrap_aligned_alloc(size_t alignment, size_t size) {
+    _bench_count(size);
+    return __real_aligned_alloc(alignment, size);
+}
@@ -0,0 +1,43 @@
+/** Common functions for benchmarks. */
+
+#ifndef __BENCH_UTIL_H__
+#define __BENCH_UTIL_H__
+
+#include <stdint.h>
+#include <stdlib.h>
+
+/**
+ * A function that does the operation being measured 'iterations' times.
+ * Setup that shouldn't count can be done first, followed by a call to
+ * 'bench_reset_timer'.
+ */
+typedef void (*bench_func_t)(void *aux, size_t iterations);
+
+/**
+ * Read a benchmark program's arguments, '[--no-header] [FILTER]', and print the
+ * CSV header unless told not to. Only benchmarks whose names contain FILTER
+ * are run.
+ */
+void bench_init(int argc, char *argv[]);
+
+/**
+ * Run 'func' with more and more iterations until it takes long enough to time
+ * reliably, then print a CSV row of its name, the number of iterations, and
+ * the nanoseconds, allocations (calls to malloc, calloc, realloc and
+ * aligned_alloc) and bytes allocated per iteration.
+ */
+void bench_run(const char *name, bench_func_t func, void *aux);
+
+/**
+ * Restart the clock and the allocation counts of the current run, e.g. after
+ * setup.
+ */
+void bench_reset_timer(void);
+
+/**
+ * Pretend to use 'value', so that the compiler can't optimize away the work
+ * that produced it.
+ */
+void bench_use(uintptr_t value);
+
+#endif // #ifndef __BENCH_UTIL_H__
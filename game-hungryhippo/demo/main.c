@@ -1,6 +1,9 @@
 #include "ehhh.h"
+#include "profiler.h"
+#include "replay.h"
 #include "sdl_wrapper.h"
 #include "vector.h"
+#include <time.h>
 
 /*** CONSTANTS ***/
 char *USAGE_PATH = "static/usage.txt";
@@ -64,6 +67,10 @@ int main(int argc, char **argv) {
     }
     size_t player_count = DEFAULT_PLAYER_COUNT;
     size_t balls_per_round = DEFAULT_BALLS_PER_ROUND;
+    bool headless = false;
+    char *record_path = NULL;
+    char *replay_path = NULL;
+    char *profile_path = NULL;
     for (size_t i = 1; i < argc; i++) {
         char *a = argv[i];
         if (strscmp(a, "help\0--help\0-h", 3) == 0) {
@@ -114,6 +121,34 @@ int main(int argc, char **argv) {
             }
             i++;
             continue;
+        } else if (strcmp(a, "--headless") == 0) {
+            headless = true;
+            continue;
+        } else if (strcmp(a, "--record") == 0 || strcmp(a, "--replay") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Option requires an argument: %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+            if (strcmp(a, "--record") == 0) {
+                record_path = argv[i + 1];
+            } else {
+                replay_path = argv[i + 1];
+            }
+            i++;
+            continue;
+        } else if (strcmp(a, "--profile") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Option requires an argument: %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+#ifndef PROFILE
+            fprintf(stderr,
+                    "Built without the profiler: do 'make PROFILE=1'.\n");
+            return EXIT_FAILURE;
+#endif
+            profile_path = argv[i + 1];
+            i++;
+            continue;
         } else {
             fprintf(stderr, "Unrecognized argument: %s\n", argv[i]);
             print_usage(stderr, progname);
@@ -121,10 +156,40 @@ int main(int argc, char **argv) {
         }
     }
 
+    if (record_path != NULL && replay_path != NULL) {
+        fprintf(stderr, "Cannot both record and replay a game.\n");
+        return EXIT_FAILURE;
+    }
+
+    // A replay's options are the ones it was recorded with.
+    replay_t *replay = NULL;
+    if (record_path != NULL) {
+        uint32_t params[] = {player_count, balls_per_round};
+        replay = replay_init_record(record_path, time(NULL), params, 2);
+    } else if (replay_path != NULL) {
+        replay = replay_init_playback(replay_path);
+        size_t param_count;
+        const uint32_t *params = replay_get_params(replay, &param_count);
+        if (param_count != 2) {
+            fprintf(stderr, "Not a replay of this game: %s\n", replay_path);
+            return EXIT_FAILURE;
+        }
+        player_count = params[0];
+        balls_per_round = params[1];
+    }
+
     // Entry point.
-    ehhh_t *ehhh = ehhh_init(player_count, balls_per_round);
+    ehhh_t *ehhh = ehhh_init(player_count, balls_per_round, headless, replay);
+    if (profile_path != NULL) {
+        profiler_start_trace();
+    }
     while (!ehhh_tick(ehhh, time_since_last_tick())) {}
+    if (profile_path != NULL) {
+        profiler_write_trace(profile_path);
+        profiler_print_report(stderr);
+    }
     ehhh_free(ehhh);
+    profiler_free();
 
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,110 @@
+#ifndef __ALLOC_STATS_H__
+#define __ALLOC_STATS_H__
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/*** INTERFACE ***/
+
+/**
+ * Allocation accounting: how many heap allocations, and how many bytes, each
+ * subsystem makes, per tick and per period (e.g. a round), and how many of
+ * its objects are alive.
+ *
+ * The library's own allocation sites are tagged with the macros below, which
+ * only count anything when it is compiled with ALLOC_STATS defined
+ * (make ALLOC_STATS=1), and compile to nothing otherwise. Counting is safe from
+ * any thread, e.g. from physics workers.
+ */
+
+/**
+ * The subsystems whose allocations are counted.
+ */
+typedef enum alloc_subsystem {
+    ALLOC_SUBSYSTEM_LIST,   // list_t and their growth.
+    ALLOC_SUBSYSTEM_VECTOR, // vec_p_copy.
+    ALLOC_SUBSYSTEM_AUX,    // Force auxes, typed or not.
+    ALLOC_SUBSYSTEM_SPRITE, // sprite_t.
+    ALLOC_SUBSYSTEM_BODY,   // Body pool slabs and shape arrays.
+    ALLOC_SUBSYSTEM_COUNT
+} alloc_subsystem_t;
+
+/**
+ * What a subsystem allocated over some time, and how many of its objects are
+ * alive now.
+ */
+typedef struct alloc_counts {
+    size_t allocs;
+    size_t bytes;
+    size_t live; // Always 0 for subsystems that can't count their frees.
+} alloc_counts_t;
+
+#ifdef ALLOC_STATS
+/**
+ * Count one allocation of 'bytes' by the subsystem ALLOC_SUBSYSTEM_<subsystem>.
+ */
+#define ALLOC_STATS_ALLOC(subsystem, bytes)                                    \
+    alloc_stats_alloc(ALLOC_SUBSYSTEM_##subsystem, bytes)
+/**
+ * Count an object of the subsystem coming to life or being freed.
+ */
+#define ALLOC_STATS_CREATE(subsystem)                                          \
+    alloc_stats_live(ALLOC_SUBSYSTEM_##subsystem, 1)
+#define ALLOC_STATS_DESTROY(subsystem)                                         \
+    alloc_stats_live(ALLOC_SUBSYSTEM_##subsystem, -1)
+/**
+ * End the tick (see alloc_stats_end_tick).
+ */
+#define ALLOC_STATS_END_TICK() alloc_stats_end_tick()
+#else
+#define ALLOC_STATS_ALLOC(subsystem, bytes)
+#define ALLOC_STATS_CREATE(subsystem)
+#define ALLOC_STATS_DESTROY(subsystem)
+#define ALLOC_STATS_END_TICK()
+#endif
+
+/**
+ * Count one allocation of 'bytes' by the subsystem.
+ */
+void alloc_stats_alloc(alloc_subsystem_t subsystem, size_t bytes);
+
+/**
+ * Add 'delta' to the number of the subsystem's live objects.
+ */
+void alloc_stats_live(alloc_subsystem_t subsystem, int delta);
+
+/**
+ * Return what the subsystem allocated since the program started.
+ */
+alloc_counts_t alloc_stats_total(alloc_subsystem_t subsystem);
+
+/**
+ * End the tick: keep what each subsystem allocated since the end of the last
+ * one as the last tick's counts, and add them to the period's.
+ */
+void alloc_stats_end_tick(void);
+
+/**
+ * Return what the subsystem allocated in the last tick that was ended.
+ */
+alloc_counts_t alloc_stats_last_tick(alloc_subsystem_t subsystem);
+
+/**
+ * Return the subsystem's name, e.g. "list".
+ */
+const char *alloc_stats_subsystem_name(alloc_subsystem_t subsystem);
+
+/**
+ * Print what each subsystem allocated in the ticks ended since the last report
+ * (in total, per tick on average and in the worst tick), and its live objects,
+ * to 'out' under the title 'title', and start a new period.
+ */
+void alloc_stats_report(FILE *out, const char *title);
+
+/**
+ * Forget all counts, as if the program had just started.
+ */
+void alloc_stats_reset(void);
+
+#endif // #ifndef __ALLOC_STATS_H__
@@ -0,0 +1,48 @@
+#ifndef __ARENA_H__
+#define __ARENA_H__
+
+#include <stddef.h>
+
+/*** INTERFACE ***/
+
+/**
+ * A bump allocator for short-lived memory, e.g. scratch buffers that only have
+ * to last until the end of the frame.
+ * Allocations are never freed individually; instead the whole arena is reset
+ * at once, after which all memory previously allocated from it is invalid.
+ *
+ * If an arena runs out of room, it chains on another block. On the next reset
+ * the blocks are merged into one big enough for everything, so an arena that
+ * is reset every frame stops calling malloc once it has seen its largest frame.
+ */
+typedef struct arena arena_t;
+
+/**
+ * Allocate an empty arena with room for 'capacity' bytes before it has to grow.
+ */
+arena_t *arena_init(size_t capacity);
+
+/**
+ * Free the arena and all memory allocated from it.
+ */
+void arena_free(arena_t *arena);
+
+/**
+ * Return 'size' bytes of uninitialized memory, aligned for any type, that stays
+ * valid until the arena is next reset or freed.
+ */
+void *arena_alloc(arena_t *arena, size_t size);
+
+/**
+ * Invalidate everything allocated from the arena, making its memory available
+ * to be allocated again.
+ */
+void arena_reset(arena_t *arena);
+
+/**
+ * Return the number of bytes allocated from the arena since it was last reset
+ * (including padding for alignment).
+ */
+size_t arena_used(arena_t *arena);
+
+#endif // #ifndef __ARENA_H__
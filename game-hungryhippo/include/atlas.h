@@ -0,0 +1,64 @@
+#ifndef __ATLAS_H__
+#define __ATLAS_H__
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+
+/*** INTERFACE ***/
+
+/**
+ * A texture atlas: many (already scaled) images packed into one texture, so
+ * that everything drawn from it can be submitted to the renderer in a single
+ * batch without switching textures.
+ *
+ * Images are identified by the path and scale they were loaded with, and are
+ * packed onto horizontal shelves as they are added. The pixels are kept in a
+ * surface and only uploaded to a texture when the texture is next requested,
+ * so adding many images at startup only uploads once.
+ */
+typedef struct atlas atlas_t;
+
+/**
+ * Create an empty atlas of the given dimensions in pixels.
+ */
+atlas_t *atlas_init(int width, int height);
+
+/**
+ * Free the atlas and its texture.
+ */
+void atlas_free(atlas_t *atlas);
+
+/**
+ * Look up the image loaded from 'img_path' at 'scale'. If it is in the atlas,
+ * set 'region' to where it is and return true; otherwise return false.
+ */
+bool atlas_find(atlas_t *atlas,
+                const char *img_path,
+                double scale,
+                SDL_Rect *region);
+
+/**
+ * Copy 'surface', the image loaded from 'img_path' at 'scale', into the atlas
+ * and set 'region' to where it was put. Return false (leaving the atlas
+ * unchanged) if there is no room for it, or if it is so big that packing it
+ * would waste much of the atlas. Does not free the surface.
+ */
+bool atlas_add(atlas_t *atlas,
+               const char *img_path,
+               double scale,
+               SDL_Surface *surface,
+               SDL_Rect *region);
+
+/**
+ * Return the atlas's dimensions in pixels, e.g. to convert regions into
+ * texture coordinates.
+ */
+SDL_Point atlas_get_dims(atlas_t *atlas);
+
+/**
+ * Return the atlas's texture for 'renderer', uploading it first if images have
+ * been added since it was last requested. The texture is owned by the atlas.
+ */
+SDL_Texture *atlas_get_texture(atlas_t *atlas, SDL_Renderer *renderer);
+
+#endif // #ifndef __ATLAS_H__
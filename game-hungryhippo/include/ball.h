@@ -52,12 +52,34 @@ typedef struct player player_t;
 typedef struct ehhh ehhh_t;
 
 /**
- * Add a ball to world.
+ * Whether balls collide as exact circles by default (see spawn_ball).
+ */
+extern const bool BALL_ROUND;
+
+/**
+ * Add a ball to world. If 'round', the ball collides as an exact circle the
+ * size of its collision shape, which is much cheaper than colliding the
+ * polygon outline from the collision shape file.
  */
 void spawn_ball(ehhh_t *ehhh,
                 vector_t init_pos,
                 vector_t init_vel,
-                ball_power_type_e type);
+                ball_power_type_e type,
+                bool round);
+
+/**
+ * Load the collision shape of balls and pack the sprites of every type of ball
+ * into the atlas, so that spawning balls mid-game doesn't read any files or
+ * change the atlas.
+ */
+void ball_preload(void);
+
+/**
+ * Register the collision rules between the players and balls of world, i.e.
+ * bouncing and eating. Must be called once, after the player and ball groups
+ * have been added to the physics layer. Balls spawned later are covered too.
+ */
+void ball_add_collision_rules(ehhh_t *ehhh);
 
 void powerup_free(powerup_t *powerup);
 
@@ -68,9 +90,9 @@ void powerup_eat(powerup_t *powerup, ehhh_t *ehhh, player_t *player);
 powerup_t *powerup_init(ball_power_type_e type);
 
 /**
- * Return a string specifying the powerup which will need to be freed
- * by the caller.
+ * Write a string specifying the powerup into 'buf' of 'size' characters,
+ * truncating it if needed. A NULL powerup gives the empty string.
  */
-char *powerup_str(powerup_t *powerup);
+void powerup_str(powerup_t *powerup, char *buf, size_t size);
 
 #endif // #ifnded __BALL_H__
@@ -0,0 +1,71 @@
+#ifndef __BARNES_HUT_H__
+#define __BARNES_HUT_H__
+
+#include "vector.h"
+#include <stdlib.h>
+
+/*** DEPENDENCY FORWARD DECLARATIONS ***/
+typedef struct body body_t;
+typedef struct list list_t;
+
+/*** INTERFACE ***/
+
+/**
+ * A Barnes-Hut quadtree over the centroids and masses of a group of bodies, for
+ * working out gravity on all of them in O(N log N) rather than O(N^2). A cell
+ * of the tree that looks small from where the field is wanted, i.e. whose side
+ * is less than 'theta' times its distance from there (less how far its centre
+ * of mass is off centre), is treated as a single body at its centre of mass. A
+ * theta of 0 gives the exact pairwise sums; larger thetas are faster but
+ * rougher. With a theta of 0.5, the error in the gravity on each body is within
+ * 1% of the mean gravity on a body, and about 0.5% of its own on average (see
+ * tests/test_suite_barnes_hut.c).
+ *
+ * The tree does not own the bodies. Its internal buffers are kept between
+ * builds so that steady-state use does not allocate.
+ */
+typedef struct barnes_hut barnes_hut_t;
+
+/**
+ * Create a new, empty tree.
+ */
+barnes_hut_t *barnes_hut_init(void);
+
+/**
+ * Free the tree but not its bodies.
+ */
+void barnes_hut_free(barnes_hut_t *tree);
+
+/**
+ * Rebuild the tree from where the bodies in 'bodies' are now, skipping those
+ * that are marked for removal or have infinite mass.
+ */
+void barnes_hut_build(barnes_hut_t *tree, list_t *bodies);
+
+/**
+ * Return the number of bodies in the tree.
+ */
+size_t barnes_hut_size(barnes_hut_t *tree);
+
+/**
+ * Return the gravitational field at 'point' due to the bodies in the tree but
+ * 'exclude' (which may be NULL), per unit of G: the sum of m r / |r|^3 over
+ * the bodies, with r from 'point' to the body. Bodies no further than
+ * 'min_distance' away are left out, like in 'create_newtonian_gravity'.
+ */
+vector_t barnes_hut_field(barnes_hut_t *tree,
+                          vector_t point,
+                          body_t *exclude,
+                          double theta,
+                          double min_distance);
+
+/**
+ * Add the gravitational pull of all the other bodies in the tree to each body
+ * in the tree, via 'body_add_force'.
+ */
+void barnes_hut_add_gravity(barnes_hut_t *tree,
+                            double G,
+                            double theta,
+                            double min_distance);
+
+#endif // #ifndef __BARNES_HUT_H__
@@ -8,6 +8,7 @@
 
 /* Structs that this module depends on. */
 typedef struct gfx_aux gfx_aux_t;
+typedef struct polygon polygon_t;
 
 /**
  * A rigid body constrained to the plane.
@@ -19,6 +20,18 @@ typedef struct gfx_aux gfx_aux_t;
  */
 typedef struct body body_t;
 
+/**
+ * A reference to a body that can tell whether the body has since been freed,
+ * e.g. for anything that outlives the tick in which a body is removed.
+ * Bodies are allocated from a pool whose memory is never given back, and each
+ * slot's generation goes up whenever the body in it is freed, so a handle is
+ * valid exactly when its generation still matches its slot's.
+ */
+typedef struct body_handle {
+    body_t *body;
+    size_t generation;
+} body_handle_t;
+
 /**
  * Initializes a body without any info.
  * Acts like body_init_with_info() where info and info_freer are NULL.
@@ -30,7 +43,8 @@ body_t *body_init(list_t *shape, double mass, rgb_color_t color);
  * The body is initially at rest.
  * Asserts that the mass is positive and that the required memory is allocated.
  *
- * @param shape a list of vectors describing the initial shape of the body
+ * @param shape a list of vectors describing the initial shape of the body,
+ *   which is converted to a polygon_t and freed
  * @param mass the mass of the body (if INFINITY, stops the body from moving)
  * @param color the color of the body, used to draw it on the screen
  * @param info additional information to associate with the body,
@@ -46,7 +60,8 @@ body_t *body_init_with_info(list_t *shape,
 
 /**
  * Initialize a body with more advancedTM graphical properties and multiple
- * shapes. The active shape defaults to the zeroth one.
+ * shapes, given as a list of polygon_t. The active shape defaults to the
+ * zeroth one.
  */
 body_t *body_init_with_gfx(double mass,
                            void *info,
@@ -56,13 +71,24 @@ body_t *body_init_with_gfx(double mass,
 
 /**
  * Releases the memory allocated for a body.
+ * The body's slot goes back to the pool for reuse, invalidating its handles.
  *
  * @param body a pointer to a body returned from body_init()
  */
 void body_free(body_t *body);
 
 /**
- * Return the currently active shape of a body.
+ * Return a handle to the body.
+ */
+body_handle_t body_get_handle(body_t *body);
+
+/**
+ * Return the body a handle refers to, or NULL if it has been freed.
+ */
+body_t *body_handle_get(body_handle_t handle);
+
+/**
+ * Return the currently active shape of a body as a list of vectors.
  * *Does* return a copy.
  *
  * @param body a pointer to a body returned from body_init()
@@ -70,33 +96,28 @@ void body_free(body_t *body);
  */
 list_t *body_get_shape(body_t *body);
 
-/**
- * Return a pointer that will always be updated to point to the body's main
- * shape.
- */
-list_t **body_get_shape_main_p(body_t *body);
-
 /**
  * Return the currently active shape of a body.
  * Does *NOT* return a copy.
+ * Shapes are stored relative to the body and only moved into place when
+ * requested, so the returned polygon is only up to date until the body next
+ * moves; call this again rather than holding on to it.
  *
  * @param body a pointer to a body returned from body_init()
  * @return the polygon describing the body's current position
  */
-list_t *body_get_shape_nocp(body_t *body);
+polygon_t *body_get_shape_nocp(body_t *body);
 
 /**
- * Return a pointer to the body's main shape.
- * The pointer will always be updated to point to the body' main shape in the
- * future, so use this if you want to persistently access the body's main shape
- * in the future.
+ * Return the body's main shape, exactly like body_get_shape_nocp.
  */
-list_t *body_get_shape_main(body_t *body);
+polygon_t *body_get_shape_main(body_t *body);
 
 /**
- * Return the body's idx'th shape (NOT a copy).
+ * Return the body's idx'th shape (NOT a copy), with the same caveats as
+ * body_get_shape_nocp.
  */
-list_t *body_get_shape_alt(body_t *body, size_t idx);
+polygon_t *body_get_shape_alt(body_t *body, size_t idx);
 
 /**
  * Return the number of shapes tracked by the body.
@@ -119,8 +140,8 @@ size_t body_get_num_shapes(body_t *body);
 vector_t body_get_centroid(body_t *body);
 
 /**
- * Return a pointer to the body's centroid, as would be returned by
- * body_get_centroid.
+ * Return a pointer to where the body's centroid is drawn, as last set by
+ * body_interpolate.
  */
 vector_t *body_get_anchor(body_t *body);
 
@@ -179,6 +200,9 @@ void body_set_info(body_t *body, void *new_info, free_func_t freer);
 /**
  * Translates a body to a new position.
  * The position is specified by the position of the body's center of mass.
+ * This is a teleport: the body is drawn at its new position straight away
+ * rather than moving there (see body_interpolate); use body_translate for
+ * motion.
  *
  * @param body a pointer to a body returned from body_init()
  * @param x the body's new centroid
@@ -197,6 +221,8 @@ void body_set_velocity(body_t *body, vector_t v);
  * Changes a body's orientation in the plane.
  * The body is rotated about its center of mass.
  * Note that the angle is *absolute*, not relative to the current orientation.
+ * Like body_set_centroid, the body is drawn at its new angle straight away;
+ * use body_rotate for motion.
  *
  * @param body a pointer to a body returned from body_init()
  * @param angle the body's new angle in radians. Positive is counterclockwise.
@@ -225,6 +251,42 @@ void body_add_force(body_t *body, vector_t force);
  */
 void body_add_impulse(body_t *body, vector_t impulse);
 
+/**
+ * Transform the body's shapes to where it is now, which would otherwise happen
+ * lazily whenever each is next requested. Only touches this body, so this can
+ * be done for different bodies on different threads at once.
+ */
+void body_update_shapes(body_t *body);
+
+/**
+ * A record of forces and impulses to be added to bodies later, so that several
+ * threads can work out forces at once without writing to the same bodies.
+ */
+typedef struct body_force_log body_force_log_t;
+
+/**
+ * Allocate an empty force log.
+ */
+body_force_log_t *body_force_log_init(void);
+
+/**
+ * Free a force log without applying it.
+ */
+void body_force_log_free(body_force_log_t *log);
+
+/**
+ * Make body_add_force and body_add_impulse on the calling thread append to
+ * 'log' instead of changing the bodies, until this is called again with NULL.
+ */
+void body_set_force_log(body_force_log_t *log);
+
+/**
+ * Add everything in the log to its bodies, in the order it was logged, and
+ * empty the log for reuse. Bodies end up exactly as if the forces and impulses
+ * had been added directly in that order.
+ */
+void body_force_log_apply(body_force_log_t *log);
+
 /**
  * Updates the body after a given time interval has elapsed.
  * Sets acceleration and velocity according to the forces and impulses
@@ -232,12 +294,24 @@ void body_add_impulse(body_t *body, vector_t impulse);
  * The body should be translated at the *average* of the velocities before
  * and after the tick.
  * Resets the forces and impulses accumulated on the body.
+ * Remembers where the body was before the tick, for body_interpolate.
  *
  * @param body the body to tick
  * @param dt the number of seconds elapsed since the last tick
  */
 void body_tick(body_t *body, double dt);
 
+/**
+ * Set where the body is drawn (see body_get_anchor and body_get_angle_p) to
+ * 'alpha' of the way from where it was before its last tick to where it is
+ * now, so that rendering between fixed-size ticks is smooth. A body that has
+ * not ticked yet is drawn where it is.
+ *
+ * @param body the body to interpolate
+ * @param alpha between 0 (the previous state) and 1 (the current state)
+ */
+void body_interpolate(body_t *body, double alpha);
+
 /**
  * Marks a body for removal--future calls to body_is_removed() will return true.
  * Does not free the body.
@@ -273,6 +347,7 @@ void body_set_color(body_t *body, rgb_color_t value);
 
 /**
  * Translate a body relative to its current location.
+ * Unlike body_set_centroid, it is drawn moving there (see body_interpolate).
  *
  * @param body
  * @param translation The translation vector which will be added to the body's
@@ -282,6 +357,7 @@ void body_translate(body_t *body, vector_t translation);
 
 /**
  * Rotate a body relative to its current orientation.
+ * Unlike body_set_rotation, it is drawn turning there.
  *
  * @param body
  * @param angle Relative angle by which to rotate. Positive is anticlockwise.
@@ -294,8 +370,8 @@ void body_rotate(body_t *body, double angle);
 double body_get_rotation(body_t *body);
 
 /**
- * Return pointer to the body's angle, as would be returned by
- * body_get_rotation.
+ * Return pointer to the angle the body is drawn at, as last set by
+ * body_interpolate.
  */
 double *body_get_angle_p(body_t *body);
 
@@ -1,7 +1,7 @@
 #ifndef __COLLISION_H__
 #define __COLLISION_H__
 
-#include "list.h"
+#include "polygon.h"
 #include "vector.h"
 #include <stdbool.h>
 
@@ -27,7 +27,7 @@ typedef struct {
 
 /**
  * Computes the status of the collision between two convex polygons.
- * The shapes are given as lists of vertices in counterclockwise order.
+ * The shapes are given as polygons with vertices in counterclockwise order.
  * There is an edge between each pair of consecutive vertices,
  * and one between the first vertex and the last vertex.
  *
@@ -36,7 +36,7 @@ typedef struct {
  * @return whether the shapes are colliding, and if so, the collision axis.
  * The axis should be a unit vector pointing from shape1 towards shape2.
  */
-collision_info_t find_collision(list_t *shape1, list_t *shape2);
+collision_info_t find_collision(polygon_t *shape1, polygon_t *shape2);
 
 // returns a normalized vector perpendicular to the given vector
 vector_t find_norm_perpendicular_vec(vector_t original_vec);
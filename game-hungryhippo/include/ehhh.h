@@ -9,6 +9,7 @@ typedef struct vector vector_t;
 typedef struct list list_t;
 typedef struct game game_t;
 typedef struct text_ln text_ln_t;
+typedef struct replay replay_t;
 
 /*** INTERFACE ***/
 
@@ -23,8 +24,16 @@ typedef struct ehhh ehhh_t;
 
 /**
  * Initialize the game with players_count many players and graphics with 'dims'.
+ * If 'headless', the game is simulated as fast as possible without a window
+ * (see game_init).
+ * If 'replay' is not NULL, the game is recorded to it or played back from it
+ * and seeded with its seed (see game_set_replay), and the game frees it.
+ * Otherwise the game is seeded with the time.
  */
-ehhh_t *ehhh_init(size_t player_count, size_t balls_per_round);
+ehhh_t *ehhh_init(size_t player_count,
+                  size_t balls_per_round,
+                  bool headless,
+                  replay_t *replay);
 
 /**
  * Tick the game forward dt seconds.
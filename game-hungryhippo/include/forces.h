@@ -8,9 +8,11 @@
 typedef struct body body_t;
 typedef struct list list_t;
 typedef struct physics physics_t;
+typedef struct polygon polygon_t;
 typedef struct vector vector_t;
 typedef void (*free_func_t)(void *);
 typedef void (*force_creator_t)(void *aux);
+typedef polygon_t *(*shape_getter_t)(body_t *body);
 
 /**
  * A function called when a collision occurs.
@@ -28,24 +30,26 @@ typedef void (*collision_handler_t)(body_t *body1,
 
 /**
  * Struct to keep track of parameters to be given to the force creator
- * functions.
+ * functions. The constants are stored inline, in the order they are added, so
+ * reading one is a plain array access. The force creators in this file use
+ * structs of their own with a field per parameter instead.
  */
 typedef enum aux_type { GENERAL_AUX, COLLISION_AUX } aux_type_e;
 
 typedef struct aux {
     aux_type_e type;
     list_t *bodies;
-    list_t *constants;
+    size_t n_consts;
+    size_t consts_capacity;
+    double constants[];
 } aux_t;
 
 typedef struct aux_collision {
     aux_type_e type;
     list_t *bodies;
 
-    list_t **shape1_p;
-    list_t **shape2_p;
-    bool made_shape1_p;
-    bool made_shape2_p;
+    shape_getter_t getter1;
+    shape_getter_t getter2;
 
     collision_handler_t handler;
     void *handler_aux;
@@ -53,7 +57,7 @@ typedef struct aux_collision {
     bool already_collided;
 } aux_collision_t;
 
-// Aux helper functions.
+// Aux helper functions. At most 'n_consts' constants can be added.
 aux_t *aux_init(size_t n_consts, size_t n_bodies);
 aux_collision_t *aux_collision_init(size_t n_bodies,
                                     collision_handler_t handler,
@@ -82,6 +86,24 @@ void create_newtonian_gravity(physics_t *physics,
                               body_t *body1,
                               body_t *body2);
 
+/**
+ * Adds a force creator to a physics that applies gravity between every pair of
+ * bodies in a group, like calling 'create_newtonian_gravity' on each pair, but
+ * approximated with a Barnes-Hut quadtree (see barnes_hut.h) so that each tick
+ * takes O(N log N) rather than O(N^2) time. The group is read afresh each tick,
+ * so bodies can be added to it and removed from it later. Bodies with infinite
+ * mass are left out.
+ *
+ * @param physics the physics containing the bodies
+ * @param G the gravitational proportionality constant
+ * @param theta how rough the approximation may be, e.g. 0.5; 0 is exact
+ * @param bodies the group of bodies, which the physics must be ticking
+ */
+void create_barnes_hut_gravity(physics_t *physics,
+                               double G,
+                               double theta,
+                               list_t *bodies);
+
 /**
  * Adds a force creator to a physics that acts like a spring between two bodies.
  * The force creator will be called each tick
@@ -108,6 +130,46 @@ void create_spring(physics_t *physics, double k, body_t *body1, body_t *body2);
  */
 void create_drag(physics_t *physics, double gamma, body_t *body);
 
+/**
+ * Adds a single force creator to a physics that applies a drag force, like
+ * 'create_drag', to every body in a group. The group is read afresh each tick,
+ * so bodies can be added to it and removed from it later.
+ *
+ * @param physics the physics containing the bodies
+ * @param gamma the proportionality constant between force and velocity
+ * @param bodies the group of bodies, which the physics must be ticking
+ */
+void create_group_drag(physics_t *physics, double gamma, list_t *bodies);
+
+/**
+ * Adds a single force creator to a physics that applies a uniform field, e.g.
+ * gravity near the ground, to every body in a group: a force of its mass times
+ * 'acceleration'. Bodies with infinite mass are left alone. The group is read
+ * afresh each tick, like in 'create_group_drag'.
+ *
+ * @param physics the physics containing the bodies
+ * @param acceleration the acceleration the field gives every body
+ * @param bodies the group of bodies, which the physics must be ticking
+ */
+void create_group_field(physics_t *physics,
+                        vector_t acceleration,
+                        list_t *bodies);
+
+/**
+ * Adds a single force creator to a physics that acts like a spring, like
+ * 'create_spring', along each of a list of edges between bodies. Edges with a
+ * body that has been removed are skipped from then on; the rest carry on.
+ *
+ * @param physics the physics containing the bodies
+ * @param k the Hooke's constant for every spring
+ * @param edges the bodies at the ends of each edge, two after two; copied
+ * @param n_edges the number of edges, i.e. half the length of 'edges'
+ */
+void create_springs(physics_t *physics,
+                    double k,
+                    body_t **edges,
+                    size_t n_edges);
+
 /**
  * Adds a force creator to a physics that calls a given collision handler
  * function each time two bodies collide.
@@ -132,27 +194,18 @@ void create_collision(physics_t *physics,
 
 /**
  * Just like create_collision but the shapes that are used to check for
- * collision are pointed to by shape{1,2}_p.
+ * collision are returned by getter{1,2} each tick (NULL means the body's main
+ * shape).
  */
 void create_collision_shapes(physics_t *physics,
                              body_t *body1,
                              body_t *body2,
-                             list_t **shape1_p,
-                             list_t **shape2_p,
+                             shape_getter_t getter1,
+                             shape_getter_t getter2,
                              collision_handler_t handler,
                              void *aux,
                              free_func_t freer);
 
-void create_collision_general(physics_t *physics,
-                              body_t *body1,
-                              body_t *body2,
-                              list_t **shape1_p,
-                              list_t **shape2_p,
-                              collision_handler_t handler,
-                              void *aux,
-                              free_func_t freer,
-                              force_creator_t force_creator);
-
 /**
  * Adds a force creator to a physics that destroys two bodies when they collide.
  * The bodies should be destroyed by calling body_remove().
@@ -216,8 +269,28 @@ void create_physics_collision_shapes(physics_t *physics,
                                      double elasticity,
                                      body_t *body1,
                                      body_t *body2,
-                                     list_t **shape1_p,
-                                     list_t **shape2_p);
+                                     shape_getter_t getter1,
+                                     shape_getter_t getter2);
+
+/**
+ * Like create_physics_collision, but between every body of group1 and every
+ * body of group2 (or every pair within group1 if they are the same list), via
+ * physics_add_collision_rule. Prefer this over creating a collision for each
+ * pair of bodies, since the rule culls distant pairs before checking them.
+ *
+ * @param physics the physics containing the bodies
+ * @param elasticity the "coefficient of restitution" of the collision
+ * @param group1 the first group of bodies
+ * @param group2 the second group of bodies
+ * @param getter1 shape getter for group1, or NULL for the body's main shape
+ * @param getter2 shape getter for group2, or NULL for the body's main shape
+ */
+void create_physics_collision_rule(physics_t *physics,
+                                   double elasticity,
+                                   list_t *group1,
+                                   list_t *group2,
+                                   shape_getter_t getter1,
+                                   shape_getter_t getter2);
 
 /**
  * Adds a force creator to a physics that applies impulses
@@ -13,6 +13,9 @@ typedef struct vector vector_t;
 typedef struct list list_t;
 typedef void (*free_func_t)(void *);
 typedef struct key_listener key_listener_t;
+typedef struct arena arena_t;
+typedef struct replay replay_t;
+typedef struct wheel_timer wheel_timer_t;
 
 /**
  * The state of a single entire game. It contains:
@@ -50,12 +53,16 @@ typedef bool (*tick_func_t)(game_t *);
  * deferred garbage control is not broken.
  * Game is a singleton, so initializing multiple games results in a fatal error.
  * SDL is initialized here.
+ * If 'headless', there is no window: nothing is loaded for or drawn by the
+ * graphics layer, and each tick takes exactly one physics step (see
+ * 'game_tick'), so the game runs as fast as it can be simulated.
  */
 game_t *game_init(vector_t dims,
                   size_t groups_count,
                   tick_func_t tick_func,
                   void *aux,
-                  free_func_t aux_freer);
+                  free_func_t aux_freer,
+                  bool headless);
 
 /**
  * Free a game, its physics and graphics layers, and any bodies that have not
@@ -65,6 +72,14 @@ void game_free(game_t *game);
 
 /**
  * Tick the game forward dt seconds.
+ * Physics and tick_func are stepped at the fixed rate set by
+ * 'game_set_tick_rate', as many times as fit into the time accumulated so far
+ * (possibly none), and the leftover time carries over to the next tick. The
+ * bodies are then rendered interpolated between their last two physics states.
+ * If the game is headless, dt is ignored and exactly one step is taken.
+ * If a replay is being played back (see 'game_set_replay'), dt is also ignored,
+ * and the tick takes as long and handles the same key events as when recorded.
+ * The game is over once the replay is.
  * No objects should be marked for removal at the beginning of the tick.
  * Throughout the tick, if something wants to remove an object, it should mark
  * it for removal. Garbage collection is done at the *very* end of the tick, and
@@ -73,8 +88,9 @@ void game_free(game_t *game);
  * the game in your main loop, make sure to call this function at the *end* of
  * the iteration. If you really really want to do more things than are supported
  * by physics and graphics layers, then put them in your tick_func, dumb punk!
- * The sdl event queue is emptied and handled each tick via the key handler and
- * callbacks; you shouldn't poll events yourself. The custom tick_func is called
+ * The sdl event queue is emptied and handled each tick via the key handler;
+ * you shouldn't poll events yourself. Timers go off at the start of each
+ * physics step. The custom tick_func is called
  * just before game's garbage removal, so it should do any auxiliary garbage
  * removal at its very end.
  * @return true if the game is over, false otherwise.
@@ -114,12 +130,39 @@ key_listener_t *game_get_key_listener(game_t *game);
 void *game_get_aux(game_t *game);
 
 /**
- * Add a callback timer and return its id.
+ * Return the game's frame arena, for scratch memory that is only needed until
+ * the end of the current tick (when the arena is reset).
+ */
+arena_t *game_get_frame_arena(game_t *game);
+
+/**
+ * Step physics 'rate' times per second of game time (see 'game_tick'), but no
+ * more than 'max_substeps' times per tick: if ticks take so long that physics
+ * falls further behind than that, the extra time is dropped and the game slows
+ * down instead. Defaults to 120 Hz and 8 steps.
+ */
+void game_set_tick_rate(game_t *game, double rate, size_t max_substeps);
+
+/**
+ * Record the game to 'replay' or play it back from 'replay', and free the
+ * replay along with the game. Pass NULL to stop recording.
+ * To reproduce a game, the client must seed the RNG with the replay's seed and
+ * set everything up exactly as when it was recorded.
+ * Only events the game handles are recorded; the client must not poll any
+ * itself.
+ */
+void game_set_replay(game_t *game, replay_t *replay);
+
+/**
+ * Add a callback timer and return it, e.g. to cancel it with
+ * 'game_cancel_timer'.
  *
- * Our timer mechanism wraps SDL's timer so as to avoid multithreading issues
- * (in perhaps a suboptimal way at the cost of speed, but I don't have time to
- * make it any better). Therefore, feel free to call arbitrary functions inside
- * of the callback, and they will be executed in the main thread.
+ * Timers run on simulated time: they are advanced together with physics by
+ * each physics step (see 'game_tick'), on the main thread, so they are
+ * deterministic and feel free to call arbitrary functions inside of the
+ * callback. A timer goes off at the first step at or after 'interval'
+ * milliseconds, and again after however many milliseconds the callback
+ * returns, unless it returns 0.
  *
  * The game removes all timers on game_free, but it is your responsibility to
  * make sure the callbacks don't get removed after something is marked for
@@ -128,15 +171,21 @@ void *game_get_aux(game_t *game);
  *
  * The aux is not freed by game, so you should.
  */
-SDL_TimerID game_add_timer(game_t *game,
-                           Uint32 interval,
-                           SDL_TimerCallback callback,
-                           void *aux);
+wheel_timer_t *game_add_timer(game_t *game,
+                              Uint32 interval,
+                              SDL_TimerCallback callback,
+                              void *aux);
+
+/**
+ * Cancel a timer before it goes off again. The timer must still be pending,
+ * or be the one whose callback is running.
+ */
+void game_cancel_timer(game_t *game, wheel_timer_t *timer);
 
 /**
  * Cancel all timers registered with the game.
- * As with game_free, timer auxs are not freed. Timers are marked for deferred
- * removal and will not be called if they show up on the event queue hereafter.
+ * As with game_free, timer auxs are not freed. This takes effect immediately,
+ * even for timers due in the same step as a callback that calls this.
  */
 void game_clear_timers(game_t *game);
 
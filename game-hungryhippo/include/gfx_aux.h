@@ -10,6 +10,8 @@ typedef struct gfx_aux gfx_aux_t;
 // Defined by body.h; provided to avoid circular includes.
 typedef struct body body_t;
 
+typedef struct sprite sprite_t;
+
 gfx_aux_t *gfx_aux_init(list_t *sprites);
 
 void gfx_aux_setup(gfx_aux_t *gfx_aux, vector_t *anchor, double *angle);
@@ -23,6 +25,11 @@ void gfx_aux_free(gfx_aux_t *gfx_aux);
  */
 void gfx_aux_set_sprite(gfx_aux_t *gfx_aux, size_t idx);
 
+/**
+ * Return the active sprite, i.e. the one 'gfx_aux_render' renders.
+ */
+sprite_t *gfx_aux_get_sprite(gfx_aux_t *gfx_aux);
+
 void gfx_aux_render(gfx_aux_t *gfx_aux);
 
 #endif // #ifndef __GFX_AUX_H__
@@ -29,8 +29,10 @@ void graphics_free(graphics_t *graphics);
 
 /**
  * Render all graphics via sdl.
+ * Bodies are drawn 'alpha' of the way between their states before and after
+ * the last physics tick (see body_interpolate).
  */
-void graphics_render(graphics_t *graphics);
+void graphics_render(graphics_t *graphics, double alpha);
 
 /**
  * Registers a group of bodies to render from each tick.
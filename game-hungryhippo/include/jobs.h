@@ -0,0 +1,55 @@
+#ifndef __JOBS_H__
+#define __JOBS_H__
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+/*** DEPENDENCY FORWARD DECLARATIONS ***/
+typedef struct thread_pool thread_pool_t;
+
+/*** INTERFACE ***/
+
+/**
+ * A parallel for loop over the threads of a thread pool.
+ * The range is cut into chunks and each thread starts on its own contiguous
+ * run of them, in order; a thread that runs out steals chunks from the end of
+ * another thread's run, so threads that finish early help the slow ones.
+ */
+typedef struct jobs jobs_t;
+
+/**
+ * A function that handles the indices [start, end) of a loop, on the thread
+ * 'thread_idx' of the pool.
+ */
+typedef void (*jobs_func_t)(void *aux,
+                            size_t start,
+                            size_t end,
+                            size_t thread_idx);
+
+/**
+ * Create a job system on the threads of 'pool', which it does not own.
+ */
+jobs_t *jobs_init(thread_pool_t *pool);
+
+/**
+ * Free the job system but not its pool.
+ */
+void jobs_free(jobs_t *jobs);
+
+/**
+ * Call 'func' on chunks of 'chunk_size' indices (the last may be smaller)
+ * covering [0, count), spread over the pool's threads, and return once every
+ * chunk is done.
+ * If 'deterministic', nothing is stolen: thread i handles the i'th of the
+ * pool-size contiguous runs of chunks, in ascending order, every time. Use
+ * this when 'func' accumulates into per-thread state that is later combined in
+ * thread order, so that the result doesn't depend on timing.
+ */
+void jobs_for(jobs_t *jobs,
+              size_t count,
+              size_t chunk_size,
+              bool deterministic,
+              jobs_func_t func,
+              void *aux);
+
+#endif // #ifndef __JOBS_H__
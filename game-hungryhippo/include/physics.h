@@ -1,9 +1,19 @@
 #ifndef __PHYSICS_H__
 #define __PHYSICS_H__
 
+#include <stdlib.h>
+
 /*** DEPENDENCY FORWARD DECLARATIONS ***/
+typedef struct body body_t;
 typedef struct list list_t;
+typedef struct polygon polygon_t;
+typedef struct vector vector_t;
 typedef void (*free_func_t)(void *);
+typedef void (*collision_handler_t)(body_t *body1,
+                                    body_t *body2,
+                                    vector_t axis,
+                                    vector_t collision_point,
+                                    void *aux);
 
 /*** INTERFACE ***/
 
@@ -19,6 +29,13 @@ typedef struct physics physics_t;
  */
 typedef void (*force_creator_t)(void *aux);
 
+/**
+ * A function which returns the shape of a body that should be used for
+ * collision checking, e.g. body_get_shape_main or a hippo's mouth. The shape is
+ * NOT a copy and must not be freed.
+ */
+typedef polygon_t *(*shape_getter_t)(body_t *body);
+
 /**
  * Create a new physics layer.
  */
@@ -49,10 +66,68 @@ void physics_add_force(physics_t *physics,
                        list_t *bodies,
                        free_func_t aux_freer);
 
+/**
+ * Like 'physics_add_force', but for a force creator that may run on another
+ * thread at the same time as other parallel force creators (see
+ * 'physics_set_threads'). It must only read bodies' masses, centroids,
+ * velocities and angles, and only change them via 'body_add_force' and
+ * 'body_add_impulse'; in particular it must not get their shapes, remove them
+ * or touch anything else shared, including its aux if that is shared.
+ */
+void physics_add_parallel_force(physics_t *physics,
+                                force_creator_t forcer,
+                                void *forcer_aux,
+                                list_t *bodies,
+                                free_func_t aux_freer);
+
+/**
+ * Split the parallel force creators (see 'physics_add_parallel_force') and
+ * then the integration of bodies (see 'body_tick'), including transforming
+ * their shapes, between 'thread_count' threads each tick, counting the caller
+ * of 'physics_tick'. Defaults to 1, i.e. everything runs on the caller.
+ * Bodies end up the same, bit for bit, whatever the number of threads:
+ * parallel force creators are always run before the others, the forces found
+ * by each thread are added up in a fixed order, and each body is integrated on
+ * its own. So replays still match.
+ * A body must not be in more than one group if there is more than one thread.
+ */
+void physics_set_threads(physics_t *physics, size_t thread_count);
+
+/**
+ * Add a collision rule between two groups of bodies to the layer. Each tick,
+ * every body in group1 is checked against every body in group2, but a
+ * broad phase over the bounding boxes of the shapes first culls pairs that
+ * cannot be touching, so only nearby pairs are checked with find_collision.
+ * The broad phase is kept up to date from tick to tick (see sweep_prune.h),
+ * so it costs about one step per body plus one per change in which boxes
+ * overlap.
+ * If group1 and group2 are the same list, then each pair within it is checked
+ * once. The handler is called once per contact, i.e. only on the first tick
+ * that a pair is touching, just like create_collision. Bodies added to the
+ * groups after the rule is created are automatically included.
+ *
+ * @param physics the physics layer
+ * @param group1 the first group of bodies, passed as body1 to the handler
+ * @param group2 the second group of bodies, passed as body2 to the handler
+ * @param getter1 shape getter for group1, or NULL for the body's main shape
+ * @param getter2 shape getter for group2, or NULL for the body's main shape
+ * @param handler a function to call whenever two bodies collide
+ * @param aux an auxiliary value to pass to the handler
+ * @param aux_freer if non-NULL, a function to call in order to free aux
+ */
+void physics_add_collision_rule(physics_t *physics,
+                                list_t *group1,
+                                list_t *group2,
+                                shape_getter_t getter1,
+                                shape_getter_t getter2,
+                                collision_handler_t handler,
+                                void *aux,
+                                free_func_t aux_freer);
+
 /**
  * Tick the physics layer forward dt seconds, i.e. tick bodies forward with any
- * associated forces. Also remove bodies marked for removal but do not free
- * them.
+ * associated forces and collision rules. Also remove bodies marked for removal
+ * but do not free them.
  */
 void physics_tick(physics_t *physics, double dt);
 
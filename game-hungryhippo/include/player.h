@@ -139,14 +139,14 @@ short player_get_points(player_t *player);
 void player_remove(player_t *player);
 
 /**
- * Returns the address of the hippo's (player's) current body shape.
+ * Returns the hippo's (player's) current body shape (see body_get_shape_nocp).
  */
-list_t **player_get_hippo_body_shape(player_t *player);
+polygon_t *player_get_hippo_body_shape(player_t *player);
 
 /**
- * Returns the address of the hippo's (player's) current mouth shape.
+ * Returns the hippo's (player's) current mouth shape (see body_get_shape_nocp).
  */
-list_t **player_get_hippo_mouth_shape(player_t *player);
+polygon_t *player_get_hippo_mouth_shape(player_t *player);
 
 /**
  * Returns whether the player is in the eating state.
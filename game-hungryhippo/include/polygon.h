@@ -7,55 +7,166 @@
 
 #include "list.h"
 #include "vector.h"
+#include <stdbool.h>
+
+/**
+ * A polygon, stored as packed arrays of vertex coordinates (i.e. structure of
+ * arrays) in a single allocation, rather than as a list of separately
+ * allocated vectors. Vertices are listed in a counterclockwise direction.
+ * There is an edge between each pair of consecutive vertices, plus one between
+ * the first and last.
+ *
+ * A polygon may also have a radius, in which case it stands for every point
+ * within that distance of it. This is how circles (one vertex, the center) and
+ * capsules (two vertices, the ends of the spine) are represented, so they can
+ * be used anywhere a polygon can and find_collision can use exact tests.
+ */
+typedef struct polygon polygon_t;
+
+/**
+ * An axis-aligned bounding box, given by its bottom left ('min') and top right
+ * ('max') corners in scene coordinates.
+ */
+typedef struct aabb {
+    vector_t min;
+    vector_t max;
+} aabb_t;
+
+/**
+ * Allocate a polygon with 'size' vertices, all initially at the origin.
+ */
+polygon_t *polygon_init(size_t size);
+
+/**
+ * Allocate a circle, i.e. a one vertex polygon with the given radius.
+ */
+polygon_t *polygon_init_circle(vector_t center, double radius);
+
+/**
+ * Allocate a capsule, i.e. a two vertex polygon with the given radius, which
+ * is a rectangle from 'end1' to 'end2' with semicircular caps.
+ */
+polygon_t *polygon_init_capsule(vector_t end1, vector_t end2, double radius);
+
+/**
+ * Create a polygon from a list of vectors (i.e. the legacy representation of
+ * polygons). Does not free or otherwise modify the list.
+ */
+polygon_t *polygon_init_from_list(list_t *vertices);
+
+/**
+ * Return a new list of newly allocated vectors with the vertices of the polygon
+ * (i.e. the legacy representation of polygons), to be freed by the caller.
+ */
+list_t *polygon_to_list(polygon_t *polygon);
+
+/**
+ * Return a deep copy of the polygon.
+ */
+polygon_t *polygon_copy(polygon_t *polygon);
+
+/**
+ * Free the polygon.
+ */
+void polygon_free(polygon_t *polygon);
+
+/**
+ * Return the number of vertices of the polygon.
+ */
+size_t polygon_size(polygon_t *polygon);
+
+/**
+ * Return the polygon's radius, which is 0 unless it is rounded (e.g. a circle
+ * or capsule).
+ */
+double polygon_radius(polygon_t *polygon);
+
+/**
+ * Return the polygon's idx'th vertex.
+ */
+vector_t polygon_get(polygon_t *polygon, size_t idx);
+
+/**
+ * Set the polygon's idx'th vertex.
+ */
+void polygon_set(polygon_t *polygon, size_t idx, vector_t vertex);
+
+/**
+ * Return the x-coordinates of the polygon's vertices as a contiguous array of
+ * length polygon_size. The array is owned by the polygon.
+ */
+const double *polygon_xs(polygon_t *polygon);
+
+/**
+ * Return the y-coordinates of the polygon's vertices as a contiguous array of
+ * length polygon_size. The array is owned by the polygon.
+ */
+const double *polygon_ys(polygon_t *polygon);
+
+/**
+ * Reverse the order of the polygon's vertices, e.g. to restore anticlockwise
+ * orientation after a reflection.
+ */
+void polygon_reverse(polygon_t *polygon);
 
 /**
  * Computes the area of a polygon.
  * See https://en.wikipedia.org/wiki/Shoelace_formula#Statement.
+ * The area of a rounded polygon includes its rounded border.
  *
- * @param polygon the list of vertices that make up the polygon,
- * listed in a counterclockwise direction. There is an edge between
- * each pair of consecutive vertices, plus one between the first and last.
+ * @param polygon the polygon
  * @return the area of the polygon
  */
-double polygon_area(list_t *polygon);
+double polygon_area(polygon_t *polygon);
 
 /**
  * Computes the center of mass of a polygon.
  * See https://en.wikipedia.org/wiki/Centroid#Of_a_polygon.
+ * The result is cached in the polygon until its vertices next change, and is
+ * carried along (rather than recomputed) by translations and transforms.
+ * Circles and capsules have their centroid halfway between their vertices.
  *
- * @param polygon the list of vertices that make up the polygon,
- * listed in a counterclockwise direction. There is an edge between
- * each pair of consecutive vertices, plus one between the first and last.
+ * @param polygon the polygon
  * @return the centroid of the polygon
  */
-vector_t polygon_centroid(list_t *polygon);
+vector_t polygon_centroid(polygon_t *polygon);
 
 /**
  * Translates all vertices in a polygon by a given vector.
  * Note: mutates the original polygon.
  *
- * @param polygon the list of vertices that make up the polygon
+ * @param polygon the polygon
  * @param translation the vector to add to each vertex's position
  */
-void polygon_translate(list_t *polygon, vector_t translation);
+void polygon_translate(polygon_t *polygon, vector_t translation);
 
-void polygon_set_centroid(list_t *polygon, vector_t centroid);
+void polygon_set_centroid(polygon_t *polygon, vector_t centroid);
 
 /**
  * Rotates vertices in a polygon by a given angle about a given point.
  * Note: mutates the original polygon.
  *
- * @param polygon the list of vertices that make up the polygon
+ * @param polygon the polygon
  * @param angle the angle to rotate the polygon, in radians.
  * A positive angle means counterclockwise.
  * @param point the point to rotate around
  */
-void polygon_rotate(list_t *polygon, double angle, vector_t point);
+void polygon_rotate(polygon_t *polygon, double angle, vector_t point);
+
+/**
+ * Set the vertices of 'dst' to those of 'src' rotated by 'angle' about the
+ * origin and then translated by 'translation', e.g. to map a shape from local
+ * to world coordinates. Both polygons must have the same number of vertices.
+ */
+void polygon_transform(polygon_t *dst,
+                       polygon_t *src,
+                       double angle,
+                       vector_t translation);
 
 /**
  * Initalize a shape from a string path.
  */
-list_t *polygon_init_from_path(const char *path);
+polygon_t *polygon_init_from_path(const char *path);
 
 /**
  * Create a list of polygons from a list of paths.
@@ -63,9 +174,9 @@ list_t *polygon_init_from_path(const char *path);
 list_t *polygon_init_many_from_paths(const list_t *paths);
 
 /**
- * Scale the polygon by factor relative to the origin (0, 0).
+ * Scale the polygon (and its radius) by factor relative to the origin (0, 0).
  */
-void polygon_scale(list_t *polygon, double factor);
+void polygon_scale(polygon_t *polygon, double factor);
 
 /**
  * (Almost) convert a polygon from screen to scene coordinates. We say "almost"
@@ -73,34 +184,61 @@ void polygon_scale(list_t *polygon, double factor);
  * does not attempt to map the centroid from screen to scene coordinates. We
  * recommend using 'polygon_set_centroid' to place the polygon after conversion.
  */
-void polygon_scr_to_sce(list_t *polygon);
+void polygon_scr_to_sce(polygon_t *polygon);
 
 /**
  * Compute vector pointing from the centroid of the polygon to the top left
  * corner of its rectangle.
  */
-vector_t polygon_centroid_to_topleft(list_t *polygon);
+vector_t polygon_centroid_to_topleft(polygon_t *polygon);
 
 /**
  * Compute vector pointing from the rectangle's center to the centroid of the
  * polygon.
  */
-vector_t polygon_centroid_to_center(list_t *polygon);
+vector_t polygon_centroid_to_center(polygon_t *polygon);
 
 /**
  * Compute the center (not necessarily centroid aka center of mass) of the
  * polygon's rectangle.
  */
-vector_t polygon_center(list_t *polygon);
+vector_t polygon_center(polygon_t *polygon);
 
 /**
  * Compute the top left corner of the polygon's rectangle.
  */
-vector_t polygon_topleft(list_t *polygon);
+vector_t polygon_topleft(polygon_t *polygon);
 
 /**
  * Compute the bottom right corner of the polygon's rectangle.
  */
-vector_t polygon_botright(list_t *polygon);
+vector_t polygon_botright(polygon_t *polygon);
+
+/**
+ * Compute the polygon's axis-aligned bounding box in a single pass over its
+ * vertices. Like the centroid, it is cached until the vertices next change;
+ * polygon_transform computes it as it goes, so a body's shapes have theirs
+ * ready whenever they have been brought up to date.
+ */
+aabb_t polygon_aabb(polygon_t *polygon);
+
+/**
+ * Return the distance from the polygon's centroid to its farthest point, i.e.
+ * the radius of a bounding circle about the centroid. Cached like the centroid,
+ * and unchanged by translations, rotations and transforms.
+ */
+double polygon_bounding_radius(polygon_t *polygon);
+
+/**
+ * Return whether the bounding circles and boxes of two polygons both overlap,
+ * i.e. false only if the polygons certainly don't collide. Much cheaper than
+ * find_collision, so that far apart pairs can be ruled out first.
+ */
+bool polygon_bounds_overlap(polygon_t *polygon1, polygon_t *polygon2);
+
+/**
+ * Return whether two axis-aligned bounding boxes overlap (touching counts).
+ */
+bool aabb_overlap(aabb_t box1, aabb_t box2);
 
 #endif // #ifndef __POLYGON_H__
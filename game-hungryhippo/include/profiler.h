@@ -0,0 +1,140 @@
+#ifndef __PROFILER_H__
+#define __PROFILER_H__
+
+#include "text.h"
+#include "vector.h"
+#include <stdint.h>
+#include <stdio.h>
+
+/*** INTERFACE ***/
+
+/**
+ * A frame profiler: how long each subsystem takes per frame, timed with scoped
+ * zones on a monotonic clock.
+ *
+ * The time spent in each zone is added up over a frame and, at the end of the
+ * frame, kept in a rolling histogram of the last PROFILER_WINDOW frames, from
+ * which percentiles are read, e.g. by an overlay table. While tracing, every
+ * zone is also kept as an event to dump as Chrome trace JSON, which can be
+ * opened in chrome://tracing or https://ui.perfetto.dev.
+ *
+ * The zones in the library are only timed when it is compiled with PROFILE
+ * defined (make PROFILE=1), and compile to nothing otherwise. There is one
+ * profiler per program, used from the thread that ticks the game.
+ */
+
+/**
+ * Number of frames the percentiles are taken over.
+ */
+#define PROFILER_WINDOW 256
+
+/**
+ * Maximum number of events kept in a trace.
+ */
+#define PROFILER_MAX_TRACE_EVENTS (1 << 20)
+
+/**
+ * The zones that are timed. Zones nest: e.g. all the physics zones are inside
+ * PROFILE_ZONE_PHYSICS, which is inside PROFILE_ZONE_FRAME.
+ */
+typedef enum profile_zone {
+    PROFILE_ZONE_FRAME,              // All of game_tick.
+    PROFILE_ZONE_EVENTS,             // Handling or playing back events.
+    PROFILE_ZONE_PHYSICS,            // All of physics_tick.
+    PROFILE_ZONE_PHYSICS_GC,         // Dropping removed bodies and forces.
+    PROFILE_ZONE_PHYSICS_FORCES,     // Applying forces.
+    PROFILE_ZONE_PHYSICS_COLLISIONS, // Collision rules.
+    PROFILE_ZONE_PHYSICS_INTEGRATE,  // Ticking bodies.
+    PROFILE_ZONE_CLIENT_TICK,        // The game's tick_func.
+    PROFILE_ZONE_RENDER,             // graphics_render.
+    PROFILE_ZONE_GC,                 // Freeing removed bodies.
+    PROFILE_ZONE_COUNT
+} profile_zone_t;
+
+#ifdef PROFILE
+/**
+ * Start timing the zone PROFILE_ZONE_<zone> until PROFILE_END(<zone>) in the
+ * same scope.
+ */
+#define PROFILE_BEGIN(zone) uint64_t _profile_start_##zone = profiler_now()
+#define PROFILE_END(zone)                                                      \
+    profiler_record(PROFILE_ZONE_##zone, _profile_start_##zone, profiler_now())
+/**
+ * End the frame (see profiler_end_frame).
+ */
+#define PROFILE_END_FRAME() profiler_end_frame()
+#else
+#define PROFILE_BEGIN(zone)
+#define PROFILE_END(zone)
+#define PROFILE_END_FRAME()
+#endif
+
+/**
+ * Return the time of the monotonic clock in nanoseconds.
+ */
+uint64_t profiler_now(void);
+
+/**
+ * Record that the zone ran from 'start' to 'end', as returned by profiler_now.
+ * This adds to the zone's time in the current frame and, while tracing, adds
+ * a trace event.
+ */
+void profiler_record(profile_zone_t zone, uint64_t start, uint64_t end);
+
+/**
+ * Add the current frame's time in each zone to the histograms, dropping the
+ * oldest frame once there are PROFILER_WINDOW, and start a new frame.
+ * A zone that did not run in the frame took no time.
+ */
+void profiler_end_frame(void);
+
+/**
+ * Return the number of frames in the histograms, at most PROFILER_WINDOW.
+ */
+size_t profiler_frame_count(void);
+
+/**
+ * Return the time in seconds that the zone took in at least 'fraction' (from 0
+ * to 1) of the frames in the histograms, e.g. 0.99 for the 99th percentile.
+ * The time is the middle of a histogram bucket, so it is off by up to about 3%.
+ * Return 0 if there are no frames.
+ */
+double profiler_percentile(profile_zone_t zone, double fraction);
+
+/**
+ * Return the zone's name, e.g. "physics/forces".
+ */
+const char *profiler_zone_name(profile_zone_t zone);
+
+/**
+ * Print the median and 99th percentile of each zone to 'out'.
+ */
+void profiler_print_report(FILE *out);
+
+/**
+ * Start keeping an event for every zone recorded, until the trace is written.
+ * Events past the first PROFILER_MAX_TRACE_EVENTS are dropped.
+ */
+void profiler_start_trace(void);
+
+/**
+ * Write the events kept since profiler_start_trace to 'path' as Chrome trace
+ * JSON and stop tracing.
+ * Exits with an error if the file cannot be written.
+ */
+void profiler_write_trace(const char *path);
+
+/**
+ * Make a table with the median and 99th percentile of each zone, in
+ * milliseconds, to draw over the game. Free it with text_tab_free before
+ * profiler_free.
+ */
+text_tab_t *profiler_create_tab(vector_t topleft);
+
+/**
+ * Free everything the profiler allocated and forget all frames and events, as
+ * if the program had just started.
+ */
+void profiler_free(void);
+
+#endif // #ifndef __PROFILER_H__
@@ -0,0 +1,109 @@
+#ifndef __REPLAY_H__
+#define __REPLAY_H__
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/*** INTERFACE ***/
+
+/**
+ * A log of everything nondeterministic that goes into a game, so that the game
+ * can be reproduced exactly, tick for tick: the RNG seed, the client's
+ * parameters (e.g. its command line options), how much time each tick took and
+ * every key and quit event in the order the game handled them. Timers run on
+ * simulated time, so they need no recording.
+ *
+ * A replay is either being recorded or being played back, never both. The log
+ * is a compact binary file with all numbers stored little-endian, so it can be
+ * played back on another machine, but only by the same build of the game.
+ *
+ * Within a tick, a game writes the events it handles with the replay_record_*
+ * functions and then ends the tick with 'replay_record_tick'. When playing
+ * back, it reads the events with 'replay_read' in the same order until it
+ * reaches the tick's REPLAY_EVENT_TICK.
+ */
+typedef struct replay replay_t;
+
+/**
+ * Kinds of events in a replay log.
+ */
+typedef enum {
+    REPLAY_EVENT_KEY,   // A key was pressed or released (not a repeat).
+    REPLAY_EVENT_QUIT,  // The window was closed.
+    REPLAY_EVENT_TICK,  // The tick ended, having taken 'dt' seconds.
+    REPLAY_EVENT_END    // There is nothing more in the log.
+} replay_event_type_t;
+
+/**
+ * An event read back from a replay. Only the field for its type is meaningful.
+ */
+typedef struct replay_event {
+    replay_event_type_t type;
+    SDL_KeyboardEvent key; // Type, state and keysym only; no timestamp.
+    double dt;
+} replay_event_t;
+
+/**
+ * Start recording a new replay to the file at 'path', overwriting it.
+ * The 'seed' that the client seeded its RNG with and the 'param_count'
+ * parameters 'params' are written to the header, to be read back with
+ * 'replay_get_seed' and 'replay_get_params'.
+ * Failing to open the file is a fatal error.
+ */
+replay_t *replay_init_record(const char *path,
+                             uint32_t seed,
+                             const uint32_t *params,
+                             size_t param_count);
+
+/**
+ * Open the replay at 'path' for playback.
+ * Failing to open the file or to read its header is a fatal error.
+ */
+replay_t *replay_init_playback(const char *path);
+
+/**
+ * Close the replay's file, which flushes what has been recorded, and free it.
+ */
+void replay_free(replay_t *replay);
+
+/**
+ * Return whether the replay is being played back rather than recorded.
+ */
+bool replay_is_playback(replay_t *replay);
+
+/**
+ * Return the RNG seed from the replay's header.
+ */
+uint32_t replay_get_seed(replay_t *replay);
+
+/**
+ * Return the parameters from the replay's header and write how many there are
+ * into 'param_count'. The array belongs to the replay.
+ */
+const uint32_t *replay_get_params(replay_t *replay, size_t *param_count);
+
+/**
+ * Record a key event.
+ */
+void replay_record_key(replay_t *replay, SDL_KeyboardEvent key);
+
+/**
+ * Record that the window was closed.
+ */
+void replay_record_quit(replay_t *replay);
+
+/**
+ * Record the end of a tick that took 'dt' seconds.
+ */
+void replay_record_tick(replay_t *replay, double dt);
+
+/**
+ * Read the next event of a replay being played back.
+ * Once the log is exhausted, every event read is REPLAY_EVENT_END. A truncated
+ * or corrupt log is treated as ending at the last complete event.
+ */
+replay_event_t replay_read(replay_t *replay);
+
+#endif // #ifndef __REPLAY_H__
@@ -21,9 +21,11 @@
 #ifndef __SDL_WRAPPER_H__
 #define __SDL_WRAPPER_H__
 
+#include "arena.h"
 #include "color.h"
 #include "gfx_aux.h"
 #include "list.h"
+#include "polygon.h"
 #include "sprite.h"
 #include "vector.h"
 #include <stdbool.h>
@@ -76,6 +78,22 @@ typedef void (*key_handler_t)(char key,
  */
 void sdl_init(vector_t min, vector_t max);
 
+/**
+ * Initializes SDL's timers and event queue only, without a window or renderer,
+ * e.g. to simulate without a display. Use instead of sdl_init.
+ * Nothing can be drawn, but coordinates are converted as if there were a window
+ * of the default size.
+ *
+ * @param min the x and y coordinates of the bottom left of the scene
+ * @param max the x and y coordinates of the top right of the scene
+ */
+void sdl_init_headless(vector_t min, vector_t max);
+
+/**
+ * Returns whether SDL was initialized with sdl_init_headless.
+ */
+bool sdl_is_headless(void);
+
 /**
  * Processes all SDL events and returns whether the window has been closed.
  * This function must be called in order to handle keypresses.
@@ -97,15 +115,36 @@ void sdl_show(void);
 
 void sdl_render_sprite(sprite_t *sprite);
 
+/**
+ * Force the rendering of shape, regardless of whether a body has a gfx_aux, for
+ * testing purposes.
+ */
+extern const bool ALWAYS_RENDER_SHAPE;
+
+/**
+ * Draw a body's gfx_aux and/or its shape. The shape is drawn where the body was
+ * last interpolated to (see body_interpolate), just like its sprite.
+ */
 void sdl_render_body(body_t *body);
 
 /**
- * Draws a polygon from the given list of vertices and a color.
+ * Draws a polygon with the given color, including the rounded border of
+ * circles, capsules and other polygons with a radius.
  *
- * @param points the list of vertices of the polygon
+ * @param polygon the polygon to draw
  * @param color the color used to fill in the polygon
  */
-void sdl_draw_polygon(list_t *points, rgb_color_t color);
+void sdl_draw_polygon(polygon_t *polygon, rgb_color_t color);
+
+/**
+ * Draw a polygon like sdl_draw_polygon, but moved rigidly: rotated by 'angle'
+ * about 'from', which is then moved to 'to'.
+ */
+void sdl_draw_polygon_moved(polygon_t *polygon,
+                            rgb_color_t color,
+                            double angle,
+                            vector_t from,
+                            vector_t to);
 
 void sdl_render_gfx(gfx_aux_t *gfx);
 
@@ -139,8 +178,8 @@ void sdl_render_gfx(gfx_aux_t *gfx);
 void sdl_on_key(key_handler_t handler, void *aux);
 
 /**
- * Gets the amount of time that has passed since the last time
- * this function was called, in seconds.
+ * Gets the amount of wall-clock time that has passed since the last time
+ * this function was called, in seconds, from a monotonic high-resolution clock.
  *
  * @return the number of seconds that have elapsed
  */
@@ -148,6 +187,18 @@ double time_since_last_tick(void);
 
 SDL_Renderer *sdl_get_renderer();
 
+/**
+ * Set the arena to use for scratch memory while drawing, which must stay alive
+ * and only be reset between frames. The caller (i.e. game_t) keeps ownership.
+ */
+void sdl_set_frame_arena(arena_t *arena);
+
+/**
+ * Return the arena set by sdl_set_frame_arena, for memory that is only needed
+ * until the end of the current frame.
+ */
+arena_t *sdl_get_frame_arena(void);
+
 /**
  * For absolute position.
  */
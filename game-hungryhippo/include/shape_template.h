@@ -0,0 +1,36 @@
+#ifndef __SHAPE_TEMPLATE_H__
+#define __SHAPE_TEMPLATE_H__
+
+#include "polygon.h"
+#include <stdbool.h>
+
+/*** INTERFACE ***/
+
+/**
+ * A registry of polygons loaded from CSV files (see 'polygon_init_from_path').
+ * Each file is parsed only the first time a shape is requested from it at a
+ * given scale; the result is kept as a template, scaled and with its centroid
+ * at the origin, and every later request just copies the template.
+ *
+ * Request every shape once at startup so spawning never reads from disk.
+ */
+
+/**
+ * Return a new polygon loaded from the CSV at 'path', scaled by 'scale' about
+ * its centroid, with its centroid at the origin. The caller frees it.
+ */
+polygon_t *shape_template_init(const char *path, double scale);
+
+/**
+ * Like 'shape_template_init', but for a CSV in screen coordinates, which are
+ * converted to scene coordinates (see 'polygon_scr_to_sce') before scaling.
+ */
+polygon_t *shape_template_init_scr(const char *path, double scale);
+
+/**
+ * Free every template. Polygons already returned are unaffected, and the
+ * files are parsed again if requested afterwards.
+ */
+void shape_template_free_all(void);
+
+#endif // #ifndef __SHAPE_TEMPLATE_H__
@@ -24,14 +24,14 @@ body_t *make_rectangle(rgb_color_t color,
                        free_func_t freer);
 
 /**
- * returns a list of points forming a rectangle of given height, width, and
+ * returns a polygon forming a rectangle of given height, width, and
  * initial_position
  * @param initial_position the vector position the rectangle should be centered
  * at
  * @param height the height of the rectangle
  * @param weidth the width of the rectangle
  */
-list_t *
+polygon_t *
 make_rectangle_polygon(vector_t initial_position, double height, double width);
 
 /**
@@ -53,19 +53,20 @@ body_t *make_triangle(rgb_color_t color,
 
 /**
  *
- * make_triangle_polygon returns the list of points that make up the triangle
+ * make_triangle_polygon returns the polygon that makes up the triangle
  * at the given initial position
  * @param initial_position the vector position the triangle should be centered
  * at
  * @param size the base of the triangle and half the height of the triangle
  */
-list_t *make_triangle_polygon(vector_t initial_position, double size);
+polygon_t *make_triangle_polygon(vector_t initial_position, double size);
 
 /**
  * make_circle returns a new body_t circle at given initial position
  * @param radius the radius of the circle
  * @param resolution the number of points to be made that are associated with
- * the circle
+ * the circle, or 0 for an exact circle (see polygon_init_circle), which is
+ * much cheaper to collide
  * @param initial_position the vector position that the centroid should be
  * located
  * @param mass the mass of the circle
@@ -82,16 +83,17 @@ body_t *make_circle(double radius,
                     rgb_color_t color);
 
 /**
- * make circle polygon returns a list of points that make up the new circle
+ * make circle polygon returns a polygon that makes up the new circle
  * at the given initial position
  * @param radius the radius of the circle
  * @param resolution the number of points to be made that are associated with
- * the circle
+ * the circle, or 0 for an exact circle (see polygon_init_circle), which is
+ * much cheaper to collide
  * @param initial_position the vector position that the centroid should be
  * located
  */
-list_t *make_circle_polygon(double radius,
-                            double resolution,
-                            vector_t initial_position);
+polygon_t *make_circle_polygon(double radius,
+                               double resolution,
+                               vector_t initial_position);
 
 #endif // #ifndef __SHAPES_GEOMETRY_H__
@@ -17,6 +17,8 @@ typedef struct sprite sprite_t;
 /**
  * Initialize, but do not setup, a sprite. A sprite needs to be passed to
  * 'sprite_setup' before use.
+ * Sprites of the same image at the same scale share one texture (see
+ * texture.h), so only the first loads it.
  * @param offset Vector pointing from the anchor to center* of the sprite's
  * rectangle, before any rotation (rotation and translation is handled by
  * 'sprite_render'.
@@ -58,6 +60,14 @@ void sprite_setup_with_body(sprite_t *sprite, body_t *body);
 
 void sprite_free(sprite_t *sprite);
 
+/**
+ * If the sprite is drawn from the atlas, fill 'quad' with its corners (top
+ * left, top right, bottom right, bottom left) in screen coordinates, rotated
+ * and textured as 'sprite_render' would draw it, and return true. Otherwise
+ * return false; such sprites can only be drawn with 'sprite_render'.
+ */
+bool sprite_get_quad(sprite_t *sprite, SDL_Vertex quad[4]);
+
 void sprite_render(sprite_t *sprite);
 
 #endif // #ifndef __SPRITE_H__
@@ -0,0 +1,108 @@
+#ifndef __SWEEP_PRUNE_H__
+#define __SWEEP_PRUNE_H__
+
+#include "polygon.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/*** INTERFACE ***/
+
+/**
+ * An incremental sweep-and-prune broad phase, for objects that only move a
+ * little from one tick to the next.
+ *
+ * It keeps its objects between ticks, along with the ends of their bounding
+ * boxes sorted along each axis and the pairs whose boxes overlap. Each tick the
+ * objects are synced with their new boxes, and the sorted ends are brought up
+ * to date by insertion sort. Since the ends barely move, that costs about one
+ * step per object plus one per pair of ends that pass each other, and each
+ * pair of ends that pass is exactly when a pair of boxes may begin or end
+ * overlapping.
+ *
+ * Objects are on side 0 or 1. If the broad phase is for a single group, pairs
+ * are taken among all objects; otherwise only pairs with one object from each
+ * side are. The broad phase does not own the objects.
+ */
+typedef struct sweep_prune sweep_prune_t;
+
+/**
+ * A function called on each pair of objects whose boxes overlap.
+ * @param obj1 The side 0 object, or either of a pair within a single group.
+ * @param obj2 The side 1 object, or the other.
+ * @param flag A flag kept with the pair for as long as its boxes overlap, for
+ * the caller's use. It is false when the pair begins.
+ * @param aux The auxiliary value passed along with the function.
+ */
+typedef void (*sweep_prune_pair_func_t)(void *obj1,
+                                        void *obj2,
+                                        bool *flag,
+                                        void *aux);
+
+/**
+ * A function called when the boxes of a pair of objects begin overlapping, if
+ * 'begin', or end overlapping. As with sweep_prune_pair_func_t, 'obj1' is on
+ * side 0. A pair also ends when either of its objects is no longer synced.
+ */
+typedef void (*sweep_prune_event_func_t)(void *obj1,
+                                         void *obj2,
+                                         bool begin,
+                                         void *aux);
+
+/**
+ * Create an empty broad phase, within a single group if 'self', otherwise
+ * between two sides.
+ */
+sweep_prune_t *sweep_prune_init(bool self);
+
+/**
+ * Free the broad phase but not its objects.
+ */
+void sweep_prune_free(sweep_prune_t *sweep_prune);
+
+/**
+ * Start a tick. Every object that is still there must be synced again before
+ * sweep_prune_update.
+ */
+void sweep_prune_begin(sweep_prune_t *sweep_prune);
+
+/**
+ * Sync an object on side 'side' (0 or 1) with its bounding box 'box' this tick.
+ * An object synced with a different 'key' from last tick, e.g. a new body that
+ * was allocated in a freed one's place, counts as a different object.
+ */
+void sweep_prune_sync(sweep_prune_t *sweep_prune,
+                      void *obj,
+                      uint64_t key,
+                      aabb_t box,
+                      size_t side);
+
+/**
+ * End the tick: drop the objects that were not synced and bring the sorted ends
+ * and the overlapping pairs up to date, calling 'func' (if not NULL) on each
+ * pair that begins or ends overlapping.
+ */
+void sweep_prune_update(sweep_prune_t *sweep_prune,
+                        sweep_prune_event_func_t func,
+                        void *aux);
+
+/**
+ * Return the number of objects as of the last update.
+ */
+size_t sweep_prune_size(sweep_prune_t *sweep_prune);
+
+/**
+ * Return the number of pairs whose boxes overlap as of the last update.
+ */
+size_t sweep_prune_pair_count(sweep_prune_t *sweep_prune);
+
+/**
+ * Call 'func' on every pair whose boxes overlap as of the last update.
+ * The order only depends on the boxes synced over time and the order in which
+ * they were synced, so it is deterministic.
+ */
+void sweep_prune_for_each_pair(sweep_prune_t *sweep_prune,
+                               sweep_prune_pair_func_t func,
+                               void *aux);
+
+#endif // #ifndef __SWEEP_PRUNE_H__
@@ -26,12 +26,19 @@ typedef enum {
 typedef struct text_tab text_tab_t;
 
 /**
- * A type of function that takes the row's data and returns the string that
- * appears in the given column of the table.
- * NOTICE: The return string of this function must be allocated on the heap via
- * malloc/calloc, for it will be freed after each rendering cycle.
+ * Size of the buffer that column functions write cells into, including the
+ * terminating null character.
  */
-typedef char *(*text_col_func_t)(void *);
+#define TEXT_CELL_SIZE 64
+
+/**
+ * A type of function that takes the row's data and writes the string that
+ * appears in the given column of the table into the buffer 'buf' of 'size'
+ * (TEXT_CELL_SIZE) characters, e.g. with snprintf.
+ * This is called for every cell each time the table is rendered, but the cell
+ * is only laid out again when its string changes.
+ */
+typedef void (*text_col_func_t)(void *data, char *buf, size_t size);
 
 /**
  * Initialize an empty table.
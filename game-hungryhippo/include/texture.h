@@ -0,0 +1,72 @@
+#ifndef __TEXTURE_H__
+#define __TEXTURE_H__
+
+#include <SDL2/SDL.h>
+#include <stdbool.h>
+
+/*** TYPES ***/
+
+typedef struct atlas atlas_t;
+
+/**
+ * An image loaded from a file at some scale, shared by everything that draws
+ * it. Textures are cached by (path, scale) and reference counted: acquiring one
+ * that is already loaded only bumps its count, and it is unloaded when the
+ * last reference is released.
+ *
+ * A texture either lives in a region of the atlas or, if it doesn't fit, has
+ * an SDL texture of its own.
+ */
+typedef struct texture texture_t;
+
+/*** INTERFACE ***/
+
+/**
+ * Set the atlas that textures loaded from now on are packed into when they
+ * fit, or NULL to give every texture its own SDL texture. The atlas must
+ * outlive the textures packed into it.
+ */
+void texture_set_atlas(atlas_t *atlas);
+
+/**
+ * Pack the image at 'img_path' scaled by 'scale' into the atlas ahead of time,
+ * so that acquiring it later doesn't touch the filesystem, and so the atlas
+ * doesn't have to be uploaded again mid-game. Does nothing if there is no atlas
+ * or the image is already in it.
+ */
+void texture_preload(const char *img_path, double scale);
+
+/**
+ * Return the texture for the image at 'img_path' scaled by 'scale', loading it
+ * only if it isn't already cached. Every call must be matched by a call to
+ * 'texture_release'.
+ */
+texture_t *texture_acquire(const char *img_path, double scale);
+
+/**
+ * Drop a reference to the texture, unloading it if it was the last one.
+ */
+void texture_release(texture_t *texture);
+
+/**
+ * Return whether the texture is drawn from the atlas.
+ */
+bool texture_in_atlas(texture_t *texture);
+
+/**
+ * Return the SDL texture the image is in, i.e. the atlas's texture or the
+ * texture's own.
+ */
+SDL_Texture *texture_get_sdl(texture_t *texture);
+
+/**
+ * Return the dimensions in pixels of the SDL texture the image is in.
+ */
+SDL_Point texture_get_sdl_dims(texture_t *texture);
+
+/**
+ * Return where the image is in its SDL texture, in pixels.
+ */
+SDL_Rect texture_get_region(texture_t *texture);
+
+#endif // #ifndef __TEXTURE_H__
@@ -0,0 +1,48 @@
+#ifndef __THREAD_POOL_H__
+#define __THREAD_POOL_H__
+
+#include <stdlib.h>
+
+/*** INTERFACE ***/
+
+/**
+ * A fixed set of worker threads that all run the same function at once, e.g.
+ * each on its own share of an array. The thread that calls 'thread_pool_run'
+ * does a share of the work too, so a pool of n threads spawns only n - 1.
+ * On Windows, which has no POSIX threads, every pool has just the one thread,
+ * so work runs serially on the caller.
+ */
+typedef struct thread_pool thread_pool_t;
+
+/**
+ * A function run by every thread of a pool, with the aux passed to
+ * 'thread_pool_run', the index of the thread in [0, thread_count) and the
+ * thread count. Index 0 is always the calling thread.
+ */
+typedef void (*thread_pool_func_t)(void *aux, size_t idx, size_t thread_count);
+
+/**
+ * Start a pool of 'thread_count' threads (at least one), including the caller.
+ * Failing to start a thread is a fatal error.
+ */
+thread_pool_t *thread_pool_init(size_t thread_count);
+
+/**
+ * Stop and join the pool's threads and free it.
+ */
+void thread_pool_free(thread_pool_t *pool);
+
+/**
+ * Run 'func' on every thread of the pool and return once they have all
+ * finished. Everything written before the call is visible to 'func', and
+ * everything 'func' writes is visible after it.
+ * Only one thread may run a pool at a time, and not from within 'func'.
+ */
+void thread_pool_run(thread_pool_t *pool, thread_pool_func_t func, void *aux);
+
+/**
+ * Return the number of threads in the pool, including the caller.
+ */
+size_t thread_pool_size(thread_pool_t *pool);
+
+#endif // #ifndef __THREAD_POOL_H__
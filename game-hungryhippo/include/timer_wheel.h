@@ -0,0 +1,78 @@
+#ifndef __TIMER_WHEEL_H__
+#define __TIMER_WHEEL_H__
+
+#include <stdint.h>
+#include <stdlib.h>
+
+/*** INTERFACE ***/
+
+/**
+ * Callback timers driven by simulated rather than wall-clock time, kept in a
+ * hierarchical timing wheel: adding and cancelling a timer take constant time,
+ * and advancing costs one step per millisecond plus the timers that go off.
+ * Everything runs on the thread that advances the wheel.
+ */
+typedef struct timer_wheel timer_wheel_t;
+
+/**
+ * A pending timer. It belongs to the wheel and is recycled once it has gone off
+ * for the last time or been cancelled, after which it must not be used.
+ */
+typedef struct wheel_timer wheel_timer_t;
+
+/**
+ * A function called when a timer goes off, with the timer's current interval
+ * in milliseconds and its aux. It returns the interval after which the timer
+ * should go off again, or 0 to stop it. This matches SDL_TimerCallback.
+ */
+typedef uint32_t (*wheel_timer_func_t)(uint32_t interval, void *aux);
+
+/**
+ * Create a wheel with no timers, at time zero.
+ */
+timer_wheel_t *timer_wheel_init(void);
+
+/**
+ * Free the wheel and its timers without calling them. Auxs are not freed.
+ */
+void timer_wheel_free(timer_wheel_t *wheel);
+
+/**
+ * Add a timer that calls 'func' once 'interval' milliseconds have elapsed (at
+ * least one), and return it.
+ * Timers that are due at the same millisecond go off in the order added, where
+ * a repeating timer counts as added again each time it goes off.
+ */
+wheel_timer_t *timer_wheel_add(timer_wheel_t *wheel,
+                               uint32_t interval,
+                               wheel_timer_func_t func,
+                               void *aux);
+
+/**
+ * Stop a timer before it goes off again. This can be called from any timer's
+ * callback, including the timer's own, in which case it will not be re-armed.
+ */
+void timer_wheel_cancel(timer_wheel_t *wheel, wheel_timer_t *timer);
+
+/**
+ * Cancel every timer. Like 'timer_wheel_cancel', this is safe from callbacks.
+ */
+void timer_wheel_cancel_all(timer_wheel_t *wheel);
+
+/**
+ * Advance the wheel by 'seconds', calling every timer that comes due on the
+ * way, in order. Fractions of a millisecond carry over to the next advance.
+ */
+void timer_wheel_advance(timer_wheel_t *wheel, double seconds);
+
+/**
+ * Return the milliseconds the wheel has advanced in total.
+ */
+uint64_t timer_wheel_now(timer_wheel_t *wheel);
+
+/**
+ * Return the number of timers that have yet to go off.
+ */
+size_t timer_wheel_size(timer_wheel_t *wheel);
+
+#endif // #ifndef __TIMER_WHEEL_H__
@@ -0,0 +1,170 @@
+#include "alloc_stats.h"
+#include <assert.h>
+#include <stdbool.h>
+
+// MSVC has no C11 atomics, but nothing runs on other threads there (see
+// thread_pool.h), so plain counters will do.
+#ifdef _WIN32
+typedef size_t atomic_size_t;
+typedef long atomic_long;
+#define atomic_fetch_add_explicit(counter, delta, order) (*(counter) += (delta))
+#define atomic_load_explicit(counter, order) (*(counter))
+#define atomic_store(counter, value) (*(counter) = (value))
+#else
+#include <stdatomic.h>
+#endif
+
+/*** PRIVATE CONSTS ***/
+
+const char *_ALLOC_STATS_SUBSYSTEM_NAMES[ALLOC_SUBSYSTEM_COUNT] = {
+    "list",
+    "vector",
+    "aux",
+    "sprite",
+    "body",
+};
+// Vectors are freed with plain free, so there is no site to count them at.
+const bool _ALLOC_STATS_COUNTS_LIVE[ALLOC_SUBSYSTEM_COUNT] = {
+    true,
+    false,
+    true,
+    true,
+    true,
+};
+
+/*** STRUCTURES ***/
+
+/**
+ * A subsystem's counters. Allocations and bytes only grow, so counts over some
+ * time are differences from a snapshot.
+ */
+typedef struct _alloc_stats_counters {
+    atomic_size_t allocs;
+    atomic_size_t bytes;
+    atomic_long live;
+} _alloc_stats_counters_t;
+
+/**
+ * A subsystem's allocations over the ticks of a period.
+ */
+typedef struct _alloc_stats_period {
+    alloc_counts_t total;
+    size_t max_tick_allocs;
+    size_t max_tick_bytes;
+} _alloc_stats_period_t;
+
+/*** GLOBALS ***/
+
+_alloc_stats_counters_t _alloc_stats_counters[ALLOC_SUBSYSTEM_COUNT];
+alloc_counts_t _alloc_stats_tick_start[ALLOC_SUBSYSTEM_COUNT];
+alloc_counts_t _alloc_stats_last_tick[ALLOC_SUBSYSTEM_COUNT];
+_alloc_stats_period_t _alloc_stats_period[ALLOC_SUBSYSTEM_COUNT];
+size_t _alloc_stats_period_ticks = 0;
+
+/*** DEFINITIONS ***/
+
+void alloc_stats_alloc(alloc_subsystem_t subsystem, size_t bytes) {
+    assert(subsystem < ALLOC_SUBSYSTEM_COUNT);
+    _alloc_stats_counters_t *counters = &_alloc_stats_counters[subsystem];
+    atomic_fetch_add_explicit(&counters->allocs, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&counters->bytes, bytes, memory_order_relaxed);
+}
+
+void alloc_stats_live(alloc_subsystem_t subsystem, int delta) {
+    assert(subsystem < ALLOC_SUBSYSTEM_COUNT);
+    atomic_fetch_add_explicit(&_alloc_stats_counters[subsystem].live,
+                              delta,
+                              memory_order_relaxed);
+}
+
+alloc_counts_t alloc_stats_total(alloc_subsystem_t subsystem) {
+    assert(subsystem < ALLOC_SUBSYSTEM_COUNT);
+    _alloc_stats_counters_t *counters = &_alloc_stats_counters[subsystem];
+    long live = atomic_load_explicit(&counters->live, memory_order_relaxed);
+    return (alloc_counts_t){
+        .allocs
+        = atomic_load_explicit(&counters->allocs, memory_order_relaxed),
+        .bytes = atomic_load_explicit(&counters->bytes, memory_order_relaxed),
+        .live = live > 0 ? live : 0,
+    };
+}
+
+void alloc_stats_end_tick(void) {
+    for (size_t i = 0; i < ALLOC_SUBSYSTEM_COUNT; i++) {
+        alloc_counts_t now = alloc_stats_total(i);
+        alloc_counts_t *start = &_alloc_stats_tick_start[i];
+        alloc_counts_t tick = {now.allocs - start->allocs,
+                               now.bytes - start->bytes,
+                               now.live};
+        _alloc_stats_last_tick[i] = tick;
+        *start = now;
+
+        _alloc_stats_period_t *period = &_alloc_stats_period[i];
+        period->total.allocs += tick.allocs;
+        period->total.bytes += tick.bytes;
+        if (tick.allocs > period->max_tick_allocs) {
+            period->max_tick_allocs = tick.allocs;
+        }
+        if (tick.bytes > period->max_tick_bytes) {
+            period->max_tick_bytes = tick.bytes;
+        }
+    }
+    _alloc_stats_period_ticks++;
+}
+
+alloc_counts_t alloc_stats_last_tick(alloc_subsystem_t subsystem) {
+    assert(subsystem < ALLOC_SUBSYSTEM_COUNT);
+    return _alloc_stats_last_tick[subsystem];
+}
+
+const char *alloc_stats_subsystem_name(alloc_subsystem_t subsystem) {
+    assert(subsystem < ALLOC_SUBSYSTEM_COUNT);
+    return _ALLOC_STATS_SUBSYSTEM_NAMES[subsystem];
+}
+
+void alloc_stats_report(FILE *out, const char *title) {
+    size_t ticks = _alloc_stats_period_ticks;
+    fprintf(out,
+            "Allocations in %s, over %zu ticks:\n"
+            "%-10s %10s %12s %12s %12s %12s %8s\n",
+            title,
+            ticks,
+            "subsystem",
+            "allocs",
+            "bytes",
+            "allocs/tick",
+            "max allocs",
+            "max bytes",
+            "live");
+    for (size_t i = 0; i < ALLOC_SUBSYSTEM_COUNT; i++) {
+        _alloc_stats_period_t *period = &_alloc_stats_period[i];
+        char live[32] = "-";
+        if (_ALLOC_STATS_COUNTS_LIVE[i]) {
+            snprintf(live, sizeof(live), "%zu", alloc_stats_total(i).live);
+        }
+        fprintf(out,
+                "%-10s %10zu %12zu %12.1f %12zu %12zu %8s\n",
+                alloc_stats_subsystem_name(i),
+                period->total.allocs,
+                period->total.bytes,
+                ticks > 0 ? (double)period->total.allocs / ticks : 0,
+                period->max_tick_allocs,
+                period->max_tick_bytes,
+                live);
+        *period = (_alloc_stats_period_t){0};
+    }
+    _alloc_stats_period_ticks = 0;
+}
+
+void alloc_stats_reset(void) {
+    for (size_t i = 0; i < ALLOC_SUBSYSTEM_COUNT; i++) {
+        _alloc_stats_counters_t *counters = &_alloc_stats_counters[i];
+        atomic_store(&counters->allocs, 0);
+        atomic_store(&counters->bytes, 0);
+        atomic_store(&counters->live, 0);
+        _alloc_stats_tick_start[i] = (alloc_counts_t){0};
+        _alloc_stats_last_tick[i] = (alloc_counts_t){0};
+        _alloc_stats_period[i] = (_alloc_stats_period_t){0};
+    }
+    _alloc_stats_period_ticks = 0;
+}
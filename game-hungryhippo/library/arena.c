@@ -0,0 +1,106 @@
+#include "arena.h"
+#include <assert.h>
+#include <stdalign.h>
+#include <stdlib.h>
+
+/*** STRUCTURES ***/
+
+/**
+ * A chunk of memory that allocations are carved out of, front to back.
+ */
+typedef struct _arena_block {
+    struct _arena_block *prev; // The block that filled up before this one.
+    size_t capacity;
+    size_t used;
+    alignas(max_align_t) unsigned char data[];
+} _arena_block_t;
+
+struct arena {
+    _arena_block_t *block; // The block currently being allocated from.
+    size_t used;           // Total over all blocks since the last reset.
+};
+
+/*** PRIVATE PROTOTYPES ***/
+
+/**
+ * Allocate a block with room for 'capacity' bytes, chained after 'prev'.
+ */
+_arena_block_t *_arena_block_init(size_t capacity, _arena_block_t *prev);
+
+/**
+ * Round 'size' up to a multiple of the strictest alignment of any type.
+ */
+size_t _arena_align(size_t size);
+
+/*** DEFINITIONS ***/
+
+_arena_block_t *_arena_block_init(size_t capacity, _arena_block_t *prev) {
+    _arena_block_t *block = malloc(sizeof(_arena_block_t) + capacity);
+    assert(block != NULL);
+    block->prev = prev;
+    block->capacity = capacity;
+    block->used = 0;
+    return block;
+}
+
+size_t _arena_align(size_t size) {
+    size_t alignment = alignof(max_align_t);
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+arena_t *arena_init(size_t capacity) {
+    arena_t *arena = malloc(sizeof(arena_t));
+    assert(arena != NULL);
+    arena->block = _arena_block_init(_arena_align(capacity), NULL);
+    arena->used = 0;
+    return arena;
+}
+
+void arena_free(arena_t *arena) {
+    _arena_block_t *block = arena->block;
+    while (block != NULL) {
+        _arena_block_t *prev = block->prev;
+        free(block);
+        block = prev;
+    }
+    free(arena);
+}
+
+void *arena_alloc(arena_t *arena, size_t size) {
+    size = _arena_align(size);
+    _arena_block_t *block = arena->block;
+    if (block->capacity - block->used < size) {
+        // Start a new block at least as big as everything so far.
+        size_t capacity = block->capacity * 2;
+        if (capacity < size) {
+            capacity = size;
+        }
+        block = _arena_block_init(capacity, block);
+        arena->block = block;
+    }
+    void *ptr = block->data + block->used;
+    block->used += size;
+    arena->used += size;
+    return ptr;
+}
+
+void arena_reset(arena_t *arena) {
+    if (arena->block->prev != NULL) {
+        // Replace the chain with a single block that would have fit it all.
+        size_t capacity = 0;
+        _arena_block_t *block = arena->block;
+        while (block != NULL) {
+            _arena_block_t *prev = block->prev;
+            capacity += block->capacity;
+            free(block);
+            block = prev;
+        }
+        arena->block = _arena_block_init(capacity, NULL);
+    }
+    arena->block->used = 0;
+    arena->used = 0;
+}
+
+size_t arena_used(arena_t *arena) {
+    return arena->used;
+}
@@ -0,0 +1,200 @@
+#include "atlas.h"
+#include "list.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*** PRIVATE CONSTS ***/
+// Transparent pixels left around each image so that filtering at the edge of
+// one image doesn't bleed in its neighbours.
+const int _ATLAS_PADDING = 1;
+
+/*** STRUCTURES ***/
+
+/**
+ * An image in the atlas.
+ */
+typedef struct _atlas_entry {
+    char *img_path;
+    double scale;
+    SDL_Rect region;
+} _atlas_entry_t;
+
+/**
+ * A horizontal strip of the atlas that images are placed along left to right.
+ */
+typedef struct _atlas_shelf {
+    int y;
+    int height;
+    int used; // Width taken up so far.
+} _atlas_shelf_t;
+
+struct atlas {
+    int width;
+    int height;
+    SDL_Surface *surface;
+    SDL_Texture *texture; // NULL until first requested.
+    bool dirty;           // Whether the surface has changed since the upload.
+    list_t *entries;
+    list_t *shelves;
+    int shelves_height; // Total height of all the shelves so far.
+};
+
+/*** PRIVATE PROTOTYPES ***/
+
+void _atlas_entry_free(_atlas_entry_t *entry);
+
+/**
+ * Find room for a w by h image (including padding), opening a new shelf if
+ * needed. Return the shelf to put it on, or NULL if there is no room.
+ */
+_atlas_shelf_t *_atlas_find_shelf(atlas_t *atlas, int w, int h);
+
+/*** DEFINITIONS ***/
+
+atlas_t *atlas_init(int width, int height) {
+    atlas_t *atlas = malloc(sizeof(atlas_t));
+    assert(atlas != NULL);
+    atlas->width = width;
+    atlas->height = height;
+    atlas->surface = SDL_CreateRGBSurfaceWithFormat(0,
+                                                    width,
+                                                    height,
+                                                    32,
+                                                    SDL_PIXELFORMAT_RGBA32);
+    if (atlas->surface == NULL) {
+        fprintf(stderr,
+                "Fatal error: atlas_init: SDL_CreateRGBSurfaceWithFormat: %s\n",
+                SDL_GetError());
+        exit(1);
+    }
+    atlas->texture = NULL;
+    atlas->dirty = true;
+    atlas->entries = list_init(1, (free_func_t)_atlas_entry_free);
+    atlas->shelves = list_init(1, free);
+    atlas->shelves_height = 0;
+    return atlas;
+}
+
+void _atlas_entry_free(_atlas_entry_t *entry) {
+    free(entry->img_path);
+    free(entry);
+}
+
+void atlas_free(atlas_t *atlas) {
+    if (atlas->texture != NULL) {
+        SDL_DestroyTexture(atlas->texture);
+    }
+    SDL_FreeSurface(atlas->surface);
+    list_free(atlas->entries);
+    list_free(atlas->shelves);
+    free(atlas);
+}
+
+bool atlas_find(atlas_t *atlas,
+                const char *img_path,
+                double scale,
+                SDL_Rect *region) {
+    for (size_t i = 0; i < list_size(atlas->entries); i++) {
+        _atlas_entry_t *entry = list_get(atlas->entries, i);
+        if (entry->scale == scale && strcmp(entry->img_path, img_path) == 0) {
+            *region = entry->region;
+            return true;
+        }
+    }
+    return false;
+}
+
+_atlas_shelf_t *_atlas_find_shelf(atlas_t *atlas, int w, int h) {
+    // Use the shortest shelf that fits, so tall shelves are kept for tall
+    // images.
+    _atlas_shelf_t *best = NULL;
+    for (size_t i = 0; i < list_size(atlas->shelves); i++) {
+        _atlas_shelf_t *shelf = list_get(atlas->shelves, i);
+        if (shelf->height >= h && atlas->width - shelf->used >= w
+            && (best == NULL || shelf->height < best->height)) {
+            best = shelf;
+        }
+    }
+    if (best != NULL) {
+        return best;
+    }
+    if (atlas->height - atlas->shelves_height < h || atlas->width < w) {
+        return NULL;
+    }
+    _atlas_shelf_t *shelf = malloc(sizeof(_atlas_shelf_t));
+    assert(shelf != NULL);
+    shelf->y = atlas->shelves_height;
+    shelf->height = h;
+    shelf->used = 0;
+    atlas->shelves_height += h;
+    list_add(atlas->shelves, shelf);
+    return shelf;
+}
+
+bool atlas_add(atlas_t *atlas,
+               const char *img_path,
+               double scale,
+               SDL_Surface *surface,
+               SDL_Rect *region) {
+    int w = surface->w + 2 * _ATLAS_PADDING;
+    int h = surface->h + 2 * _ATLAS_PADDING;
+    // Anything bigger than a quarter of the atlas is better off on its own.
+    if (w > atlas->width / 2 || h > atlas->height / 2) {
+        return false;
+    }
+    _atlas_shelf_t *shelf = _atlas_find_shelf(atlas, w, h);
+    if (shelf == NULL) {
+        return false;
+    }
+
+    SDL_Rect dst = {.x = shelf->used + _ATLAS_PADDING,
+                    .y = shelf->y + _ATLAS_PADDING,
+                    .w = surface->w,
+                    .h = surface->h};
+    // Copy the pixels, alpha included, rather than blending them in.
+    SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_NONE);
+    if (SDL_BlitSurface(surface, NULL, atlas->surface, &dst) != 0) {
+        fprintf(stderr,
+                "Fatal error: atlas_add: SDL_BlitSurface: %s\n",
+                SDL_GetError());
+        exit(1);
+    }
+    shelf->used += w;
+    atlas->dirty = true;
+
+    _atlas_entry_t *entry = malloc(sizeof(_atlas_entry_t));
+    assert(entry != NULL);
+    entry->img_path = strdup(img_path);
+    assert(entry->img_path != NULL);
+    entry->scale = scale;
+    entry->region = dst;
+    list_add(atlas->entries, entry);
+
+    *region = dst;
+    return true;
+}
+
+SDL_Point atlas_get_dims(atlas_t *atlas) {
+    return (SDL_Point){atlas->width, atlas->height};
+}
+
+SDL_Texture *atlas_get_texture(atlas_t *atlas, SDL_Renderer *renderer) {
+    if (atlas->dirty) {
+        if (atlas->texture != NULL) {
+            SDL_DestroyTexture(atlas->texture);
+        }
+        atlas->texture = SDL_CreateTextureFromSurface(renderer, atlas->surface);
+        if (atlas->texture == NULL) {
+            fprintf(stderr,
+                    "Fatal error: atlas_get_texture: "
+                    "SDL_CreateTextureFromSurface: %s\n",
+                    SDL_GetError());
+            exit(1);
+        }
+        SDL_SetTextureBlendMode(atlas->texture, SDL_BLENDMODE_BLEND);
+        atlas->dirty = false;
+    }
+    return atlas->texture;
+}
@@ -5,12 +5,16 @@
 #include "game.h"
 #include "gfx_aux.h"
 #include "list.h"
+#include "physics.h"
 #include "player.h"
 #include "polygon.h"
 #include "sdl_wrapper.h"
+#include "shape_template.h"
 #include "sprite.h"
+#include "texture.h"
 #include "vector.h"
 #include <SDL2/SDL_timer.h>
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -18,6 +22,9 @@
 const double POWERUP_ANGLE_INCR = M_PI / 6.0;
 const char *BALL_PATH_COLLISION_SHAPE = "static/ball/ball_collision_shape.csv";
 const double BALL_MASS = 10;
+const double BALL_GFX_SCALE = 1.0 / 20.0;
+const double BALL_SHAPE_SCALE = 1.0 / 10.0;
+const bool BALL_ROUND = true;
 const double BALL_SHOOT_SPEED = 300;
 const size_t FIFTEEN_SECM = 15 * THOUSAND;
 const size_t TEN_SECM = 10 * THOUSAND;
@@ -64,6 +71,8 @@ typedef struct powerup {
 } powerup_t;
 
 /*** Private Function Prototypes ***/
+polygon_t *ball_player_mouth_shape(body_t *player_body);
+
 void collision_handler_player_ball(body_t *body1,
                                    body_t *body2,
                                    vector_t axis,
@@ -106,9 +115,10 @@ Uint32 powerup_undo_angle_callback(Uint32 interval, player_t *player);
 
 /*** Public Function Definitions ***/
 
-char *powerup_str(powerup_t *powerup) {
+void powerup_str(powerup_t *powerup, char *buf, size_t size) {
     if (powerup == NULL) {
-        return calloc(1, sizeof(char));
+        buf[0] = '\0';
+        return;
     }
     const char *fmt = "%s>%s";
     const char *class_str;
@@ -122,28 +132,44 @@ char *powerup_str(powerup_t *powerup) {
     }
     power_str = POWER_STRS[pu_type];
     assert(class_str != NULL && power_str != NULL);
-    char *s = calloc(strlen(fmt) + strlen(class_str) + strlen(power_str) + 2,
-                     sizeof(char));
-    if (sprintf(s, fmt, class_str, power_str) < 0) {
-        fprintf(stderr, "ball.c: powerup_str: Error calling sprintf.\n");
+    if (snprintf(buf, size, fmt, class_str, power_str) < 0) {
+        fprintf(stderr, "ball.c: powerup_str: Error calling snprintf.\n");
         exit(1);
     }
-    return s;
+}
+
+void ball_preload(void) {
+    polygon_free(
+        shape_template_init(BALL_PATH_COLLISION_SHAPE, BALL_SHAPE_SCALE));
+    for (ball_power_type_e type = 0; type < POWER_NUM_TYPES; type++) {
+        powerup_t *powerup = powerup_init(type);
+        texture_preload(powerup->sprite_path, BALL_GFX_SCALE);
+        powerup_free(powerup);
+    }
 }
 
 void spawn_ball(ehhh_t *ehhh,
                 vector_t init_pos,
                 vector_t init_vel,
-                ball_power_type_e type) {
+                ball_power_type_e type,
+                bool round) {
     powerup_t *powerup = powerup_init(type);
 
-    sprite_t *sprite = sprite_init(powerup->sprite_path, 1.0 / 20.0, VEC_ZERO);
+    sprite_t *sprite
+        = sprite_init(powerup->sprite_path, BALL_GFX_SCALE, VEC_ZERO);
     list_t *sprites = list_init(1, (free_func_t)sprite_free);
     list_add(sprites, sprite);
-    list_t *shapes = list_init(1, (free_func_t)list_free);
-
-    list_t *b = polygon_init_from_path(BALL_PATH_COLLISION_SHAPE);
-    polygon_scale(b, 1.0 / 10.0);
+    list_t *shapes = list_init(1, (free_func_t)polygon_free);
+
+    polygon_t *b
+        = shape_template_init(BALL_PATH_COLLISION_SHAPE, BALL_SHAPE_SCALE);
+    if (round) {
+        aabb_t box = polygon_aabb(b);
+        double radius = fmax(box.max.x - box.min.x, box.max.y - box.min.y) / 2;
+        polygon_t *circle = polygon_init_circle(polygon_centroid(b), radius);
+        polygon_free(b);
+        b = circle;
+    }
     list_add(shapes, b);
 
     gfx_aux_t *gfx = gfx_aux_init(sprites);
@@ -157,46 +183,41 @@ void spawn_ball(ehhh_t *ehhh,
     body_set_centroid(ball, init_pos);
     body_set_velocity(ball, init_vel);
 
-    // Create collisions with the ball.
+    // Collisions with the ball are handled by the rules from
+    // ball_add_collision_rules, which pick up every ball in the group.
+    list_t *balls = ehhh_get_balls(ehhh);
+    list_add(balls, ball);
+}
+
+void ball_add_collision_rules(ehhh_t *ehhh) {
     list_t *players = ehhh_get_players(ehhh);
     list_t *balls = ehhh_get_balls(ehhh);
     physics_t *physics = game_get_physics(ehhh_get_game(ehhh));
-    size_t n_ps = list_size(players);
-    size_t n_balls = list_size(balls);
-    player_t *player = NULL;
-    body_t *body = NULL;
-    list_t **shape_body_p = NULL;
-    for (size_t i = 0; i < n_ps; i++) {
-        body = list_get(players, i);
-        player = body_get_info(body);
-        shape_body_p = body_get_shape_main_p(body);
-        // Bounce collisions between players and ball.
-        create_physics_collision_shapes(physics,
-                                        ehhh_get_elasticity(ehhh),
-                                        body,
-                                        ball,
-                                        shape_body_p,
-                                        NULL);
-        // Eat collisions between players and ball.
-        create_collision_shapes(
-            physics,
-            body,
-            ball,
-            player_get_hippo_mouth_shape(player),
-            body_get_shape_main_p(ball),
-            (collision_handler_t)collision_handler_player_ball,
-            ehhh,
-            NULL);
-    }
-    // Bounce collisiosn between balls and ball.
-    for (size_t j = 0; j < n_balls; j++) {
-        body_t *curr_ball = (body_t *)list_get(balls, j);
-        create_physics_collision(physics,
-                                 ehhh_get_elasticity(ehhh),
-                                 curr_ball,
-                                 ball);
-    }
-    list_add(balls, ball);
+
+    // Bounce collisions between players and balls.
+    create_physics_collision_rule(physics,
+                                  ehhh_get_elasticity(ehhh),
+                                  players,
+                                  balls,
+                                  body_get_shape_main,
+                                  NULL);
+    // Eat collisions between players and balls.
+    physics_add_collision_rule(
+        physics,
+        players,
+        balls,
+        ball_player_mouth_shape,
+        NULL,
+        (collision_handler_t)collision_handler_player_ball,
+        ehhh,
+        NULL);
+    // Bounce collisions between balls.
+    create_physics_collision_rule(physics,
+                                  ehhh_get_elasticity(ehhh),
+                                  balls,
+                                  balls,
+                                  NULL,
+                                  NULL);
 }
 
 void powerup_free(powerup_t *powerup) {
@@ -223,6 +244,10 @@ void powerup_eat(powerup_t *powerup, ehhh_t *ehhh, player_t *player) {
 
 /*** Private Function Definitions ***/
 
+polygon_t *ball_player_mouth_shape(body_t *player_body) {
+    return player_get_hippo_mouth_shape(body_get_info(player_body));
+}
+
 void collision_handler_player_ball(body_t *body1,
                                    body_t *body2,
                                    vector_t axis,
@@ -409,7 +434,8 @@ void powerup_eat_spill(ehhh_t *ehhh, player_t *player) {
                    player_get_shoot_location(player, ehhh),
                    vec_rotate(player_get_shoot_velocity(player, ehhh),
                               removed * M_PI / 5.0),
-                   powerup->type);
+                   powerup->type,
+                   BALL_ROUND);
         powerup_player_rm_points(player, powerup);
         powerup_free(powerup);
 
@@ -475,7 +501,7 @@ void powerup_activate_spawn_ball(ehhh_t *ehhh,
                                  ball_power_type_e activate_type) {
     vector_t init_pos = player_get_shoot_location(player, ehhh);
     vector_t init_vel = player_get_shoot_velocity(player, ehhh);
-    spawn_ball(ehhh, init_pos, init_vel, activate_type);
+    spawn_ball(ehhh, init_pos, init_vel, activate_type, BALL_ROUND);
 }
 
 void powerup_player_rm_points(player_t *player, powerup_t *powerup) {
@@ -0,0 +1,327 @@
+#include "barnes_hut.h"
+#include "body.h"
+#include "list.h"
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+/*** PRIVATE CONSTS ***/
+// Cells with at most this many bodies are not split further; their bodies are
+// always summed one by one.
+#define _BARNES_HUT_LEAF_SIZE 4
+// Bodies at (almost) the same point can't be split apart, so stop somewhere.
+#define _BARNES_HUT_MAX_DEPTH 40
+
+const double _BARNES_HUT_RESIZE_FACTOR = 2.0;
+
+/*** STRUCTURES ***/
+
+typedef struct _barnes_hut_entry {
+    body_t *body;
+    vector_t centroid;
+    double mass;
+} _barnes_hut_entry_t;
+
+/**
+ * A square cell of the tree, holding the entries [start, end).
+ */
+typedef struct _barnes_hut_node {
+    vector_t center;
+    double half_side;
+    double mass;
+    vector_t center_of_mass;
+    size_t start;
+    size_t end;
+    size_t children; // Index of the first of four consecutive children, or 0.
+} _barnes_hut_node_t;
+
+struct barnes_hut {
+    _barnes_hut_entry_t *entries;
+    size_t size;
+    size_t capacity;
+    _barnes_hut_node_t *nodes; // The root, if any, is first.
+    size_t n_nodes;
+    size_t nodes_capacity;
+};
+
+/*** PRIVATE PROTOTYPES ***/
+
+/**
+ * Add a node for the entries [start, end) in the given cell and return its
+ * index.
+ */
+size_t _barnes_hut_add_node(barnes_hut_t *tree,
+                            vector_t center,
+                            double half_side,
+                            size_t start,
+                            size_t end);
+
+/**
+ * Reorder the entries [start, end) so that those with a coordinate ('y' if
+ * 'along_y', else 'x') below 'split' come first, and return where the rest
+ * start.
+ */
+size_t _barnes_hut_partition(_barnes_hut_entry_t *entries,
+                             size_t start,
+                             size_t end,
+                             bool along_y,
+                             double split);
+
+/**
+ * Split a node into quadrants, recursively, and work out its mass and centre
+ * of mass.
+ */
+void _barnes_hut_split(barnes_hut_t *tree, size_t idx, size_t depth);
+
+/**
+ * Return m r / |r|^3, with r from 'point' to 'source', or zero if |r| is no
+ * more than 'min_distance'.
+ */
+vector_t _barnes_hut_pull(vector_t point,
+                          vector_t source,
+                          double mass,
+                          double min_distance);
+
+/*** DEFINITIONS ***/
+
+barnes_hut_t *barnes_hut_init(void) {
+    barnes_hut_t *tree = malloc(sizeof(barnes_hut_t));
+    assert(tree != NULL);
+    tree->size = 0;
+    tree->capacity = 1;
+    tree->entries = malloc(sizeof(_barnes_hut_entry_t));
+    tree->n_nodes = 0;
+    tree->nodes_capacity = 1;
+    tree->nodes = malloc(sizeof(_barnes_hut_node_t));
+    assert(tree->entries != NULL && tree->nodes != NULL);
+    return tree;
+}
+
+void barnes_hut_free(barnes_hut_t *tree) {
+    free(tree->entries);
+    free(tree->nodes);
+    free(tree);
+}
+
+size_t barnes_hut_size(barnes_hut_t *tree) {
+    return tree->size;
+}
+
+void barnes_hut_build(barnes_hut_t *tree, list_t *bodies) {
+    tree->size = 0;
+    tree->n_nodes = 0;
+    if (list_size(bodies) > tree->capacity) {
+        tree->capacity = list_size(bodies);
+        tree->entries = realloc(tree->entries,
+                                tree->capacity * sizeof(_barnes_hut_entry_t));
+        assert(tree->entries != NULL);
+    }
+    vector_t min = {INFINITY, INFINITY};
+    vector_t max = {-INFINITY, -INFINITY};
+    for (size_t i = 0; i < list_size(bodies); i++) {
+        body_t *body = list_get(bodies, i);
+        double mass = body_get_mass(body);
+        if (body_is_removed(body) || mass == INFINITY) {
+            continue;
+        }
+        vector_t centroid = body_get_centroid(body);
+        tree->entries[tree->size++]
+            = (_barnes_hut_entry_t){body, centroid, mass};
+        min = (vector_t){fmin(min.x, centroid.x), fmin(min.y, centroid.y)};
+        max = (vector_t){fmax(max.x, centroid.x), fmax(max.y, centroid.y)};
+    }
+    if (tree->size == 0) {
+        return;
+    }
+
+    vector_t center = vec_multiply(0.5, vec_add(min, max));
+    double half_side = fmax(max.x - min.x, max.y - min.y) / 2;
+    _barnes_hut_add_node(tree, center, half_side, 0, tree->size);
+    _barnes_hut_split(tree, 0, 0);
+}
+
+size_t _barnes_hut_add_node(barnes_hut_t *tree,
+                            vector_t center,
+                            double half_side,
+                            size_t start,
+                            size_t end) {
+    if (tree->n_nodes == tree->nodes_capacity) {
+        tree->nodes_capacity
+            = (size_t)(tree->nodes_capacity * _BARNES_HUT_RESIZE_FACTOR) + 1;
+        tree->nodes = realloc(tree->nodes,
+                              tree->nodes_capacity
+                                  * sizeof(_barnes_hut_node_t));
+        assert(tree->nodes != NULL);
+    }
+    tree->nodes[tree->n_nodes] = (_barnes_hut_node_t){
+        .center = center,
+        .half_side = half_side,
+        .mass = 0,
+        .center_of_mass = VEC_ZERO,
+        .start = start,
+        .end = end,
+        .children = 0,
+    };
+    return tree->n_nodes++;
+}
+
+size_t _barnes_hut_partition(_barnes_hut_entry_t *entries,
+                             size_t start,
+                             size_t end,
+                             bool along_y,
+                             double split) {
+    size_t mid = start;
+    for (size_t i = start; i < end; i++) {
+        vector_t c = entries[i].centroid;
+        if ((along_y ? c.y : c.x) < split) {
+            _barnes_hut_entry_t tmp = entries[i];
+            entries[i] = entries[mid];
+            entries[mid++] = tmp;
+        }
+    }
+    return mid;
+}
+
+void _barnes_hut_split(barnes_hut_t *tree, size_t idx, size_t depth) {
+    // Nodes may move as more are added, so go by index rather than pointer.
+    _barnes_hut_node_t node = tree->nodes[idx];
+
+    if (node.end - node.start > _BARNES_HUT_LEAF_SIZE
+        && depth < _BARNES_HUT_MAX_DEPTH) {
+        // Quadrants in the order bottom left, bottom right, top left, top
+        // right.
+        size_t bounds[5];
+        bounds[0] = node.start;
+        bounds[2] = _barnes_hut_partition(tree->entries,
+                                          node.start,
+                                          node.end,
+                                          true,
+                                          node.center.y);
+        bounds[1] = _barnes_hut_partition(tree->entries,
+                                          node.start,
+                                          bounds[2],
+                                          false,
+                                          node.center.x);
+        bounds[3] = _barnes_hut_partition(tree->entries,
+                                          bounds[2],
+                                          node.end,
+                                          false,
+                                          node.center.x);
+        bounds[4] = node.end;
+
+        double quarter = node.half_side / 2;
+        size_t children = tree->n_nodes;
+        for (size_t q = 0; q < 4; q++) {
+            vector_t offset
+                = {q & 1 ? quarter : -quarter, q & 2 ? quarter : -quarter};
+            _barnes_hut_add_node(tree,
+                                 vec_add(node.center, offset),
+                                 quarter,
+                                 bounds[q],
+                                 bounds[q + 1]);
+        }
+        vector_t moment = VEC_ZERO;
+        for (size_t q = 0; q < 4; q++) {
+            _barnes_hut_split(tree, children + q, depth + 1);
+            _barnes_hut_node_t *child = &tree->nodes[children + q];
+            node.mass += child->mass;
+            moment
+                = vec_add(moment,
+                          vec_multiply(child->mass, child->center_of_mass));
+        }
+        node.children = children;
+        node.center_of_mass = vec_multiply(1 / node.mass, moment);
+    } else if (node.end > node.start) {
+        vector_t moment = VEC_ZERO;
+        for (size_t i = node.start; i < node.end; i++) {
+            _barnes_hut_entry_t *entry = &tree->entries[i];
+            node.mass += entry->mass;
+            moment = vec_add(moment,
+                             vec_multiply(entry->mass, entry->centroid));
+        }
+        node.center_of_mass = vec_multiply(1 / node.mass, moment);
+    }
+    tree->nodes[idx] = node;
+}
+
+vector_t _barnes_hut_pull(vector_t point,
+                          vector_t source,
+                          double mass,
+                          double min_distance) {
+    vector_t r = vec_subtract(source, point);
+    double distance = vec_magnitude(r);
+    if (distance <= min_distance) {
+        return VEC_ZERO;
+    }
+    return vec_multiply(mass / (distance * distance * distance), r);
+}
+
+vector_t barnes_hut_field(barnes_hut_t *tree,
+                          vector_t point,
+                          body_t *exclude,
+                          double theta,
+                          double min_distance) {
+    vector_t field = VEC_ZERO;
+    if (tree->n_nodes == 0) {
+        return field;
+    }
+    // Each level down swaps a node for its four children.
+    size_t stack[3 * _BARNES_HUT_MAX_DEPTH + 1];
+    size_t stack_size = 0;
+    stack[stack_size++] = 0;
+    while (stack_size > 0) {
+        _barnes_hut_node_t *node = &tree->nodes[stack[--stack_size]];
+        if (node->mass == 0) {
+            continue;
+        }
+        if (node->children == 0) {
+            for (size_t i = node->start; i < node->end; i++) {
+                _barnes_hut_entry_t *entry = &tree->entries[i];
+                if (entry->body != exclude) {
+                    field = vec_add(field,
+                                    _barnes_hut_pull(point,
+                                                     entry->centroid,
+                                                     entry->mass,
+                                                     min_distance));
+                }
+            }
+            continue;
+        }
+        bool inside = fabs(point.x - node->center.x) <= node->half_side
+                      && fabs(point.y - node->center.y) <= node->half_side;
+        // A centre of mass near the edge of a cell can be much nearer the
+        // point than some of the bodies, or much further away, so measure from
+        // as far as it is off centre. Cells around the point would count
+        // 'exclude' if there is one, and are never far enough away anyway.
+        double distance
+            = vec_magnitude(vec_subtract(node->center_of_mass, point))
+              - vec_magnitude(vec_subtract(node->center_of_mass, node->center));
+        if (!inside && 2 * node->half_side < theta * distance) {
+            field = vec_add(field,
+                            _barnes_hut_pull(point,
+                                             node->center_of_mass,
+                                             node->mass,
+                                             min_distance));
+            continue;
+        }
+        for (size_t q = 0; q < 4; q++) {
+            stack[stack_size++] = node->children + q;
+        }
+    }
+    return field;
+}
+
+void barnes_hut_add_gravity(barnes_hut_t *tree,
+                            double G,
+                            double theta,
+                            double min_distance) {
+    for (size_t i = 0; i < tree->size; i++) {
+        _barnes_hut_entry_t *entry = &tree->entries[i];
+        vector_t field = barnes_hut_field(tree,
+                                          entry->centroid,
+                                          entry->body,
+                                          theta,
+                                          min_distance);
+        body_add_force(entry->body, vec_multiply(G * entry->mass, field));
+    }
+}
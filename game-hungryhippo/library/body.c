@@ -1,4 +1,5 @@
 #include "body.h"
+#include "alloc_stats.h"
 #include "gfx_aux.h"
 #include "list.h"
 #include "polygon.h"
@@ -10,22 +11,45 @@
 #include <string.h>
 
 const double ANGLE_PRECISION = 1e-7;
+const size_t _BODY_POOL_SLAB_SIZE = 64;
+
+/**
+ * A shape of a body, stored in local coordinates (i.e. relative to the body's
+ * centroid at zero rotation), along with a lazily updated world-space copy.
+ */
+typedef struct _body_shape {
+    polygon_t *local;
+    polygon_t *world;
+    bool dirty; // Whether world is out of date with the body's transform.
+} _body_shape_t;
 
 typedef struct body {
     char *sprite_path;
     char *shape_path;
 
     gfx_aux_t *gfx_aux;
-    list_t *shapes;
-    list_t **shape_main;
+    _body_shape_t *shapes;
+    size_t num_shapes;
+    size_t shape_main;
+    _body_shape_t shape_inline; // Storage for shapes if there is only one.
 
     rgb_color_t color;
 
-    vector_t *centroid;
+    vector_t centroid;
     vector_t velocity;
     double mass; // Nonnegative.
     double moment_of_inertia;
-    double *angle; // Absolute, where 0 rad is initial shape's orientation.
+    double angle; // Absolute, where 0 rad is initial shape's orientation.
+
+    // Where the body was at the start of its last tick, if it has ticked.
+    vector_t prev_centroid;
+    double prev_angle;
+    bool ticked;
+    // Where the body is drawn, between the previous and current states (see
+    // body_interpolate). Bodies never move in memory (see _body_pool), so
+    // pointers to these can be handed out as sprite anchors.
+    vector_t render_centroid;
+    double render_angle;
     double angular_velocity;
     double angular_acceleration;
 
@@ -38,14 +62,118 @@ typedef struct body {
     free_func_t info_freer;
 
     bool removed;
+
+    size_t generation;      // Incremented every time this slot is freed.
+    struct body *next_free; // Next free slot in the pool, if this is free.
 } body_t;
 
+/**
+ * The pool all bodies are allocated from: slabs of slots that are handed out
+ * and returned through a free list. Slabs are never freed, so that handles to
+ * freed bodies can still check their slot's generation, and so that spawning
+ * and removing bodies during a round doesn't go through malloc.
+ */
+typedef struct _body_pool {
+    list_t *slabs;
+    body_t *free_list;
+} _body_pool_t;
+
+_body_pool_t _body_pool = {NULL, NULL};
+
+typedef struct _body_force_entry {
+    body_t *body;
+    vector_t vector;
+    bool impulse; // Whether the vector is an impulse rather than a force.
+} _body_force_entry_t;
+
+struct body_force_log {
+    _body_force_entry_t *entries;
+    size_t size;
+    size_t capacity;
+};
+
+/**
+ * Where this thread's forces and impulses go instead of the bodies, if not
+ * NULL (see body_set_force_log).
+ */
+#ifdef _WIN32
+// MSVC has no _Thread_local, but its pools only have one thread anyway (see
+// thread_pool.h).
+body_force_log_t *_body_force_log = NULL;
+#else
+_Thread_local body_force_log_t *_body_force_log = NULL;
+#endif
+
 /**
  * Private protypes.
  */
 
 void body_set_mass(body_t *body, double mass);
 
+/**
+ * Take a slot from the pool, adding a slab if there are none free.
+ */
+body_t *_body_pool_alloc(void);
+
+/**
+ * Return a body's slot to the pool.
+ */
+void _body_pool_release(body_t *body);
+
+/**
+ * Mark every world-space shape of the body as out of date, e.g. after the body
+ * has moved.
+ */
+void _body_mark_dirty(body_t *body);
+
+/**
+ * Return the world-space version of the body's idx'th shape, updating it first
+ * if the body has moved since it was last requested.
+ */
+polygon_t *_body_get_world_shape(body_t *body, size_t idx);
+
+/**
+ * Move the body to 'centroid' or turn it to 'angle' as part of its motion, so
+ * that it is drawn moving there (see body_interpolate), unlike the public
+ * setters, which teleport it.
+ */
+void _body_move_to(body_t *body, vector_t centroid);
+void _body_turn_to(body_t *body, double angle);
+
+/**
+ * Append a force, or an impulse if 'impulse', to a force log.
+ */
+void _body_force_log_add(body_force_log_t *log,
+                         body_t *body,
+                         vector_t vector,
+                         bool impulse);
+
+body_t *_body_pool_alloc(void) {
+    if (_body_pool.slabs == NULL) {
+        _body_pool.slabs = list_init(1, free);
+    }
+    if (_body_pool.free_list == NULL) {
+        body_t *slab = calloc(_BODY_POOL_SLAB_SIZE, sizeof(body_t));
+        assert(slab != NULL);
+        ALLOC_STATS_ALLOC(BODY, _BODY_POOL_SLAB_SIZE * sizeof(body_t));
+        list_add(_body_pool.slabs, slab);
+        for (size_t i = 0; i < _BODY_POOL_SLAB_SIZE; i++) {
+            slab[i].next_free = _body_pool.free_list;
+            _body_pool.free_list = &slab[i];
+        }
+    }
+    body_t *body = _body_pool.free_list;
+    _body_pool.free_list = body->next_free;
+    body->next_free = NULL;
+    return body;
+}
+
+void _body_pool_release(body_t *body) {
+    body->generation++;
+    body->next_free = _body_pool.free_list;
+    _body_pool.free_list = body;
+}
+
 /**
  * Set the body's mass to a nonnegative double.
  */
@@ -63,8 +191,8 @@ body_t *body_init_with_gfx(double mass,
                            free_func_t info_freer,
                            list_t *shapes,
                            gfx_aux_t *gfx_aux) {
-    body_t *body = malloc(sizeof(body_t));
-    assert(body != NULL);
+    body_t *body = _body_pool_alloc();
+    ALLOC_STATS_CREATE(BODY);
 
     body_set_mass(body, mass);
     body_set_inertia(body, 0);
@@ -75,19 +203,37 @@ body_t *body_init_with_gfx(double mass,
             "Fatal error: body must be initialized with at least one shape.\n");
         exit(1);
     }
-    body->shapes = shapes;
-    body->shape_main = malloc(sizeof(list_t *));
-    assert(body->shape_main != NULL);
-    *(body->shape_main) = list_get(shapes, 0);
+    body->centroid = polygon_centroid(list_get(shapes, 0));
+    body->angle = 0;
+    body->ticked = false;
+    body->render_centroid = body->centroid;
+    body->render_angle = body->angle;
+
+    // The given shapes become the world-space caches, so they are currently up
+    // to date.
+    body->num_shapes = list_size(shapes);
+    if (body->num_shapes == 1) {
+        body->shapes = &body->shape_inline;
+    } else {
+        body->shapes = malloc(body->num_shapes * sizeof(_body_shape_t));
+        assert(body->shapes != NULL);
+        ALLOC_STATS_ALLOC(BODY, body->num_shapes * sizeof(_body_shape_t));
+    }
+    for (size_t i = 0; i < body->num_shapes; i++) {
+        polygon_t *world = list_get(shapes, i);
+        polygon_t *local = polygon_copy(world);
+        polygon_translate(local, vec_negate(body->centroid));
+        body->shapes[i] = (_body_shape_t){local, world, false};
+    }
+    // Take the shapes out of the list before freeing it.
+    while (list_size(shapes) > 0) {
+        list_remove(shapes, list_size(shapes) - 1);
+    }
+    list_free(shapes);
+    body->shape_main = 0;
 
     body_set_color(body, (rgb_color_t){0, 0, 0});
     body_set_velocity(body, VEC_ZERO);
-    body->centroid = malloc(sizeof(vector_t));
-    assert(body->centroid != NULL);
-    *(body->centroid) = polygon_centroid(*(body->shape_main));
-    body->angle = malloc(sizeof(double));
-    assert(body->angle != NULL);
-    *(body->angle) = 0;
     body->moment_of_inertia = INFINITY;
     body_set_angular_dynamics(body, 0, 0, 0);
     body->force = VEC_ZERO;
@@ -106,8 +252,10 @@ body_t *body_init_with_gfx(double mass,
 }
 
 body_t *body_init(list_t *shape, double mass, rgb_color_t color) {
-    list_t *shapes = list_init(1, (free_func_t)list_free);
-    list_add(shapes, shape);
+    list_t *shapes = list_init(1, (free_func_t)polygon_free);
+    list_add(shapes, polygon_init_from_list(shape));
+    // The body owns the shape, which is now stored as a polygon.
+    list_free(shape);
     body_t *body = body_init_with_gfx(mass, NULL, NULL, shapes, NULL);
     body_set_color(body, color);
     return body;
@@ -125,17 +273,32 @@ body_t *body_init_with_info(list_t *shape,
 }
 
 void body_free(body_t *body) {
-    free(body->centroid);
-    free(body->angle);
-    list_free(body->shapes);
+    for (size_t i = 0; i < body->num_shapes; i++) {
+        polygon_free(body->shapes[i].local);
+        polygon_free(body->shapes[i].world);
+    }
+    if (body->shapes != &body->shape_inline) {
+        free(body->shapes);
+    }
     if (body->gfx_aux != NULL) {
         gfx_aux_free(body->gfx_aux);
     }
-    free(body->shape_main);
     if (body->info_freer != NULL && body->info != NULL) {
         body->info_freer(body->info);
     }
-    free(body);
+    _body_pool_release(body);
+    ALLOC_STATS_DESTROY(BODY);
+}
+
+body_handle_t body_get_handle(body_t *body) {
+    return (body_handle_t){body, body->generation};
+}
+
+body_t *body_handle_get(body_handle_t handle) {
+    if (handle.body == NULL || handle.body->generation != handle.generation) {
+        return NULL;
+    }
+    return handle.body;
 }
 
 // Deprecated
@@ -166,43 +329,67 @@ double body_get_inertia(body_t *body) {
 }
 
 list_t *body_get_shape(body_t *body) {
-    return list_copy(body_get_shape_main(body), (copy_func_t)vec_p_copy);
+    return polygon_to_list(body_get_shape_main(body));
+}
+
+void _body_mark_dirty(body_t *body) {
+    for (size_t i = 0; i < body->num_shapes; i++) {
+        body->shapes[i].dirty = true;
+    }
+}
+
+polygon_t *_body_get_world_shape(body_t *body, size_t idx) {
+    _body_shape_t *shape = &body->shapes[idx];
+    if (shape->dirty) {
+        polygon_transform(shape->world,
+                          shape->local,
+                          body->angle,
+                          body->centroid);
+        shape->dirty = false;
+    }
+    return shape->world;
 }
 
-list_t *body_get_shape_nocp(body_t *body) {
-    return *(body->shape_main);
+void body_update_shapes(body_t *body) {
+    for (size_t i = 0; i < body->num_shapes; i++) {
+        _body_get_world_shape(body, i);
+    }
 }
 
-list_t *body_get_shape_main(body_t *body) {
-    return *(body->shape_main);
+polygon_t *body_get_shape_nocp(body_t *body) {
+    return _body_get_world_shape(body, body->shape_main);
 }
 
-list_t **body_get_shape_main_p(body_t *body) {
-    return body->shape_main;
+polygon_t *body_get_shape_main(body_t *body) {
+    return _body_get_world_shape(body, body->shape_main);
 }
 
-list_t *body_get_shape_alt(body_t *body, size_t idx) {
-    if (idx < 0 || idx >= list_size(body->shapes)) {
+polygon_t *body_get_shape_alt(body_t *body, size_t idx) {
+    if (idx < 0 || idx >= body->num_shapes) {
         fprintf(stderr, "Fatal error: that shape doesn't exist.\n");
         exit(1);
     }
-    return list_get(body->shapes, idx);
+    return _body_get_world_shape(body, idx);
 }
 
 size_t body_get_num_shapes(body_t *body) {
-    return list_size(body->shapes);
+    return body->num_shapes;
 }
 
 void body_set_shape_main(body_t *body, size_t idx) {
-    *(body->shape_main) = body_get_shape_alt(body, idx);
+    if (idx < 0 || idx >= body->num_shapes) {
+        fprintf(stderr, "Fatal error: that shape doesn't exist.\n");
+        exit(1);
+    }
+    body->shape_main = idx;
 }
 
 vector_t body_get_centroid(body_t *body) {
-    return *(body->centroid);
+    return body->centroid;
 }
 
 vector_t *body_get_anchor(body_t *body) {
-    return body->centroid;
+    return &body->render_centroid;
 }
 
 vector_t body_get_velocity(body_t *body) {
@@ -210,11 +397,11 @@ vector_t body_get_velocity(body_t *body) {
 }
 
 double body_get_rotation(body_t *body) {
-    return *(body->angle);
+    return body->angle;
 }
 
 double *body_get_angle_p(body_t *body) {
-    return body->angle;
+    return &body->render_angle;
 }
 
 double body_get_angular_velocity(body_t *body) {
@@ -238,20 +425,26 @@ void body_set_angular_dynamics(body_t *body,
     body_set_angular_acceleration(body, angular_acceleration);
 }
 
-void body_set_centroid(body_t *body, vector_t x) {
-    for (size_t i = 0; i < list_size(body->shapes); i++) {
-        list_t *shape = list_get(body->shapes, i);
-        polygon_translate(shape, vec_subtract(x, *(body->centroid)));
+void _body_move_to(body_t *body, vector_t centroid) {
+    body->centroid = centroid;
+    _body_mark_dirty(body);
+}
+
+void _body_turn_to(body_t *body, double angle) {
+    if (fabs(angle) < ANGLE_PRECISION) {
+        angle = 0;
     }
-    *(body->centroid) = x;
+    body->angle = angle;
+    _body_mark_dirty(body);
+}
+
+void body_set_centroid(body_t *body, vector_t x) {
+    _body_move_to(body, x);
+    body->prev_centroid = body->centroid;
 }
 
 void body_translate(body_t *body, vector_t translation) {
-    for (size_t i = 0; i < list_size(body->shapes); i++) {
-        list_t *shape = list_get(body->shapes, i);
-        polygon_translate(shape, translation);
-    }
-    *(body->centroid) = vec_add(body_get_centroid(body), translation);
+    _body_move_to(body, vec_add(body_get_centroid(body), translation));
 }
 
 void body_set_velocity(body_t *body, vector_t v) {
@@ -259,20 +452,12 @@ void body_set_velocity(body_t *body, vector_t v) {
 }
 
 void body_set_rotation(body_t *body, double angle) {
-    if (fabs(angle) < ANGLE_PRECISION) {
-        angle = 0;
-    }
-    for (size_t i = 0; i < list_size(body->shapes); i++) {
-        list_t *shape = list_get(body->shapes, i);
-        polygon_rotate(shape,
-                       angle - body_get_rotation(body),
-                       body_get_centroid(body));
-    }
-    *(body->angle) = angle;
+    _body_turn_to(body, angle);
+    body->prev_angle = body->angle;
 }
 
 void body_rotate(body_t *body, double angle) {
-    body_set_rotation(body, body_get_rotation(body) + angle);
+    _body_turn_to(body, body_get_rotation(body) + angle);
 }
 
 void body_set_angular_velocity(body_t *body, double value) {
@@ -288,14 +473,70 @@ void body_set_color(body_t *body, rgb_color_t value) {
 }
 
 void body_add_force(body_t *body, vector_t force) {
+    if (_body_force_log != NULL) {
+        _body_force_log_add(_body_force_log, body, force, false);
+        return;
+    }
     body->force = vec_add(body->force, force);
 }
 
 void body_add_impulse(body_t *body, vector_t impulse) {
+    if (_body_force_log != NULL) {
+        _body_force_log_add(_body_force_log, body, impulse, true);
+        return;
+    }
     body->impulse = vec_add(body->impulse, impulse);
 }
 
+body_force_log_t *body_force_log_init(void) {
+    body_force_log_t *log = malloc(sizeof(body_force_log_t));
+    assert(log != NULL);
+    log->capacity = 16;
+    log->size = 0;
+    log->entries = malloc(log->capacity * sizeof(_body_force_entry_t));
+    assert(log->entries != NULL);
+    return log;
+}
+
+void body_force_log_free(body_force_log_t *log) {
+    free(log->entries);
+    free(log);
+}
+
+void body_set_force_log(body_force_log_t *log) {
+    _body_force_log = log;
+}
+
+void body_force_log_apply(body_force_log_t *log) {
+    for (size_t i = 0; i < log->size; i++) {
+        _body_force_entry_t *entry = &log->entries[i];
+        if (entry->impulse) {
+            entry->body->impulse = vec_add(entry->body->impulse, entry->vector);
+        } else {
+            entry->body->force = vec_add(entry->body->force, entry->vector);
+        }
+    }
+    log->size = 0;
+}
+
+void _body_force_log_add(body_force_log_t *log,
+                         body_t *body,
+                         vector_t vector,
+                         bool impulse) {
+    if (log->size == log->capacity) {
+        log->capacity *= 2;
+        log->entries = realloc(log->entries,
+                               log->capacity * sizeof(_body_force_entry_t));
+        assert(log->entries != NULL);
+    }
+    log->entries[log->size++] = (_body_force_entry_t){body, vector, impulse};
+}
+
 void body_tick(body_t *body, double dt) {
+    body->prev_centroid = body->centroid;
+    body->prev_angle = body->angle;
+    body->ticked = true;
+
     // Linear dynamics.
     vector_t v1 = body_get_velocity(body);
     /*  body_get_acceleration(body)); // Deprecated acceleration. */
@@ -305,7 +546,7 @@ void body_tick(body_t *body, double dt) {
 
     // Translate at the *average* of the velocities before and after the tick.
     vector_t dx = vec_multiply(dt / 2.0, vec_add(v1, v2));
-    body_translate(body, dx);
+    _body_move_to(body, vec_add(body->centroid, dx));
 
     // The body may have a new velocity after each tick.
     body_set_velocity(body, v2);
@@ -316,7 +557,7 @@ void body_tick(body_t *body, double dt) {
     // Second order: dtheta = omega dt + 1/2 alpha dt^2
     double dtheta = omega * dt + alpha * dt * dt / 2.0;
     double domega = alpha * dt;
-    body_rotate(body, dtheta);
+    _body_turn_to(body, body->angle + dtheta);
     // First order: domega = alpha dt
     body_set_angular_velocity(body, omega + domega);
 
@@ -325,6 +566,21 @@ void body_tick(body_t *body, double dt) {
     body->impulse = VEC_ZERO;
 }
 
+void body_interpolate(body_t *body, double alpha) {
+    if (!body->ticked) {
+        body->render_centroid = body->centroid;
+        body->render_angle = body->angle;
+        return;
+    }
+    body->render_centroid
+        = vec_add(body->prev_centroid,
+                  vec_multiply(alpha,
+                               vec_subtract(body->centroid,
+                                            body->prev_centroid)));
+    body->render_angle
+        = body->prev_angle + alpha * (body->angle - body->prev_angle);
+}
+
 void body_remove(body_t *body) {
     body->removed = true;
 }
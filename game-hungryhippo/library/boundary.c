@@ -64,7 +64,7 @@ void boundary_arena_ball_collision(body_t *ball,
         // move the ball to the closest point on the circle
         vector_t new_centroid
             = vec_rotate_relative(bottom_ref_point, -angle_phi, center_world);
-        body_set_centroid(ball, new_centroid);
+        body_translate(ball, vec_subtract(new_centroid, old_center));
 
         // calculate tan line at that point
         vector_t recenter = vec_subtract(new_centroid, center_world);
@@ -1,4 +1,5 @@
 #include "ehhh.h"
+#include "alloc_stats.h"
 #include "boundary.h"
 #include "game.h"
 #include "graphics.h"
@@ -8,7 +9,10 @@
 #include "physics.h"
 #include "player.h"
 #include "polygon.h"
+#include "profiler.h"
+#include "replay.h"
 #include "sdl_wrapper.h"
+#include "shape_template.h"
 #include "shapes_geometry.h"
 #include "text.h"
 #include "vector.h"
@@ -24,6 +28,7 @@ struct ehhh {
     list_t *text_tabs;
     list_t *text_lns;
     list_t *countdown_auxs;
+    size_t round;            // Starting from 1.
     size_t ball_count_round; // Number of balls created this round.
     size_t max_ball_round_count;
     double elasticity;
@@ -74,6 +79,7 @@ const double _EHHH_WORLD_RADIUS = 450.0;
 const double _EHHH_PLAYER_OFFSET = 100; // Offset outside of radius.
 const double _EHHH_BALL_RADIUS = 33.0;
 const vector_t _EHHH_PLAYER_TAB_POSITION = {30, 800};
+const vector_t _EHHH_PROFILER_TAB_POSITION = {1680, 800};
 const double _EHHH_BUFFER_ZONE = 2000;
 const double _EHHH_MAX_ANGLE_BUFFER = M_PI / 15; // Subtracted from raw max.
 
@@ -244,7 +250,10 @@ Uint32 _ehhh_game_over_callback(Uint32 interval, text_ln_t *aux);
 
 /*** DEFINITIONS ***/
 
-ehhh_t *ehhh_init(size_t player_count, size_t balls_per_round) {
+ehhh_t *ehhh_init(size_t player_count,
+                  size_t balls_per_round,
+                  bool headless,
+                  replay_t *replay) {
     // Constants that may some day be passed from main but for now are here.
     double elasticity = _EHHH_ELASTICITY;
     vector_t dims = _EHHH_DIMS;
@@ -262,14 +271,15 @@ ehhh_t *ehhh_init(size_t player_count, size_t balls_per_round) {
                 EHHH_MIN_PLAYERS);
     }
 
-    srand(time(NULL));
+    srand(replay != NULL ? replay_get_seed(replay) : time(NULL));
 
     ehhh_t *ehhh = malloc(sizeof(ehhh_t));
     assert(ehhh != NULL);
     ehhh->countdown_auxs = list_init(1, free);
 
     game_t *game = ehhh->game
-        = game_init(dims, _EHHH_GROUP_COUNT, _ehhh_tick, ehhh, NULL);
+        = game_init(dims, _EHHH_GROUP_COUNT, _ehhh_tick, ehhh, NULL, headless);
+    game_set_replay(game, replay);
     ehhh->elasticity = elasticity;
     ehhh->center = vec_multiply(1.0 / 2.0, dims);
     ehhh->wrand_ball_type
@@ -279,14 +289,17 @@ ehhh_t *ehhh_init(size_t player_count, size_t balls_per_round) {
     // Setup physics and graphics with correct bodies.
     physics_add_bodies(game_get_physics(game), ehhh_get_players(ehhh));
     physics_add_bodies(game_get_physics(game), ehhh_get_balls(ehhh));
+    ball_add_collision_rules(ehhh);
     graphics_add_bodies(game_get_graphics(game),
                         game_get_group(game, _EHHH_GROUP_BACKGROUND));
     graphics_add_bodies(game_get_graphics(game), ehhh_get_players(ehhh));
     graphics_add_bodies(game_get_graphics(game), ehhh_get_balls(ehhh));
 
     // Setup bodies.
+    ball_preload();
     _ehhh_init_background(ehhh);
     _ehhh_init_players(ehhh, player_count);
+    ehhh->round = 1;
     ehhh->ball_count_round = 0;
     // Ball spawning are started by _ehhh_init_round_sequence.
 
@@ -295,6 +308,9 @@ ehhh_t *ehhh_init(size_t player_count, size_t balls_per_round) {
     list_add(tabs,
              player_create_tab(game_get_group(game, _EHHH_GROUP_PLAYER),
                                _EHHH_PLAYER_TAB_POSITION));
+#ifdef PROFILE
+    list_add(tabs, profiler_create_tab(_EHHH_PROFILER_TAB_POSITION));
+#endif
     graphics_add_text_tabs(game_get_graphics(game), tabs);
     ehhh->text_lns = list_init(1, (free_func_t)text_ln_free);
     graphics_add_text_lns(game_get_graphics(game), ehhh->text_lns);
@@ -318,6 +334,7 @@ void ehhh_free(ehhh_t *ehhh) {
     list_free(ehhh->text_lns);
     list_free(ehhh->countdown_auxs);
     wrand_free(ehhh->wrand_ball_type);
+    shape_template_free_all();
     free(ehhh);
 }
 
@@ -353,6 +370,11 @@ bool _ehhh_end_condition(ehhh_t *ehhh) {
 
 bool _ehhh_handle_rounds(ehhh_t *ehhh) {
     if (_ehhh_win_condition(ehhh)) { // Someone won.
+#ifdef ALLOC_STATS
+        char title[32];
+        snprintf(title, sizeof(title), "round %zu", ehhh->round);
+        alloc_stats_report(stderr, title);
+#endif
         // We have to do this before we start adding to the player list.
         bool end = _ehhh_end_condition(ehhh);
         // We refresh the players without keys in all cases, so the winner can
@@ -370,6 +392,7 @@ bool _ehhh_handle_rounds(ehhh_t *ehhh) {
                 = player_get_points(body_get_info(list_get(winners_old, 0)));
             _ehhh_init_end_sequence(ehhh, list_get(winners, 0), points);
         } else {
+            ehhh->round++;
             ehhh->ball_count_round = 0;
             _ehhh_setup_player_keys(ehhh, winners);
             _ehhh_incr_round(ehhh, loser);
@@ -573,8 +596,8 @@ void _ehhh_init_background(ehhh_t *ehhh) {
                                    VEC_ZERO);
     list_t *sprites = list_init(1, (free_func_t)sprite_free);
     list_add(sprites, sprite);
-    list_t *shapes = list_init(1, (free_func_t)list_free);
-    list_t *background = make_rectangle_polygon(ehhh->center, 5, 5);
+    list_t *shapes = list_init(1, (free_func_t)polygon_free);
+    polygon_t *background = make_rectangle_polygon(ehhh->center, 5, 5);
     list_add(shapes, background);
     gfx_aux_t *gfx = gfx_aux_init(sprites);
     body_t *background_body
@@ -591,7 +614,7 @@ void _ehhh_spawn_ball(ehhh_t *ehhh, vector_t velocity) {
     size_t ball_type_idx = wrand_sample(ehhh->wrand_ball_type);
     assert(ball_type_idx >= 0 && ball_type_idx < _EHHH_BALL_TYPE_COUNT);
     ball_power_type_e type_new_ball = _EHHH_BALL_TYPES[ball_type_idx];
-    spawn_ball(ehhh, ehhh->center, velocity, type_new_ball);
+    spawn_ball(ehhh, ehhh->center, velocity, type_new_ball, BALL_ROUND);
     ehhh->ball_count_round++;
 }
 
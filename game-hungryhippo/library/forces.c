@@ -1,4 +1,6 @@
 #include "forces.h"
+#include "alloc_stats.h"
+#include "barnes_hut.h"
 #include "body.h"
 #include "list.h"
 #include "physics.h"
@@ -11,15 +13,88 @@
 // The minimum "pixel distance" to compute Newtonian gravity at.
 const double GRAVITY_MIN_DISTANCE_THRESHOLD = 5.0;
 
+/**
+ * Parameters for gravity between two bodies.
+ */
+typedef struct aux_gravity {
+    body_t *body1;
+    body_t *body2;
+    double G;
+} aux_gravity_t;
+
+/**
+ * Parameters for a spring between two bodies.
+ */
+typedef struct aux_spring {
+    body_t *body1;
+    body_t *body2;
+    double k;
+    double equilibrium_distance;
+} aux_spring_t;
+
+/**
+ * Parameters for drag on one body.
+ */
+typedef struct aux_drag {
+    body_t *body;
+    double gamma;
+} aux_drag_t;
+
+/**
+ * Parameters for the physics collision handlers.
+ */
+typedef struct aux_physics_collision {
+    double elasticity;
+    double friction; // Only used by 'collision_handler_physics_spin'.
+} aux_physics_collision_t;
+
+/**
+ * Parameters for gravity within a group of bodies, along with the tree that is
+ * rebuilt for it each tick.
+ */
+typedef struct aux_barnes_hut {
+    barnes_hut_t *tree;
+    list_t *bodies;
+    double G;
+    double theta;
+} aux_barnes_hut_t;
+
+/**
+ * Parameters for drag on, or a uniform field over, a group of bodies.
+ */
+typedef struct aux_group {
+    list_t *bodies;
+    double gamma;
+    vector_t acceleration;
+} aux_group_t;
+
+/**
+ * Parameters for springs along a list of edges, all in one allocation.
+ */
+typedef struct aux_springs {
+    double k;
+    size_t n_edges;
+    body_handle_t edges[]; // The bodies at the ends of each edge, in pairs.
+} aux_springs_t;
+
 /*** Private function prototypes. ***/
 
+/**
+ * Free one of the typed auxes below, which are plain allocations, counting it
+ * as no longer live (see alloc_stats.h).
+ */
+void typed_aux_free(void *aux);
+
 // Force creator functions.
-void force_creator_newtonian_gravity(aux_t *aux);
-void force_creator_spring(aux_t *aux);
-void force_creator_drag(aux_t *aux);
+void force_creator_newtonian_gravity(aux_gravity_t *aux);
+void force_creator_barnes_hut_gravity(aux_barnes_hut_t *aux);
+void aux_barnes_hut_free(aux_barnes_hut_t *aux);
+void force_creator_spring(aux_spring_t *aux);
+void force_creator_drag(aux_drag_t *aux);
+void force_creator_group_drag(aux_group_t *aux);
+void force_creator_group_field(aux_group_t *aux);
+void force_creator_springs(aux_springs_t *aux);
 void force_creator_collision(aux_collision_t *aux);
-void force_creator_collision_shapes(aux_collision_t *aux);
-void force_creator_collision_shape(aux_collision_t *aux);
 void collision_handler_destructive(body_t *body1,
                                    body_t *body2,
                                    vector_t axis,
@@ -38,25 +113,38 @@ void collision_handler_physics(body_t *body1,
                                body_t *body2,
                                vector_t axis,
                                vector_t collision_point,
-                               aux_t *aux);
+                               aux_physics_collision_t *aux);
 void collision_handler_physics_spin(body_t *body1,
                                     body_t *body2,
                                     vector_t axis,
                                     vector_t collision_point,
-                                    aux_t *aux);
+                                    aux_physics_collision_t *aux);
+
+/**
+ * Return a new list of the given bodies, for a force tracker.
+ */
+list_t *pair_bodies(body_t *body1, body_t *body2);
+/**
+ * Return new parameters for the physics collision handlers.
+ */
+aux_physics_collision_t *aux_physics_collision_init(double elasticity,
+                                                    double friction);
 
 /*** Public function definitions. ***/
 
 aux_t *aux_init(size_t n_consts, size_t n_bodies) {
-    aux_t *aux = malloc(sizeof(aux_t));
+    // The constants live right after the struct, in the same allocation.
+    aux_t *aux = malloc(sizeof(aux_t) + n_consts * sizeof(double));
     assert(aux != NULL);
+    ALLOC_STATS_ALLOC(AUX, sizeof(aux_t) + n_consts * sizeof(double));
+    ALLOC_STATS_CREATE(AUX);
 
     aux->type = GENERAL_AUX;
     // Set the initial sizes to save memory.
     // Bodies should be freed elsewhere, so pass NULL.
     aux->bodies = list_init(n_bodies, NULL);
-    // Will free the constants automatically since they are addedhere".
-    aux->constants = list_init(n_consts, free);
+    aux->n_consts = 0;
+    aux->consts_capacity = n_consts;
 
     return aux;
 }
@@ -67,6 +155,8 @@ aux_collision_t *aux_collision_init(size_t n_bodies,
                                     free_func_t handler_aux_freer) {
     aux_collision_t *aux = malloc(sizeof(aux_collision_t));
     assert(aux != NULL);
+    ALLOC_STATS_ALLOC(AUX, sizeof(aux_collision_t));
+    ALLOC_STATS_CREATE(AUX);
 
     aux->type = COLLISION_AUX;
     aux->bodies = list_init(n_bodies, NULL);
@@ -85,7 +175,6 @@ void aux_free(aux_t *aux) {
         aux_collision_t *aux_c;
         switch (aux->type) {
         case GENERAL_AUX:
-            list_free(aux->constants);
             break;
         case COLLISION_AUX:
             aux_c = (aux_collision_t *)aux;
@@ -98,6 +187,7 @@ void aux_free(aux_t *aux) {
             break;
         }
         free(aux);
+        ALLOC_STATS_DESTROY(AUX);
     }
 }
 
@@ -106,64 +196,144 @@ void aux_add_body(aux_t *aux, body_t *body) {
 }
 
 void aux_add_constant(aux_t *aux, double c) {
-    double *c_p = malloc(sizeof(double));
-    assert(c_p != NULL);
-
-    *c_p = c;
-
-    list_add(aux->constants, c_p);
+    assert(aux->n_consts < aux->consts_capacity);
+    aux->constants[aux->n_consts++] = c;
 }
 
 void create_newtonian_gravity(physics_t *physics,
                               double G,
                               body_t *body1,
                               body_t *body2) {
-    aux_t *aux = aux_init(1, 2);
-
-    aux_add_constant(aux, G);
-    aux_add_body(aux, body1);
-    aux_add_body(aux, body2);
+    aux_gravity_t *aux = malloc(sizeof(aux_gravity_t));
+    assert(aux != NULL);
+    ALLOC_STATS_ALLOC(AUX, sizeof(aux_gravity_t));
+    ALLOC_STATS_CREATE(AUX);
+    *aux = (aux_gravity_t){.body1 = body1, .body2 = body2, .G = G};
+
+    physics_add_parallel_force(physics,
+                               (force_creator_t)force_creator_newtonian_gravity,
+                               aux,
+                               pair_bodies(body1, body2),
+                               typed_aux_free);
+}
 
-    physics_add_force(physics,
-                      (force_creator_t)force_creator_newtonian_gravity,
-                      aux,
-                      list_copy(aux->bodies, NULL),
-                      (free_func_t)aux_free);
+void create_barnes_hut_gravity(physics_t *physics,
+                               double G,
+                               double theta,
+                               list_t *bodies) {
+    aux_barnes_hut_t *aux = malloc(sizeof(aux_barnes_hut_t));
+    assert(aux != NULL);
+    ALLOC_STATS_ALLOC(AUX, sizeof(aux_barnes_hut_t));
+    ALLOC_STATS_CREATE(AUX);
+    aux->tree = barnes_hut_init();
+    aux->bodies = bodies;
+    aux->G = G;
+    aux->theta = theta;
+
+    // No bodies of its own, so that losing one body doesn't lose the force.
+    physics_add_parallel_force(
+        physics,
+        (force_creator_t)force_creator_barnes_hut_gravity,
+        aux,
+        list_init(1, NULL),
+        (free_func_t)aux_barnes_hut_free);
 }
 
 void create_spring(physics_t *physics, double k, body_t *body1, body_t *body2) {
-    aux_t *aux = aux_init(2, 2);
+    aux_spring_t *aux = malloc(sizeof(aux_spring_t));
+    assert(aux != NULL);
+    ALLOC_STATS_ALLOC(AUX, sizeof(aux_spring_t));
+    ALLOC_STATS_CREATE(AUX);
     // Constant for the initial, equilibrium distance between the centroids of
     // the bodies.
     double eq_dist = 0;
     // Alternatively use initial distance:
     // vec_magnitude(vec_subtract(body_get_centroid(body1),
     // body_get_centroid(body2)));
+    *aux = (aux_spring_t){
+        .body1 = body1,
+        .body2 = body2,
+        .k = k,
+        .equilibrium_distance = eq_dist,
+    };
+
+    physics_add_parallel_force(physics,
+                               (force_creator_t)force_creator_spring,
+                               aux,
+                               pair_bodies(body1, body2),
+                               typed_aux_free);
+}
 
-    // The spring constant, k, is the first constant added.
-    aux_add_constant(aux, k);
-    aux_add_constant(aux, eq_dist);
-    aux_add_body(aux, body1);
-    aux_add_body(aux, body2);
+void create_drag(physics_t *physics, double gamma, body_t *body) {
+    aux_drag_t *aux = malloc(sizeof(aux_drag_t));
+    assert(aux != NULL);
+    ALLOC_STATS_ALLOC(AUX, sizeof(aux_drag_t));
+    ALLOC_STATS_CREATE(AUX);
+    *aux = (aux_drag_t){.body = body, .gamma = gamma};
+
+    list_t *bodies = list_init(1, NULL);
+    list_add(bodies, body);
+    physics_add_parallel_force(physics,
+                               (force_creator_t)force_creator_drag,
+                               aux,
+                               bodies,
+                               typed_aux_free);
+}
 
-    physics_add_force(physics,
-                      (force_creator_t)force_creator_spring,
-                      aux,
-                      list_copy(aux->bodies, NULL),
-                      (free_func_t)aux_free);
+void create_group_drag(physics_t *physics, double gamma, list_t *bodies) {
+    aux_group_t *aux = malloc(sizeof(aux_group_t));
+    assert(aux != NULL);
+    ALLOC_STATS_ALLOC(AUX, sizeof(aux_group_t));
+    ALLOC_STATS_CREATE(AUX);
+    *aux = (aux_group_t){.bodies = bodies, .gamma = gamma};
+
+    // No bodies of its own, so that losing one body doesn't lose the force.
+    physics_add_parallel_force(physics,
+                               (force_creator_t)force_creator_group_drag,
+                               aux,
+                               list_init(1, NULL),
+                               typed_aux_free);
 }
 
-void create_drag(physics_t *physics, double gamma, body_t *body) {
-    aux_t *aux = aux_init(1, 1);
+void create_group_field(physics_t *physics,
+                        vector_t acceleration,
+                        list_t *bodies) {
+    aux_group_t *aux = malloc(sizeof(aux_group_t));
+    assert(aux != NULL);
+    ALLOC_STATS_ALLOC(AUX, sizeof(aux_group_t));
+    ALLOC_STATS_CREATE(AUX);
+    *aux = (aux_group_t){.bodies = bodies, .acceleration = acceleration};
+
+    physics_add_parallel_force(physics,
+                               (force_creator_t)force_creator_group_field,
+                               aux,
+                               list_init(1, NULL),
+                               typed_aux_free);
+}
 
-    aux_add_constant(aux, gamma);
-    aux_add_body(aux, body);
+void create_springs(physics_t *physics,
+                    double k,
+                    body_t **edges,
+                    size_t n_edges) {
+    aux_springs_t *aux
+        = malloc(sizeof(aux_springs_t) + 2 * n_edges * sizeof(body_handle_t));
+    assert(aux != NULL);
+    ALLOC_STATS_ALLOC(AUX,
+                      sizeof(aux_springs_t)
+                          + 2 * n_edges * sizeof(body_handle_t));
+    ALLOC_STATS_CREATE(AUX);
+    aux->k = k;
+    aux->n_edges = n_edges;
+    // Handles rather than pointers, so that a freed body is noticed.
+    for (size_t i = 0; i < 2 * n_edges; i++) {
+        aux->edges[i] = body_get_handle(edges[i]);
+    }
 
-    physics_add_force(physics,
-                      (force_creator_t)force_creator_drag,
-                      aux,
-                      list_copy(aux->bodies, NULL),
-                      (free_func_t)aux_free);
+    physics_add_parallel_force(physics,
+                               (force_creator_t)force_creator_springs,
+                               aux,
+                               list_init(1, NULL),
+                               typed_aux_free);
 }
 
 void create_collision(physics_t *physics,
@@ -172,83 +342,24 @@ void create_collision(physics_t *physics,
                       collision_handler_t handler,
                       void *aux,
                       free_func_t freer) {
-    create_collision_general(physics,
-                             body1,
-                             body2,
-                             NULL,
-                             NULL,
-                             handler,
-                             aux,
-                             freer,
-                             (force_creator_t)force_creator_collision);
+    create_collision_shapes(physics,
+                            body1,
+                            body2,
+                            NULL,
+                            NULL,
+                            handler,
+                            aux,
+                            freer);
 }
 
 void create_collision_shapes(physics_t *physics,
                              body_t *body1,
                              body_t *body2,
-                             list_t **shape1_p,
-                             list_t **shape2_p,
+                             shape_getter_t getter1,
+                             shape_getter_t getter2,
                              collision_handler_t handler,
                              void *aux,
                              free_func_t freer) {
-    if (shape1_p == NULL) {
-        if (shape2_p == NULL) {
-            create_collision_general(physics,
-                                     body1,
-                                     body2,
-                                     NULL,
-                                     NULL,
-                                     handler,
-                                     aux,
-                                     freer,
-                                     (force_creator_t)force_creator_collision);
-
-        } else {
-            create_collision_general(
-                physics,
-                body2,
-                body1,
-                shape2_p,
-                NULL,
-                handler,
-                aux,
-                freer,
-                (force_creator_t)force_creator_collision_shape);
-        }
-    } else if (shape2_p == NULL) {
-        create_collision_general(
-            physics,
-            body1,
-            body2,
-            shape1_p,
-            NULL,
-            handler,
-            aux,
-            freer,
-            (force_creator_t)force_creator_collision_shape);
-    } else {
-        create_collision_general(
-            physics,
-            body1,
-            body2,
-            shape1_p,
-            shape2_p,
-            handler,
-            aux,
-            freer,
-            (force_creator_t)force_creator_collision_shapes);
-    }
-}
-
-void create_collision_general(physics_t *physics,
-                              body_t *body1,
-                              body_t *body2,
-                              list_t **shape1_p,
-                              list_t **shape2_p,
-                              collision_handler_t handler,
-                              void *aux,
-                              free_func_t freer,
-                              force_creator_t force_creator) {
     list_t *bodies = list_init(2, NULL);
     list_add(bodies, body1);
     list_add(bodies, body2);
@@ -256,11 +367,11 @@ void create_collision_general(physics_t *physics,
     aux_collision_t *aux_c = aux_collision_init(2, handler, aux, freer);
     aux_add_body((aux_t *)aux_c, body1);
     aux_add_body((aux_t *)aux_c, body2);
-    aux_c->shape1_p = shape1_p;
-    aux_c->shape2_p = shape2_p;
+    aux_c->getter1 = getter1 != NULL ? getter1 : body_get_shape_nocp;
+    aux_c->getter2 = getter2 != NULL ? getter2 : body_get_shape_nocp;
 
     physics_add_force(physics,
-                      (force_creator_t)force_creator,
+                      (force_creator_t)force_creator_collision,
                       aux_c,
                       bodies,
                       (free_func_t)aux_free);
@@ -326,34 +437,50 @@ void create_physics_collision(physics_t *physics,
                               double elasticity,
                               body_t *body1,
                               body_t *body2) {
-    aux_t *aux = aux_init(1, 0);
-    aux_add_constant(aux, elasticity);
+    aux_physics_collision_t *aux = aux_physics_collision_init(elasticity, 0);
 
     create_collision(physics,
                      body1,
                      body2,
                      (collision_handler_t)collision_handler_physics,
                      aux,
-                     (free_func_t)aux_free);
+                     typed_aux_free);
 }
 
 void create_physics_collision_shapes(physics_t *physics,
                                      double elasticity,
                                      body_t *body1,
                                      body_t *body2,
-                                     list_t **shape1_p,
-                                     list_t **shape2_p) {
-    aux_t *aux = aux_init(1, 0);
-    aux_add_constant(aux, elasticity);
+                                     shape_getter_t getter1,
+                                     shape_getter_t getter2) {
+    aux_physics_collision_t *aux = aux_physics_collision_init(elasticity, 0);
 
     create_collision_shapes(physics,
                             body1,
                             body2,
-                            shape1_p,
-                            shape2_p,
+                            getter1,
+                            getter2,
                             (collision_handler_t)collision_handler_physics,
                             aux,
-                            (free_func_t)aux_free);
+                            typed_aux_free);
+}
+
+void create_physics_collision_rule(physics_t *physics,
+                                   double elasticity,
+                                   list_t *group1,
+                                   list_t *group2,
+                                   shape_getter_t getter1,
+                                   shape_getter_t getter2) {
+    aux_physics_collision_t *aux = aux_physics_collision_init(elasticity, 0);
+
+    physics_add_collision_rule(physics,
+                               group1,
+                               group2,
+                               getter1,
+                               getter2,
+                               (collision_handler_t)collision_handler_physics,
+                               aux,
+                               typed_aux_free);
 }
 
 void create_physics_spin_collision(physics_t *physics,
@@ -361,23 +488,44 @@ void create_physics_spin_collision(physics_t *physics,
                                    double friction,
                                    body_t *body1,
                                    body_t *body2) {
-    aux_t *aux = aux_init(2, 0);
-    aux_add_constant(aux, elasticity);
-    aux_add_constant(aux, friction);
+    aux_physics_collision_t *aux
+        = aux_physics_collision_init(elasticity, friction);
 
     create_collision(physics,
                      body1,
                      body2,
                      (collision_handler_t)collision_handler_physics_spin,
                      aux,
-                     (free_func_t)aux_free);
+                     typed_aux_free);
 }
 
 /*** Private function definitions. ***/
 
-void force_creator_newtonian_gravity(aux_t *aux) {
-    body_t *b1 = (body_t *)list_get(aux->bodies, 0);
-    body_t *b2 = (body_t *)list_get(aux->bodies, 1);
+void typed_aux_free(void *aux) {
+    free(aux);
+    ALLOC_STATS_DESTROY(AUX);
+}
+
+list_t *pair_bodies(body_t *body1, body_t *body2) {
+    list_t *bodies = list_init(2, NULL);
+    list_add(bodies, body1);
+    list_add(bodies, body2);
+    return bodies;
+}
+
+aux_physics_collision_t *aux_physics_collision_init(double elasticity,
+                                                    double friction) {
+    aux_physics_collision_t *aux = malloc(sizeof(aux_physics_collision_t));
+    assert(aux != NULL);
+    ALLOC_STATS_ALLOC(AUX, sizeof(aux_physics_collision_t));
+    ALLOC_STATS_CREATE(AUX);
+    *aux = (aux_physics_collision_t){elasticity, friction};
+    return aux;
+}
+
+void force_creator_newtonian_gravity(aux_gravity_t *aux) {
+    body_t *b1 = aux->body1;
+    body_t *b2 = aux->body2;
 
     // Vector from centroid of b1 to centroid of b2.
     vector_t r_21 = vec_subtract(body_get_centroid(b2), body_get_centroid(b1));
@@ -391,7 +539,7 @@ void force_creator_newtonian_gravity(aux_t *aux) {
     if (mag_r_21 > GRAVITY_MIN_DISTANCE_THRESHOLD) {
         double m1 = body_get_mass(b1);
         double m2 = body_get_mass(b2);
-        double G = *(double *)list_get(aux->constants, 0);
+        double G = aux->G;
 
         // This is the Newtonian gravitational force.
         f_21 = vec_multiply(-G * m1 * m2 / (mag_r_21 * mag_r_21 * mag_r_21),
@@ -404,17 +552,30 @@ void force_creator_newtonian_gravity(aux_t *aux) {
     body_add_force(b2, f_21);
 }
 
-void force_creator_spring(aux_t *aux) {
-    body_t *b1 = (body_t *)list_get(aux->bodies, 0);
-    body_t *b2 = (body_t *)list_get(aux->bodies, 1);
+void force_creator_barnes_hut_gravity(aux_barnes_hut_t *aux) {
+    barnes_hut_build(aux->tree, aux->bodies);
+    barnes_hut_add_gravity(aux->tree,
+                           aux->G,
+                           aux->theta,
+                           GRAVITY_MIN_DISTANCE_THRESHOLD);
+}
+
+void aux_barnes_hut_free(aux_barnes_hut_t *aux) {
+    barnes_hut_free(aux->tree);
+    typed_aux_free(aux);
+}
+
+void force_creator_spring(aux_spring_t *aux) {
+    body_t *b1 = aux->body1;
+    body_t *b2 = aux->body2;
 
     // Vector from centroid of b1 to centroid of b2 (the direction we want b1 to
     // go in, opposite for b2).
     vector_t r_21 = vec_subtract(body_get_centroid(b2), body_get_centroid(b1));
 
     double mag_r_21 = vec_magnitude(r_21);
-    double equilibrium_distance = *(double *)list_get(aux->constants, 1);
-    double k = *(double *)list_get(aux->constants, 0);
+    double equilibrium_distance = aux->equilibrium_distance;
+    double k = aux->k;
 
     // Force vectors.
     // F = k * x, in the direction of the centroid differences as a unit vector.
@@ -426,19 +587,59 @@ void force_creator_spring(aux_t *aux) {
     body_add_force(b2, f_2);
 }
 
-void force_creator_drag(aux_t *aux) {
-    body_t *b = (body_t *)list_get(aux->bodies, 0);
+void force_creator_drag(aux_drag_t *aux) {
+    body_t *b = aux->body;
 
     vector_t v = body_get_velocity(b);
-    double gamma = 0;
 
-    gamma = *(double *)list_get(aux->constants, 0);
+    body_add_force(b, vec_multiply(-aux->gamma, v));
+}
 
-    body_add_force(b, vec_multiply(-gamma, v));
+void force_creator_group_drag(aux_group_t *aux) {
+    for (size_t i = 0; i < list_size(aux->bodies); i++) {
+        body_t *b = list_get(aux->bodies, i);
+        if (!body_is_removed(b)) {
+            body_add_force(b, vec_multiply(-aux->gamma, body_get_velocity(b)));
+        }
+    }
 }
 
-void mediate_collision(aux_collision_t *aux, list_t *shape1, list_t *shape2) {
-    collision_info_t c_info = find_collision(shape1, shape2);
+void force_creator_group_field(aux_group_t *aux) {
+    for (size_t i = 0; i < list_size(aux->bodies); i++) {
+        body_t *b = list_get(aux->bodies, i);
+        double mass = body_get_mass(b);
+        if (!body_is_removed(b) && mass != INFINITY) {
+            body_add_force(b, vec_multiply(mass, aux->acceleration));
+        }
+    }
+}
+
+void force_creator_springs(aux_springs_t *aux) {
+    for (size_t i = 0; i < aux->n_edges; i++) {
+        body_t *b1 = body_handle_get(aux->edges[2 * i]);
+        body_t *b2 = body_handle_get(aux->edges[2 * i + 1]);
+        if (b1 == NULL || b2 == NULL || body_is_removed(b1)
+            || body_is_removed(b2)) {
+            continue;
+        }
+        // Like 'force_creator_spring' with an equilibrium distance of 0, so
+        // the force is just k times the vector between the centroids.
+        vector_t r_21
+            = vec_subtract(body_get_centroid(b2), body_get_centroid(b1));
+        vector_t f_1 = vec_multiply(aux->k, r_21);
+        body_add_force(b1, f_1);
+        body_add_force(b2, vec_negate(f_1));
+    }
+}
+
+void mediate_collision(aux_collision_t *aux,
+                       polygon_t *shape1,
+                       polygon_t *shape2) {
+    // Most pairs are far apart, so rule them out before any SAT work.
+    collision_info_t c_info = {.collided = false};
+    if (polygon_bounds_overlap(shape1, shape2)) {
+        c_info = find_collision(shape1, shape2);
+    }
 
     if (c_info.collided == true) {
         body_t *body1 = (body_t *)list_get(aux->bodies, 0);
@@ -459,21 +660,7 @@ void mediate_collision(aux_collision_t *aux, list_t *shape1, list_t *shape2) {
 void force_creator_collision(aux_collision_t *aux) {
     body_t *body1 = (body_t *)list_get(aux->bodies, 0);
     body_t *body2 = (body_t *)list_get(aux->bodies, 1);
-    list_t *shape1 = body_get_shape_nocp(body1);
-    list_t *shape2 = body_get_shape_nocp(body2);
-    mediate_collision(aux, shape1, shape2);
-}
-
-void force_creator_collision_shapes(aux_collision_t *aux) {
-    list_t *shape1 = *(aux->shape1_p);
-    list_t *shape2 = *(aux->shape2_p);
-    mediate_collision(aux, shape1, shape2);
-}
-
-void force_creator_collision_shape(aux_collision_t *aux) {
-    list_t *shape1 = *(aux->shape1_p);
-    list_t *shape2 = body_get_shape_nocp((body_t *)list_get(aux->bodies, 1));
-    mediate_collision(aux, shape1, shape2);
+    mediate_collision(aux, aux->getter1(body1), aux->getter2(body2));
 }
 
 // void collision_handler_boundary(body_t *ball,
@@ -482,7 +669,7 @@ void force_creator_collision_shape(aux_collision_t *aux) {
 //                                 vector_t collision_point,
 //                                 aux_t * aux) {
 //     double ma = body_get_mass(ball);
-//     double CR = *(double *)list_get(aux->constants, 0);
+//     double CR = aux->constants[0];
 //     double ua = vec_dot(body_get_velocity(ball), axis);
 //     double Jn = ma * (1 + CR) * (0 - ua);
 //     body_add_impulse(ball, vec_multiply(Jn, axis));
@@ -510,10 +697,10 @@ void collision_handler_physics(body_t *body1,
                                body_t *body2,
                                vector_t axis,
                                vector_t collision_point,
-                               aux_t *aux) {
+                               aux_physics_collision_t *aux) {
     double ma = body_get_mass(body1);
     double mb = body_get_mass(body2);
-    double CR = *(double *)list_get(aux->constants, 0);
+    double CR = aux->elasticity;
     double ua = vec_dot(body_get_velocity(body1), axis);
     double ub = vec_dot(body_get_velocity(body2), axis);
     double r_mass;
@@ -541,11 +728,11 @@ void collision_handler_physics_spin(body_t *body1,
                                     body_t *body2,
                                     vector_t axis,
                                     vector_t collision_point,
-                                    aux_t *aux) {
+                                    aux_physics_collision_t *aux) {
     double ma = body_get_mass(body1);
     double mb = body_get_mass(body2);
-    double CR = *(double *)list_get(aux->constants, 0);
-    double f_c = *(double *)list_get(aux->constants, 1);
+    double CR = aux->elasticity;
+    double f_c = aux->friction;
     double ua = vec_dot(body_get_velocity(body1), axis);
     double ub = vec_dot(body_get_velocity(body2), axis);
     double mass_divisor;
@@ -1,14 +1,23 @@
 #include "game.h"
+#include "alloc_stats.h"
+#include "arena.h"
 #include "body.h"
 #include "graphics.h"
 #include "key_listener.h"
 #include "physics.h"
+#include "profiler.h"
+#include "replay.h"
 #include "sdl_wrapper.h"
+#include "timer_wheel.h"
 #include "vector.h"
-#include <SDL2/SDL_timer.h>
 #include <assert.h>
 #include <stdio.h>
 
+/*** PRIVATE CONSTS ***/
+const size_t _GAME_FRAME_ARENA_CAPACITY = 64 * 1024; // Grows if needed.
+const double _GAME_DEFAULT_TICK_RATE = 120; // Hz.
+const size_t _GAME_DEFAULT_MAX_SUBSTEPS = 8;
+
 /*** GLOBALS ***/
 int _game_count = 0;
 
@@ -21,29 +30,30 @@ struct game {
     tick_func_t tick_func;
     void *aux;
     free_func_t aux_freer;
-    list_t *timers;
+    timer_wheel_t *timers; // Advanced by simulated time, one step at a time.
     key_listener_t *key_listener;
+    arena_t *frame_arena; // Scratch memory, reset at the end of each tick.
+    double tick_dt;       // Seconds simulated by each physics step.
+    size_t max_substeps;  // Physics steps per tick before falling behind.
+    double accumulator;   // Seconds not yet simulated.
+    replay_t *replay;     // NULL if neither recording nor playing back.
 };
 
-typedef struct _game_timer {
-    SDL_TimerID id;
-    SDL_TimerCallback callback;
-    void *aux;
-    Uint32 interval;
-    bool removed; // Whether marked for removal.
-    bool called;  // Whether has emerged from the queue yet, can be freed.
-} _game_timer_t;
-
-typedef enum _game_event_code { _GAME_EVENT_CODE_TIMER } _game_event_code_t;
-
 /*** PRIVATE PROTOTYPES ***/
 void _game_collect_garbage(game_t *game);
-Uint32 _game_callback(Uint32 interval, _game_timer_t *timer);
 
 /**
- * Remove a timer and its tracker.
+ * Handle the SDL events queued since the last tick, recording them if the
+ * game is being recorded, and return whether the window was closed.
+ */
+bool _game_handle_events(game_t *game);
+
+/**
+ * Handle the events of the current tick from the replay being played back
+ * instead, and return whether the replay is over or the window was closed.
+ * Write how long the tick took into 'dt'.
  */
-void _game_timer_free(_game_timer_t *timer);
+bool _game_play_events(game_t *game, double *dt);
 
 /*** DEFINITIONS ***/
 
@@ -51,14 +61,19 @@ game_t *game_init(vector_t dims,
                   size_t groups_count,
                   tick_func_t tick_func,
                   void *aux,
-                  free_func_t aux_freer) {
+                  free_func_t aux_freer,
+                  bool headless) {
     if (_game_count > 0) {
         fprintf(stderr, "Invalid state: you cannot have multiple games.");
         exit(1);
     }
     game_t *game = malloc(sizeof(game_t));
     assert(game != NULL);
-    sdl_init(VEC_ZERO, dims);
+    if (headless) {
+        sdl_init_headless(VEC_ZERO, dims);
+    } else {
+        sdl_init(VEC_ZERO, dims);
+    }
     game->groups_count = groups_count;
     game->groups = calloc(groups_count, sizeof(list_t *));
     assert(game->groups != NULL);
@@ -70,8 +85,15 @@ game_t *game_init(vector_t dims,
     game->tick_func = tick_func;
     game->aux = aux;
     game->aux_freer = aux_freer;
-    game->timers = list_init(1, (free_func_t)_game_timer_free);
+    game->timers = timer_wheel_init();
     game->key_listener = key_listener_init();
+    game->frame_arena = arena_init(_GAME_FRAME_ARENA_CAPACITY);
+    sdl_set_frame_arena(game->frame_arena);
+    game_set_tick_rate(game,
+                       _GAME_DEFAULT_TICK_RATE,
+                       _GAME_DEFAULT_MAX_SUBSTEPS);
+    game->accumulator = 0;
+    game->replay = NULL;
     _game_count++;
     return game;
 }
@@ -86,8 +108,13 @@ void game_free(game_t *game) {
     if (game->aux_freer != NULL) {
         game->aux_freer(game->aux);
     }
-    list_free(game->timers);
+    timer_wheel_free(game->timers);
     key_listener_free(game->key_listener);
+    if (game->replay != NULL) {
+        replay_free(game->replay);
+    }
+    sdl_set_frame_arena(NULL);
+    arena_free(game->frame_arena);
     sdl_free_all();
     free(game);
     _game_count--;
@@ -115,64 +142,116 @@ bool game_tick(game_t *game, double dt) {
     // any frees should be deferred to _game_collect_garbage at the very end
     // of the tick, including any removal by tick_func.
     _game_audit_gc(game, "game_tick start");
+    PROFILE_BEGIN(FRAME);
 
-    bool done = false;
+    PROFILE_BEGIN(EVENTS);
+    bool done;
+    if (game->replay != NULL && replay_is_playback(game->replay)) {
+        done = _game_play_events(game, &dt);
+    } else {
+        done = _game_handle_events(game);
+        // Without a display, there is no frame to keep up with, so just take
+        // one step per tick.
+        if (sdl_is_headless()) {
+            dt = game->tick_dt;
+        }
+        if (game->replay != NULL) {
+            replay_record_tick(game->replay, dt);
+        }
+    }
+    PROFILE_END(EVENTS);
+
+    // Step physics and the client's tick at a fixed rate, however long the
+    // frame took. If we are too far behind to catch up, drop the backlog
+    // rather than fall further behind each frame.
+    game->accumulator += dt;
+    double max_backlog = game->max_substeps * game->tick_dt;
+    if (game->accumulator > max_backlog) {
+        game->accumulator = max_backlog;
+    }
+    while (game->accumulator >= game->tick_dt) {
+        game->accumulator -= game->tick_dt;
+        // Timers run on the same clock as physics.
+        timer_wheel_advance(game->timers, game->tick_dt);
+        physics_tick(game->physics, game->tick_dt);
+        // Client's custom tick.
+        PROFILE_BEGIN(CLIENT_TICK);
+        done = done || game->tick_func(game);
+        PROFILE_END(CLIENT_TICK);
+        // Garbage collection, actual freeing happens here and only here.
+        _game_collect_garbage(game);
+    }
+
+    // Draw what's left over as a fraction of the way to the next step.
+    if (!sdl_is_headless()) {
+        PROFILE_BEGIN(RENDER);
+        graphics_render(game->graphics, game->accumulator / game->tick_dt);
+        PROFILE_END(RENDER);
+    }
 
-    // Handle sdl events.
-    SDL_Event *event = malloc(sizeof(SDL_Event));
-    assert(event != NULL);
-    while (SDL_PollEvent(event)) {
-        switch (event->type) {
+    // Event handlers may have removed things even if there was no step.
+    _game_collect_garbage(game);
+    // Nothing allocated for this frame is needed any more.
+    arena_reset(game->frame_arena);
+
+    PROFILE_END(FRAME);
+    PROFILE_END_FRAME();
+    ALLOC_STATS_END_TICK();
+    return done;
+}
+
+bool _game_handle_events(game_t *game) {
+    bool done = false;
+    SDL_Event event;
+    while (SDL_PollEvent(&event)) {
+        switch (event.type) {
         case SDL_QUIT:
+            if (game->replay != NULL) {
+                replay_record_quit(game->replay);
+            }
             done = true;
             break;
         case SDL_KEYDOWN:
         case SDL_KEYUP:
-            if (!event->key.repeat) {
-                key_listener_listen(game->key_listener, event->key);
-            }
-            break;
-        case SDL_USEREVENT:
-            if (event->user.code == _GAME_EVENT_CODE_TIMER) {
-                _game_timer_t *timer = event->user.data1;
-                if (!timer->removed && !timer->called) {
-                    Uint32 interval
-                        = timer->callback(timer->interval, timer->aux);
-                    if (interval > 0) {
-                        game_add_timer(game,
-                                       interval,
-                                       timer->callback,
-                                       timer->aux);
-                    }
+            if (!event.key.repeat) {
+                if (game->replay != NULL) {
+                    replay_record_key(game->replay, event.key);
                 }
-                timer->removed = true;
-                timer->called = true;
+                key_listener_listen(game->key_listener, event.key);
             }
             break;
         }
     }
-    free(event);
-
-    // Tick components.
-    physics_tick(game->physics, dt);
-    graphics_render(game->graphics);
-
-    // Client's custom tick.
-    done = done || game->tick_func(game);
-
-    // Garbage collection, actual freeing happens here and only here.
-    _game_collect_garbage(game);
-
     return done;
 }
 
-void _game_collect_garbage(game_t *game) {
-    for (int i = list_size(game->timers) - 1; i >= 0; i--) {
-        _game_timer_t *timer = list_get(game->timers, i);
-        if (timer->removed && timer->called) {
-            _game_timer_free(list_remove(game->timers, i));
+bool _game_play_events(game_t *game, double *dt) {
+    // Everything comes from the replay, but the window can still be closed.
+    bool done = false;
+    SDL_Event event;
+    while (SDL_PollEvent(&event)) {
+        done = done || event.type == SDL_QUIT;
+    }
+
+    while (true) {
+        replay_event_t replayed = replay_read(game->replay);
+        switch (replayed.type) {
+        case REPLAY_EVENT_KEY:
+            key_listener_listen(game->key_listener, replayed.key);
+            break;
+        case REPLAY_EVENT_QUIT:
+        case REPLAY_EVENT_END:
+            *dt = 0;
+            return true;
+        case REPLAY_EVENT_TICK:
+            *dt = replayed.dt;
+            return done;
         }
     }
+}
+
+void _game_collect_garbage(game_t *game) {
+    PROFILE_BEGIN(GC);
     for (size_t i = 0; i < game->groups_count; i++) {
         list_t *bodies = game_get_group(game, i);
         for (int j = list_size(bodies) - 1; j >= 0; j--) {
@@ -182,6 +261,7 @@ void _game_collect_garbage(game_t *game) {
             }
         }
     }
+    PROFILE_END(GC);
     _game_audit_gc(game, "_game_collect_garbage end");
 }
 
@@ -215,40 +295,34 @@ void *game_get_aux(game_t *game) {
     return game->aux;
 }
 
-void _game_timer_free(_game_timer_t *timer) {
-    SDL_RemoveTimer(timer->id);
-    free(timer);
+arena_t *game_get_frame_arena(game_t *game) {
+    return game->frame_arena;
+}
+
+void game_set_tick_rate(game_t *game, double rate, size_t max_substeps) {
+    assert(rate > 0 && max_substeps > 0);
+    game->tick_dt = 1.0 / rate;
+    game->max_substeps = max_substeps;
+}
+
+void game_set_replay(game_t *game, replay_t *replay) {
+    if (game->replay != NULL) {
+        replay_free(game->replay);
+    }
+    game->replay = replay;
+}
+
+wheel_timer_t *game_add_timer(game_t *game,
+                              Uint32 interval,
+                              SDL_TimerCallback callback,
+                              void *aux) {
+    return timer_wheel_add(game->timers, interval, callback, aux);
 }
 
-SDL_TimerID game_add_timer(game_t *game,
-                           Uint32 interval,
-                           SDL_TimerCallback callback,
-                           void *aux) {
-    _game_timer_t *timer = malloc(sizeof(_game_timer_t));
-    timer->removed = false;
-    timer->callback = callback;
-    timer->aux = aux;
-    list_add(game->timers, timer);
-    timer->id
-        = SDL_AddTimer(interval, (SDL_TimerCallback)_game_callback, timer);
-    return timer->id;
+void game_cancel_timer(game_t *game, wheel_timer_t *timer) {
+    timer_wheel_cancel(game->timers, timer);
 }
 
 void game_clear_timers(game_t *game) {
-    for (int i = list_size(game->timers) - 1; i >= 0; i--) {
-        ((_game_timer_t *)list_get(game->timers, i))->removed = true;
-    }
-}
-
-Uint32 _game_callback(Uint32 interval, _game_timer_t *timer) {
-    timer->interval = interval;
-    SDL_Event *event = malloc(sizeof(SDL_Event));
-    event->type = SDL_USEREVENT;
-    event->user.code = _GAME_EVENT_CODE_TIMER;
-    event->user.data1 = timer;
-    // event->user->data2 not used, everything put into timer for simplicity.
-    event->user.data2 = NULL;
-    SDL_PushEvent(event);
-    free(event);
-    return 0;
+    timer_wheel_cancel_all(game->timers);
 }
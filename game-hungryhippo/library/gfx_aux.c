@@ -42,6 +42,10 @@ void gfx_aux_set_sprite(gfx_aux_t *gfx_aux, size_t idx) {
     gfx_aux->active_sprite_idx = idx;
 }
 
+sprite_t *gfx_aux_get_sprite(gfx_aux_t *gfx_aux) {
+    return list_get(gfx_aux->sprites, gfx_aux->active_sprite_idx);
+}
+
 void gfx_aux_render(gfx_aux_t *gfx_aux) {
     sdl_render_sprite(list_get(gfx_aux->sprites, gfx_aux->active_sprite_idx));
 }
@@ -1,11 +1,20 @@
 #include "graphics.h"
+#include "atlas.h"
+#include "body.h"
+#include "gfx_aux.h"
 #include "list.h"
 #include "sdl_wrapper.h"
+#include "sprite.h"
 #include "stdio.h"
 #include "stdlib.h"
 #include "text.h"
+#include "texture.h"
 #include "vector.h"
 
+/*** PRIVATE CONSTS ***/
+// Big enough for every ball and hippo sprite.
+const int _GRAPHICS_ATLAS_SIZE = 1024;
+
 /*** GLOBALS ***/
 
 int _graphics_count = 0;
@@ -17,12 +26,28 @@ struct graphics {
     list_t *body_groups;
     list_t *text_tab_groups;
     list_t *text_ln_groups;
+    atlas_t *atlas; // Shared by all sprites that fit.
 };
 
 /*** PRIVATE PROTOTYPES ***/
 void _graphics_render_groups(list_t *groups, void (*rend_func)(void *));
 void _graphics_render_objects(list_t *objects, void (*rend_func)(void *));
 
+/**
+ * Interpolate and render all body groups in order, drawing consecutive bodies
+ * whose sprites are in the atlas with one SDL_RenderGeometry call rather than
+ * one copy each.
+ */
+void _graphics_render_bodies(graphics_t *graphics, double alpha);
+
+/**
+ * Draw the 'quad_count' quads batched so far.
+ */
+void _graphics_flush_quads(graphics_t *graphics,
+                           SDL_Vertex *vertices,
+                           int *indices,
+                           size_t quad_count);
+
 /*** DEFINITIONS ***/
 
 graphics_t *graphics_init(vector_t dims) {
@@ -36,6 +61,12 @@ graphics_t *graphics_init(vector_t dims) {
     graphics->body_groups = list_init(1, NULL);
     graphics->text_tab_groups = list_init(1, NULL);
     graphics->text_ln_groups = list_init(1, NULL);
+    // Without a display there is nothing to pack.
+    graphics->atlas
+        = sdl_is_headless()
+              ? NULL
+              : atlas_init(_GRAPHICS_ATLAS_SIZE, _GRAPHICS_ATLAS_SIZE);
+    texture_set_atlas(graphics->atlas);
     _graphics_count++;
     return graphics;
 }
@@ -44,6 +75,10 @@ void graphics_free(graphics_t *graphics) {
     list_free(graphics->text_tab_groups);
     list_free(graphics->text_ln_groups);
     list_free(graphics->body_groups);
+    texture_set_atlas(NULL);
+    if (graphics->atlas != NULL) {
+        atlas_free(graphics->atlas);
+    }
     free(graphics);
     _graphics_count--;
 }
@@ -60,10 +95,9 @@ void graphics_add_text_lns(graphics_t *graphics, list_t *text_lns) {
     list_add(graphics->text_ln_groups, text_lns);
 }
 
-void graphics_render(graphics_t *graphics) {
+void graphics_render(graphics_t *graphics, double alpha) {
     sdl_clear();
-    _graphics_render_groups(graphics->body_groups,
-                            (void (*)(void *))sdl_render_body);
+    _graphics_render_bodies(graphics, alpha);
     _graphics_render_groups(graphics->text_tab_groups,
                             (void (*)(void *))text_tab_render);
     _graphics_render_groups(graphics->text_ln_groups,
@@ -82,3 +116,59 @@ void _graphics_render_objects(list_t *objects, void (*rend_func)(void *)) {
         rend_func(list_get(objects, i));
     }
 }
+
+void _graphics_render_bodies(graphics_t *graphics, double alpha) {
+    size_t body_count = 0;
+    for (size_t i = 0; i < list_size(graphics->body_groups); i++) {
+        body_count += list_size(list_get(graphics->body_groups, i));
+    }
+    arena_t *arena = sdl_get_frame_arena();
+    SDL_Vertex *vertices
+        = arena_alloc(arena, sizeof(SDL_Vertex) * 4 * body_count);
+    int *indices = arena_alloc(arena, sizeof(int) * 6 * body_count);
+
+    size_t quad_count = 0;
+    for (size_t i = 0; i < list_size(graphics->body_groups); i++) {
+        list_t *bodies = list_get(graphics->body_groups, i);
+        for (size_t j = 0; j < list_size(bodies); j++) {
+            body_t *body = list_get(bodies, j);
+            body_interpolate(body, alpha);
+            gfx_aux_t *gfx_aux = body_get_gfx(body);
+            if (gfx_aux != NULL && !ALWAYS_RENDER_SHAPE
+                && sprite_get_quad(gfx_aux_get_sprite(gfx_aux),
+                                   vertices + 4 * quad_count)) {
+                quad_count++;
+                continue;
+            }
+            // Keep the drawing order: anything batched so far goes first.
+            _graphics_flush_quads(graphics, vertices, indices, quad_count);
+            quad_count = 0;
+            sdl_render_body(body);
+        }
+    }
+    _graphics_flush_quads(graphics, vertices, indices, quad_count);
+}
+
+void _graphics_flush_quads(graphics_t *graphics,
+                           SDL_Vertex *vertices,
+                           int *indices,
+                           size_t quad_count) {
+    if (quad_count == 0) {
+        return;
+    }
+    // Two triangles per quad, split along the top left to bottom right
+    // diagonal.
+    const int quad_indices[6] = {0, 1, 2, 0, 2, 3};
+    for (size_t i = 0; i < quad_count; i++) {
+        for (size_t k = 0; k < 6; k++) {
+            indices[6 * i + k] = 4 * i + quad_indices[k];
+        }
+    }
+    SDL_Renderer *renderer = sdl_get_renderer();
+    SDL_RenderGeometry(renderer,
+                       atlas_get_texture(graphics->atlas, renderer),
+                       vertices,
+                       4 * quad_count,
+                       indices,
+                       6 * quad_count);
+}
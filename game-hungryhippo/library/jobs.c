@@ -0,0 +1,159 @@
+#include "jobs.h"
+#include "thread_pool.h"
+#include <assert.h>
+#include <stdint.h>
+
+// MSVC has neither C11 atomics nor aligned_alloc, but its pools only have one
+// thread (see thread_pool.h), so a plain word in a plain allocation will do.
+#ifdef _WIN32
+typedef uint64_t _jobs_range_t;
+#define _JOBS_ALIGNAS(alignment)
+#define _jobs_aligned_alloc(alignment, size) malloc(size)
+#define atomic_init(range, value) (*(range) = (value))
+#define atomic_store(range, value) (*(range) = (value))
+#define atomic_load(range) (*(range))
+#define atomic_compare_exchange_weak(range, expected, desired)                 \
+    (*(range) == *(expected) ? (*(range) = (desired), true)                    \
+                             : (*(expected) = *(range), false))
+#else
+#include <stdalign.h>
+#include <stdatomic.h>
+typedef _Atomic uint64_t _jobs_range_t;
+#define _JOBS_ALIGNAS(alignment) alignas(alignment)
+#define _jobs_aligned_alloc(alignment, size) aligned_alloc(alignment, size)
+#endif
+
+/*** PRIVATE CONSTS ***/
+#define _JOBS_CACHE_LINE 64
+
+/*** STRUCTURES ***/
+
+/**
+ * The chunks a thread has yet to start, [begin, end), packed into one word
+ * (begin in the low half) so that the owner can take from the front and
+ * thieves from the back with a compare-and-swap, without locks. On a line of
+ * its own so that threads taking chunks don't slow each other down.
+ */
+typedef struct _jobs_queue {
+    _JOBS_ALIGNAS(_JOBS_CACHE_LINE) _jobs_range_t range;
+} _jobs_queue_t;
+
+struct jobs {
+    thread_pool_t *pool;
+    _jobs_queue_t *queues; // One per thread.
+    // The current loop.
+    size_t count;
+    size_t chunk_size;
+    bool deterministic;
+    jobs_func_t func;
+    void *aux;
+};
+
+/*** PRIVATE PROTOTYPES ***/
+
+/**
+ * Take a chunk from the front of a queue, if 'front', else from the back, and
+ * write it into 'chunk'. Return false if the queue is empty.
+ */
+bool _jobs_take(_jobs_queue_t *queue, bool front, size_t *chunk);
+
+void _jobs_run_chunk(jobs_t *jobs, size_t chunk, size_t thread_idx);
+
+/**
+ * What each thread of the pool does for a loop: its own chunks, then other
+ * threads' if allowed.
+ */
+void _jobs_work(jobs_t *jobs, size_t thread_idx, size_t thread_count);
+
+/*** DEFINITIONS ***/
+
+jobs_t *jobs_init(thread_pool_t *pool) {
+    jobs_t *jobs = malloc(sizeof(jobs_t));
+    assert(jobs != NULL);
+    jobs->pool = pool;
+    size_t thread_count = thread_pool_size(pool);
+    jobs->queues
+        = _jobs_aligned_alloc(_JOBS_CACHE_LINE,
+                              thread_count * sizeof(_jobs_queue_t));
+    assert(jobs->queues != NULL);
+    for (size_t i = 0; i < thread_count; i++) {
+        atomic_init(&jobs->queues[i].range, 0);
+    }
+    return jobs;
+}
+
+void jobs_free(jobs_t *jobs) {
+    free(jobs->queues);
+    free(jobs);
+}
+
+void jobs_for(jobs_t *jobs,
+              size_t count,
+              size_t chunk_size,
+              bool deterministic,
+              jobs_func_t func,
+              void *aux) {
+    assert(chunk_size > 0);
+    size_t chunk_count = (count + chunk_size - 1) / chunk_size;
+    assert(chunk_count <= UINT32_MAX);
+    if (chunk_count == 0) {
+        return;
+    }
+    jobs->count = count;
+    jobs->chunk_size = chunk_size;
+    jobs->deterministic = deterministic;
+    jobs->func = func;
+    jobs->aux = aux;
+    size_t thread_count = thread_pool_size(jobs->pool);
+    for (size_t i = 0; i < thread_count; i++) {
+        uint64_t begin = chunk_count * i / thread_count;
+        uint64_t end = chunk_count * (i + 1) / thread_count;
+        atomic_store(&jobs->queues[i].range, begin | end << 32);
+    }
+    thread_pool_run(jobs->pool, (thread_pool_func_t)_jobs_work, jobs);
+}
+
+bool _jobs_take(_jobs_queue_t *queue, bool front, size_t *chunk) {
+    uint64_t range = atomic_load(&queue->range);
+    while (true) {
+        uint64_t begin = range & UINT32_MAX;
+        uint64_t end = range >> 32;
+        if (begin >= end) {
+            return false;
+        }
+        uint64_t taken
+            = front ? (begin + 1) | end << 32 : begin | (end - 1) << 32;
+        // On failure, this reloads 'range' for another go.
+        if (atomic_compare_exchange_weak(&queue->range, &range, taken)) {
+            *chunk = front ? begin : end - 1;
+            return true;
+        }
+    }
+}
+
+void _jobs_run_chunk(jobs_t *jobs, size_t chunk, size_t thread_idx) {
+    size_t start = chunk * jobs->chunk_size;
+    size_t end = start + jobs->chunk_size;
+    if (end > jobs->count) {
+        end = jobs->count;
+    }
+    jobs->func(jobs->aux, start, end, thread_idx);
+}
+
+void _jobs_work(jobs_t *jobs, size_t thread_idx, size_t thread_count) {
+    size_t chunk;
+    while (_jobs_take(&jobs->queues[thread_idx], true, &chunk)) {
+        _jobs_run_chunk(jobs, chunk, thread_idx);
+    }
+    if (jobs->deterministic) {
+        return;
+    }
+    // Nothing is ever added to a queue during a loop, so one pass over the
+    // others, emptying each in turn, leaves nothing behind.
+    for (size_t i = 1; i < thread_count; i++) {
+        _jobs_queue_t *victim = &jobs->queues[(thread_idx + i) % thread_count];
+        while (_jobs_take(victim, false, &chunk)) {
+            _jobs_run_chunk(jobs, chunk, thread_idx);
+        }
+    }
+}
@@ -1,4 +1,5 @@
 #include "list.h"
+#include "alloc_stats.h"
 #include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -31,6 +32,9 @@ list_t *list_init(size_t initial_size, free_func_t freer) {
     l->capacity = initial_size;
     l->elements = calloc(initial_size, sizeof(void *));
     assert(l->elements != NULL);
+    ALLOC_STATS_ALLOC(LIST, sizeof(list_t));
+    ALLOC_STATS_ALLOC(LIST, initial_size * sizeof(void *));
+    ALLOC_STATS_CREATE(LIST);
 
     l->freer = freer;
 
@@ -69,6 +73,7 @@ void list_free(list_t *list) {
     }
     free(list->elements);
     free(list);
+    ALLOC_STATS_DESTROY(LIST);
 }
 
 size_t list_size(const list_t *list) {
@@ -113,6 +118,7 @@ void list_resize_if_needed(list_t *list) {
 
         void **new_elems = malloc(sizeof(void *) * new_capacity);
         assert(new_elems != NULL);
+        ALLOC_STATS_ALLOC(LIST, sizeof(void *) * new_capacity);
 
         memcpy(new_elems, list->elements, list_size(list) * sizeof(void *));
         free(list->elements);
@@ -33,7 +33,9 @@ void hippo_movement_side(body_t *hippo,
             < fabs(vec_angle_between(initial_position,
                                      center_hippo,
                                      center_world)))) {
-        body_set_centroid(hippo, proposed_new_centroid);
+        // Moved rather than set, so that it is drawn moving.
+        body_translate(hippo,
+                       vec_subtract(proposed_new_centroid, center_hippo));
         body_rotate(hippo, small_angle);
     }
 }
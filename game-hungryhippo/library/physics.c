@@ -1,16 +1,41 @@
 #include "physics.h"
 #include "body.h"
+#include "collision.h"
 #include "forces.h"
+#include "jobs.h"
 #include "list.h"
+#include "polygon.h"
+#include "profiler.h"
+#include "sweep_prune.h"
+#include "thread_pool.h"
 #include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
 
+/*** PRIVATE CONSTS ***/
+// Loop iterations per job. Big enough that taking a job costs little next to
+// running it, small enough to leave something to steal.
+const size_t _PHYSICS_FORCE_CHUNK = 64;
+const size_t _PHYSICS_INTEGRATE_CHUNK = 32;
+
 /*** STRUCTURES ***/
 
 struct physics {
     list_t *body_groups;
     list_t *force_trackers;
+    list_t *collision_rules;
+    thread_pool_t *pool;      // NULL if everything runs on the caller.
+    jobs_t *jobs;             // On the pool, if any.
+    body_force_log_t **force_logs; // One per thread but the first.
+    // This tick's parallel force trackers, in the order they are run.
+    struct _force_tracker **parallel;
+    size_t n_parallel;
+    size_t parallel_capacity;
+    // This tick's bodies and time step, for integrating on the pool.
+    body_t **bodies;
+    size_t n_bodies;
+    size_t bodies_capacity;
+    double dt;
 };
 
 /**
@@ -22,8 +47,29 @@ typedef struct _force_tracker {
     free_func_t freer;
     void *aux;
     list_t *bodies; // Which bodies associated with this force creator.
+    // Handles to the bodies, to notice when any of them has been freed
+    // without touching freed memory.
+    body_handle_t *handles;
+    bool parallel; // Whether it may run alongside others on another thread.
 } _force_tracker_t;
 
+/**
+ * Private struct to keep track of a collision rule between two groups, along
+ * with its broad phase. The broad phase keeps a flag with each pair of bodies
+ * whose boxes overlap, which is whether they were touching on the last tick,
+ * so that the handler is only called once per contact.
+ */
+typedef struct _collision_rule {
+    list_t *group1;
+    list_t *group2;
+    shape_getter_t getter1;
+    shape_getter_t getter2;
+    collision_handler_t handler;
+    void *aux;
+    free_func_t aux_freer;
+    sweep_prune_t *sweep_prune; // Kept between ticks.
+} _collision_rule_t;
+
 /*** PRIVATE FUNCTION PROTOTYPES ***/
 
 /**
@@ -46,7 +92,76 @@ void _force_tracker_free(_force_tracker_t *fa);
 bool _force_tracker_is_removed(_force_tracker_t *fa);
 
 /**
- * Collect garbage, i.e. remove any forces whose bodies have been marked for it.
+ * Init a collision rule.
+ */
+_collision_rule_t *_collision_rule_init(list_t *group1,
+                                        list_t *group2,
+                                        shape_getter_t getter1,
+                                        shape_getter_t getter2,
+                                        collision_handler_t handler,
+                                        void *aux,
+                                        free_func_t aux_freer);
+
+/**
+ * Free a collision rule and its aux but not its groups.
+ */
+void _collision_rule_free(_collision_rule_t *rule);
+
+/**
+ * Sync every body of group that is not marked for removal with the broad phase
+ * on the given side.
+ */
+void _physics_sync_group(sweep_prune_t *sweep_prune,
+                         list_t *group,
+                         shape_getter_t getter,
+                         size_t side);
+
+/**
+ * Run the narrow phase on a candidate pair found by the broad phase, calling
+ * the rule's handler if the pair has just started touching. 'touching' is
+ * whether it was touching on the last tick, and becomes whether it is now.
+ */
+void _physics_narrow_phase(body_t *body1,
+                           body_t *body2,
+                           bool *touching,
+                           _collision_rule_t *rule);
+
+/**
+ * Find every pair of touching bodies under the given rule.
+ */
+void _physics_tick_collision_rule(physics_t *physics, _collision_rule_t *rule);
+
+/**
+ * Run the force creators, the parallel ones first, each in reverse order of
+ * addition.
+ */
+void _physics_tick_forces(physics_t *physics);
+
+/**
+ * Run this tick's parallel force creators [start, end) on the given thread,
+ * adding the forces found on any thread but the first to the thread's log.
+ */
+void _physics_force_worker(physics_t *physics,
+                           size_t start,
+                           size_t end,
+                           size_t thread_idx);
+
+/**
+ * Tick every body in every group.
+ */
+void _physics_tick_bodies(physics_t *physics, double dt);
+
+/**
+ * Tick this tick's bodies [start, end) and transform their shapes.
+ */
+void _physics_integrate_worker(physics_t *physics,
+                               size_t start,
+                               size_t end,
+                               size_t thread_idx);
+
+/**
+ * Collect garbage, i.e. remove any forces whose bodies have been marked for it
+ * or freed.
  */
 void _physics_collect_garbage(physics_t *physics);
 
@@ -58,11 +173,17 @@ _force_tracker_t *_force_tracker_init(force_creator_t force_creator,
                                       list_t *bodies) {
     _force_tracker_t *fa = malloc(sizeof(_force_tracker_t));
     assert(fa != NULL);
+    fa->parallel = false;
 
     fa->force_creator = force_creator;
     fa->freer = aux_freer;
     fa->aux = aux;
     fa->bodies = bodies;
+    fa->handles = malloc(list_size(bodies) * sizeof(body_handle_t));
+    assert(fa->handles != NULL || list_size(bodies) == 0);
+    for (size_t i = 0; i < list_size(bodies); i++) {
+        fa->handles[i] = body_get_handle(list_get(bodies, i));
+    }
 
     return fa;
 }
@@ -72,32 +193,108 @@ void _force_tracker_free(_force_tracker_t *fa) {
         fa->freer(fa->aux);
     }
     list_free(fa->bodies);
+    free(fa->handles);
     free(fa);
 }
 
 bool _force_tracker_is_removed(_force_tracker_t *fa) {
     for (size_t i = 0; i < list_size(fa->bodies); i++) {
-        if (body_is_removed(list_get(fa->bodies, i))) {
+        body_t *body = body_handle_get(fa->handles[i]);
+        if (body == NULL || body_is_removed(body)) {
             return true;
         }
     }
     return false;
 }
 
+_collision_rule_t *_collision_rule_init(list_t *group1,
+                                        list_t *group2,
+                                        shape_getter_t getter1,
+                                        shape_getter_t getter2,
+                                        collision_handler_t handler,
+                                        void *aux,
+                                        free_func_t aux_freer) {
+    _collision_rule_t *rule = malloc(sizeof(_collision_rule_t));
+    assert(rule != NULL);
+
+    rule->group1 = group1;
+    rule->group2 = group2;
+    rule->getter1 = getter1 != NULL ? getter1 : body_get_shape_nocp;
+    rule->getter2 = getter2 != NULL ? getter2 : body_get_shape_nocp;
+    rule->handler = handler;
+    rule->aux = aux;
+    rule->aux_freer = aux_freer;
+    rule->sweep_prune = sweep_prune_init(group1 == group2);
+
+    return rule;
+}
+
+void _collision_rule_free(_collision_rule_t *rule) {
+    if (rule->aux_freer != NULL && rule->aux != NULL) {
+        rule->aux_freer(rule->aux);
+    }
+    sweep_prune_free(rule->sweep_prune);
+    free(rule);
+}
+
 physics_t *physics_init(void) {
     physics_t *physics = malloc(sizeof(physics_t));
     assert(physics != NULL);
     physics->body_groups = list_init(1, NULL);
     physics->force_trackers = list_init(1, (free_func_t)_force_tracker_free);
+    physics->collision_rules = list_init(1, (free_func_t)_collision_rule_free);
+    physics->pool = NULL;
+    physics->jobs = NULL;
+    physics->force_logs = NULL;
+    physics->parallel_capacity = 1;
+    physics->parallel = malloc(sizeof(_force_tracker_t *));
+    assert(physics->parallel != NULL);
+    physics->n_parallel = 0;
+    physics->bodies_capacity = 1;
+    physics->bodies = malloc(sizeof(body_t *));
+    assert(physics->bodies != NULL);
+    physics->n_bodies = 0;
+    physics->dt = 0;
     return physics;
 }
 
 void physics_free(physics_t *physics) {
+    physics_set_threads(physics, 1);
     list_free(physics->body_groups);
     list_free(physics->force_trackers);
+    list_free(physics->collision_rules);
+    free(physics->parallel);
+    free(physics->bodies);
     free(physics);
 }
 
+void physics_set_threads(physics_t *physics, size_t thread_count) {
+    assert(thread_count > 0);
+    if (physics->pool != NULL) {
+        for (size_t i = 0; i < thread_pool_size(physics->pool) - 1; i++) {
+            body_force_log_free(physics->force_logs[i]);
+        }
+        free(physics->force_logs);
+        jobs_free(physics->jobs);
+        thread_pool_free(physics->pool);
+        physics->force_logs = NULL;
+        physics->jobs = NULL;
+        physics->pool = NULL;
+    }
+    if (thread_count > 1) {
+        physics->pool = thread_pool_init(thread_count);
+        // Pools may have fewer threads than asked for (see thread_pool.h).
+        thread_count = thread_pool_size(physics->pool);
+        physics->jobs = jobs_init(physics->pool);
+        physics->force_logs
+            = malloc((thread_count - 1) * sizeof(body_force_log_t *));
+        assert(physics->force_logs != NULL || thread_count == 1);
+        for (size_t i = 0; i < thread_count - 1; i++) {
+            physics->force_logs[i] = body_force_log_init();
+        }
+    }
+}
+
 void physics_add_bodies(physics_t *physics, list_t *bodies) {
     assert(bodies != NULL);
     list_add(physics->body_groups, bodies);
@@ -112,23 +309,225 @@ void physics_add_force(physics_t *physics,
              _force_tracker_init(forcer, freer, aux, bodies));
 }
 
+void physics_add_parallel_force(physics_t *physics,
+                                force_creator_t forcer,
+                                void *aux,
+                                list_t *bodies,
+                                free_func_t freer) {
+    _force_tracker_t *fa = _force_tracker_init(forcer, freer, aux, bodies);
+    fa->parallel = true;
+    list_add(physics->force_trackers, fa);
+}
+
+void physics_add_collision_rule(physics_t *physics,
+                                list_t *group1,
+                                list_t *group2,
+                                shape_getter_t getter1,
+                                shape_getter_t getter2,
+                                collision_handler_t handler,
+                                void *aux,
+                                free_func_t aux_freer) {
+    assert(group1 != NULL && group2 != NULL);
+    list_add(physics->collision_rules,
+             _collision_rule_init(group1,
+                                  group2,
+                                  getter1,
+                                  getter2,
+                                  handler,
+                                  aux,
+                                  aux_freer));
+}
+
+void _physics_sync_group(sweep_prune_t *sweep_prune,
+                         list_t *group,
+                         shape_getter_t getter,
+                         size_t side) {
+    for (size_t i = 0; i < list_size(group); i++) {
+        body_t *body = list_get(group, i);
+        if (!body_is_removed(body)) {
+            // Keyed by generation, so that a new body in a freed body's slot
+            // doesn't inherit its contacts.
+            sweep_prune_sync(sweep_prune,
+                             body,
+                             body_get_handle(body).generation,
+                             polygon_aabb(getter(body)),
+                             side);
+        }
+    }
+}
+
+void _physics_narrow_phase(body_t *body1,
+                           body_t *body2,
+                           bool *touching,
+                           _collision_rule_t *rule) {
+    bool was_touching = *touching;
+    *touching = false;
+    // An earlier handler this tick may have removed one of them.
+    if (body_is_removed(body1) || body_is_removed(body2)) {
+        return;
+    }
+    // The boxes overlap, but e.g. round shapes meeting corner to corner may
+    // still be ruled out by their bounding circles.
+    polygon_t *shape1 = rule->getter1(body1);
+    polygon_t *shape2 = rule->getter2(body2);
+    if (!polygon_bounds_overlap(shape1, shape2)) {
+        return;
+    }
+    collision_info_t c_info = find_collision(shape1, shape2);
+    *touching = c_info.collided;
+    if (c_info.collided && !was_touching) {
+        rule->handler(body1,
+                      body2,
+                      c_info.axis,
+                      c_info.collision_point,
+                      rule->aux);
+    }
+}
+
+void _physics_tick_collision_rule(physics_t *physics, _collision_rule_t *rule) {
+    sweep_prune_t *sweep_prune = rule->sweep_prune;
+    sweep_prune_begin(sweep_prune);
+    _physics_sync_group(sweep_prune, rule->group1, rule->getter1, 0);
+    if (rule->group1 != rule->group2) {
+        _physics_sync_group(sweep_prune, rule->group2, rule->getter2, 1);
+    }
+    sweep_prune_update(sweep_prune, NULL, NULL);
+    sweep_prune_for_each_pair(sweep_prune,
+                              (sweep_prune_pair_func_t)_physics_narrow_phase,
+                              rule);
+}
+
 void physics_tick(physics_t *physics, double dt) {
+    PROFILE_BEGIN(PHYSICS);
+    // Collect garbage first, since bodies may have been freed since last tick.
+    PROFILE_BEGIN(PHYSICS_GC);
+    _physics_collect_garbage(physics);
+    PROFILE_END(PHYSICS_GC);
     // Tick forces
+    PROFILE_BEGIN(PHYSICS_FORCES);
+    _physics_tick_forces(physics);
+    PROFILE_END(PHYSICS_FORCES);
+    // Tick collision rules.
+    PROFILE_BEGIN(PHYSICS_COLLISIONS);
+    for (size_t i = 0; i < list_size(physics->collision_rules); i++) {
+        _physics_tick_collision_rule(physics,
+                                     list_get(physics->collision_rules, i));
+    }
+    PROFILE_END(PHYSICS_COLLISIONS);
+    // Tick bodies.
+    PROFILE_BEGIN(PHYSICS_INTEGRATE);
+    _physics_tick_bodies(physics, dt);
+    PROFILE_END(PHYSICS_INTEGRATE);
+    PROFILE_END(PHYSICS);
+}
+
+void _physics_tick_forces(physics_t *physics) {
     list_t *fas = physics->force_trackers;
-    _force_tracker_t *fa_curr;
+    physics->n_parallel = 0;
     for (int i = list_size(fas) - 1; i >= 0; i--) {
-        fa_curr = list_get(fas, i);
-        fa_curr->force_creator(fa_curr->aux);
+        _force_tracker_t *fa = list_get(fas, i);
+        if (!fa->parallel) {
+            continue;
+        }
+        if (physics->n_parallel == physics->parallel_capacity) {
+            physics->parallel_capacity *= 2;
+            physics->parallel
+                = realloc(physics->parallel,
+                          physics->parallel_capacity
+                              * sizeof(_force_tracker_t *));
+            assert(physics->parallel != NULL);
+        }
+        physics->parallel[physics->n_parallel++] = fa;
     }
-    // Tick bodies.
+
+    if (physics->pool == NULL) {
+        _physics_force_worker(physics, 0, physics->n_parallel, 0);
+    } else {
+        jobs_for(physics->jobs,
+                 physics->n_parallel,
+                 _PHYSICS_FORCE_CHUNK,
+                 true,
+                 (jobs_func_t)_physics_force_worker,
+                 physics);
+        // Each thread took the next share in order, so adding up the logs in
+        // order gives the same sums as a single thread would, bit for bit.
+        for (size_t i = 0; i < thread_pool_size(physics->pool) - 1; i++) {
+            body_force_log_apply(physics->force_logs[i]);
+        }
+    }
+
+    for (int i = list_size(fas) - 1; i >= 0; i--) {
+        _force_tracker_t *fa = list_get(fas, i);
+        if (!fa->parallel) {
+            fa->force_creator(fa->aux);
+        }
+    }
+}
+
+void _physics_force_worker(physics_t *physics,
+                           size_t start,
+                           size_t end,
+                           size_t thread_idx) {
+    // The first share is added before any other, so it can go straight to the
+    // bodies, whose forces and impulses no other thread reads.
+    if (thread_idx > 0) {
+        body_set_force_log(physics->force_logs[thread_idx - 1]);
+    }
+    for (size_t i = start; i < end; i++) {
+        _force_tracker_t *fa = physics->parallel[i];
+        fa->force_creator(fa->aux);
+    }
+    if (thread_idx > 0) {
+        body_set_force_log(NULL);
+    }
+}
+
+void _physics_tick_bodies(physics_t *physics, double dt) {
+    if (physics->pool == NULL) {
+        for (int i = 0; i < list_size(physics->body_groups); i++) {
+            list_t *bodies = list_get(physics->body_groups, i);
+            for (int j = list_size(bodies) - 1; j >= 0; j--) {
+                body_tick(list_get(bodies, j), dt);
+            }
+        }
+        return;
+    }
+
+    physics->n_bodies = 0;
     for (int i = 0; i < list_size(physics->body_groups); i++) {
         list_t *bodies = list_get(physics->body_groups, i);
         for (int j = list_size(bodies) - 1; j >= 0; j--) {
-            body_tick(list_get(bodies, j), dt);
+            if (physics->n_bodies == physics->bodies_capacity) {
+                physics->bodies_capacity *= 2;
+                physics->bodies
+                    = realloc(physics->bodies,
+                              physics->bodies_capacity * sizeof(body_t *));
+                assert(physics->bodies != NULL);
+            }
+            physics->bodies[physics->n_bodies++] = list_get(bodies, j);
         }
     }
-    // Collect garbage.
-    _physics_collect_garbage(physics);
+    // Each body's tick only touches that body, so it makes no difference
+    // which thread ticks it when, and chunks can be stolen freely.
+    physics->dt = dt;
+    jobs_for(physics->jobs,
+             physics->n_bodies,
+             _PHYSICS_INTEGRATE_CHUNK,
+             false,
+             (jobs_func_t)_physics_integrate_worker,
+             physics);
+}
+
+void _physics_integrate_worker(physics_t *physics,
+                               size_t start,
+                               size_t end,
+                               size_t thread_idx) {
+    for (size_t i = start; i < end; i++) {
+        body_t *body = physics->bodies[i];
+        body_tick(body, physics->dt);
+        // Collision checks and drawing would only do this one by one later.
+        body_update_shapes(body);
+    }
 }
 
 void _physics_collect_garbage(physics_t *physics) {
@@ -2,6 +2,7 @@
 #include "ehhh.h"
 #include "polygon.h"
 #include "sdl_wrapper.h"
+#include "shape_template.h"
 #include "sprite.h"
 #include "text.h"
 #include <SDL2/SDL_ttf.h>
@@ -44,9 +45,9 @@ const double PLAYER_DEFAULT_SHOOT_SPEED = 500;
 body_t *player_make_player_body(player_t *player, size_t idx);
 
 // Table column functions.
-char *_player_tab_idx_col(body_t *player_body);
-char *_player_tab_points_col(body_t *player_body);
-char *_player_tab_powerups_col(body_t *player_body);
+void _player_tab_idx_col(body_t *player_body, char *buf, size_t size);
+void _player_tab_points_col(body_t *player_body, char *buf, size_t size);
+void _player_tab_powerups_col(body_t *player_body, char *buf, size_t size);
 
 /*** STRUCTS WITH PRIVATE FIELDS ***/
 struct player {
@@ -54,8 +55,6 @@ struct player {
     player_state_e state;
 
     body_t *body;
-    list_t **hippo_body_shape;
-    list_t **hippo_mouth_shape;
     vector_t origin;
 
     list_t *powerups;
@@ -79,13 +78,6 @@ player_t *player_init(size_t idx, vector_t origin) {
     body_set_centroid(player->body, origin);
     player->origin = origin;
 
-    player->hippo_body_shape = malloc(sizeof(list_t *));
-    player->hippo_mouth_shape = malloc(sizeof(list_t *));
-    *(player->hippo_body_shape)
-        = body_get_shape_alt(player->body, PLAYER_HIPPO_BODY_NOT_EATING_IDX);
-    *(player->hippo_mouth_shape)
-        = body_get_shape_alt(player->body, PLAYER_HIPPO_MOUTH_IDX);
-
     player->powerups = list_init(1, (free_func_t)powerup_free);
     player->powerup_idx = 0;
     player->points = 0;
@@ -99,8 +91,6 @@ player_t *player_init(size_t idx, vector_t origin) {
 
 void player_free(player_t *player) {
     list_free(player->powerups);
-    free(player->hippo_body_shape);
-    free(player->hippo_mouth_shape);
     free(player);
 }
 
@@ -136,16 +126,10 @@ void player_set_state(player_t *player, player_state_e state) {
     player->state = state;
     switch (state) {
     case PLAYER_EATING:
-        *player->hippo_body_shape
-            = body_get_shape_alt(player_get_body(player),
-                                 PLAYER_HIPPO_BODY_EATING_IDX);
         body_set_shape_main(player->body, PLAYER_HIPPO_BODY_EATING_IDX);
         gfx_aux_set_sprite(body_get_gfx(player->body), PLAYER_SPRITE_EATING);
         break;
     case PLAYER_CHILLING:
-        *player->hippo_body_shape
-            = body_get_shape_alt(player_get_body(player),
-                                 PLAYER_HIPPO_BODY_NOT_EATING_IDX);
         body_set_shape_main(player->body, PLAYER_HIPPO_BODY_NOT_EATING_IDX);
         gfx_aux_set_sprite(body_get_gfx(player->body), PLAYER_SPRITE_CHILLING);
         break;
@@ -202,12 +186,12 @@ void player_remove(player_t *player) {
     body_remove(player_get_body(player));
 }
 
-list_t **player_get_hippo_body_shape(player_t *player) {
-    return player->hippo_body_shape;
+polygon_t *player_get_hippo_body_shape(player_t *player) {
+    return body_get_shape_main(player->body);
 }
 
-list_t **player_get_hippo_mouth_shape(player_t *player) {
-    return player->hippo_mouth_shape;
+polygon_t *player_get_hippo_mouth_shape(player_t *player) {
+    return body_get_shape_alt(player->body, PLAYER_HIPPO_MOUTH_IDX);
 }
 
 bool player_is_eating(player_t *player) {
@@ -244,8 +228,7 @@ double player_get_angle_modifier(player_t *player) {
 
 vector_t player_get_shoot_location(player_t *player, ehhh_t *ehhh) {
     vector_t a_center = ehhh_get_center(ehhh);
-    vector_t b_center
-        = polygon_centroid(*(player_get_hippo_mouth_shape(player)));
+    vector_t b_center = polygon_centroid(player_get_hippo_mouth_shape(player));
 
     vector_t p = vec_normalize(vec_subtract(a_center, b_center));
 
@@ -289,53 +272,50 @@ text_tab_t *player_create_tab(list_t *player_bodies, vector_t topleft) {
 
 /*** DEFINITIONS OF PRIVATE FUNCTIONS ***/
 
-char *_player_tab_idx_col(body_t *player_body) {
+void _player_tab_idx_col(body_t *player_body, char *buf, size_t size) {
     player_t *player = body_get_info(player_body);
-    const char *fmt = "P%1zu";
-    char *s = calloc(strlen(fmt) + /*idx*/ 1 + /*'\0'*/ 1, sizeof(char));
-    if (sprintf(s, fmt, player_get_idx(player)) < 0) {
+    if (snprintf(buf, size, "P%1zu", player_get_idx(player)) < 0) {
         fprintf(stderr,
-                "player.c: _player_tab_idx_col: Error calling sprintf.\n");
+                "player.c: _player_tab_idx_col: Error calling snprintf.\n");
         exit(1);
     }
-    return s;
 }
 
-char *_player_tab_points_col(body_t *player_body) {
+void _player_tab_points_col(body_t *player_body, char *buf, size_t size) {
     player_t *player = body_get_info(player_body);
     short points = player_get_points(player);
     // We assume max 9999 points.
     if (points > _MAX_POINTS) {
         points = _MAX_POINTS;
     }
-    const char *fmt = "%0+5hd";
-    char *s = calloc(strlen(fmt) + /*+points*/ 6 + /*'\0'*/ 1, sizeof(char));
-    if (sprintf(s, fmt, player_get_points(player)) < 0) {
+    if (snprintf(buf, size, "%0+5hd", player_get_points(player)) < 0) {
         fprintf(stderr,
-                "player.c: _player_tab_points_col: Error calling sprintf.\n");
+                "player.c: _player_tab_points_col: Error calling snprintf.\n");
         exit(1);
     }
-    return s;
 }
 
-char *_player_tab_powerups_col(body_t *player_body) {
+void _player_tab_powerups_col(body_t *player_body, char *buf, size_t size) {
     player_t *player = body_get_info(player_body);
     size_t pu_count = list_size(player_get_powerups(player));
     size_t pu_idx = player_get_powerup_idx(player);
-    char *pu_str = powerup_str(player_get_powerup(player, pu_idx));
+    char pu_str[TEXT_CELL_SIZE];
+    powerup_str(player_get_powerup(player, pu_idx), pu_str, sizeof(pu_str));
     if (pu_count > _MAX_POWERUPS) {
         pu_count = _MAX_POWERUPS;
     }
-    const char *fmt = "%zu/%zu>%s";
-    char *s = calloc(strlen(fmt) + /*#/#>*/ 10 + strlen(pu_str) + /*'\0'*/ 1,
-                     sizeof(char));
-    if (sprintf(s, fmt, pu_count == 0 ? 0 : pu_idx + 1, pu_count, pu_str) < 0) {
+    if (snprintf(buf,
+                 size,
+                 "%zu/%zu>%s",
+                 pu_count == 0 ? 0 : pu_idx + 1,
+                 pu_count,
+                 pu_str)
+        < 0) {
         fprintf(stderr,
-                "player.c: _player_tab_powerups_col: Error calling sprintf.\n");
+                "player.c: _player_tab_powerups_col: "
+                "Error calling snprintf.\n");
         exit(1);
     }
-    free(pu_str);
-    return s;
 }
 
 body_t *player_make_player_body(player_t *player, size_t idx) {
@@ -348,24 +328,22 @@ body_t *player_make_player_body(player_t *player, size_t idx) {
     // Initialize so that the hippo's head points due north.
 
     // Chilling body
-    list_t *bd_chilling
-        = polygon_init_from_path(PLAYER_PATH_SHAPE_CHILLING_BODY);
-    polygon_scr_to_sce(bd_chilling);
-    polygon_scale(bd_chilling, PLAYER_GFX_SCALE);
+    polygon_t *bd_chilling
+        = shape_template_init_scr(PLAYER_PATH_SHAPE_CHILLING_BODY,
+                                  PLAYER_GFX_SCALE);
 
     // Eating body
-    list_t *bd_eating = polygon_init_from_path(PLAYER_PATH_SHAPE_EATING_BODY);
-    polygon_scr_to_sce(bd_eating);
-    polygon_scale(bd_eating, PLAYER_GFX_SCALE);
+    polygon_t *bd_eating
+        = shape_template_init_scr(PLAYER_PATH_SHAPE_EATING_BODY,
+                                  PLAYER_GFX_SCALE);
     // Flush botright with chilling body.
     polygon_translate(bd_eating,
                       vec_subtract(polygon_botright(bd_chilling),
                                    polygon_botright(bd_eating)));
 
     // Mouth
-    list_t *m = polygon_init_from_path(PLAYER_PATH_SHAPE_MOUTH);
-    polygon_scr_to_sce(m);
-    polygon_scale(m, PLAYER_GFX_SCALE);
+    polygon_t *m
+        = shape_template_init_scr(PLAYER_PATH_SHAPE_MOUTH, PLAYER_GFX_SCALE);
     // Make mouth flush topleft with eating body.
     polygon_translate(
         m,
@@ -385,7 +363,7 @@ body_t *player_make_player_body(player_t *player, size_t idx) {
     // PLAYER_HIPPO_BODY_NOT_EATING_IDX,
     // PLAYER_HIPPO_BODY_EATING_IDX,
     // PLAYER_HIPPO_MOUTH_IDX,
-    list_t *shapes = list_init(PLAYER_NUM_SHAPES, (free_func_t)list_free);
+    list_t *shapes = list_init(PLAYER_NUM_SHAPES, (free_func_t)polygon_free);
     list_add(shapes, bd_chilling);
     list_add(shapes, bd_eating);
     list_add(shapes, m);
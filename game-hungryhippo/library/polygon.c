@@ -1,78 +1,306 @@
 #include "polygon.h"
 #include "sdl_wrapper.h"
+#include <assert.h>
 #include <math.h>
 #include <stdlib.h>
 
+/*** STRUCTURES ***/
+
+struct polygon {
+    size_t size;
+    double radius; // 0 unless the polygon is rounded, e.g. a circle.
+    double *xs;
+    double *ys;
+    vector_t centroid;   // Cached, only meaningful if centroid_valid.
+    bool centroid_valid; // Cleared when the vertices change arbitrarily.
+    // Cached bounds, likewise. The box is kept up to date by translations and
+    // transforms; the bounding radius is about the centroid, so it is kept by
+    // any rigid motion.
+    aabb_t box;
+    bool box_valid;
+    double bounding_radius;
+    bool bounding_radius_valid;
+    double coords[]; // All the xs, then all the ys.
+};
+
 /*** PRIVATE PROTOTYPES ***/
 
+/**
+ * Forget the cached centroid and bounds, e.g. after the vertices have been
+ * changed in a way that doesn't simply move them along with the polygon.
+ */
+void _polygon_invalidate_cache(polygon_t *polygon);
+
+/**
+ * Return the area enclosed by the polygon's vertices, ignoring its radius.
+ */
+double _polygon_vertex_area(polygon_t *polygon);
+
 /*** DEFINITIONS ***/
 
-double polygon_area(list_t *polygon) {
+polygon_t *polygon_init(size_t size) {
+    polygon_t *polygon
+        = calloc(1, sizeof(polygon_t) + 2 * size * sizeof(double));
+    assert(polygon != NULL);
+    polygon->size = size;
+    polygon->xs = polygon->coords;
+    polygon->ys = polygon->coords + size;
+    return polygon;
+}
+
+polygon_t *polygon_init_circle(vector_t center, double radius) {
+    assert(radius > 0);
+    polygon_t *circle = polygon_init(1);
+    polygon_set(circle, 0, center);
+    circle->radius = radius;
+    return circle;
+}
+
+polygon_t *polygon_init_capsule(vector_t end1, vector_t end2, double radius) {
+    assert(radius > 0);
+    polygon_t *capsule = polygon_init(2);
+    polygon_set(capsule, 0, end1);
+    polygon_set(capsule, 1, end2);
+    capsule->radius = radius;
+    return capsule;
+}
+
+polygon_t *polygon_init_from_list(list_t *vertices) {
+    size_t n = list_size(vertices);
+    polygon_t *polygon = polygon_init(n);
+    for (size_t i = 0; i < n; i++) {
+        vector_t *v = list_get(vertices, i);
+        polygon->xs[i] = v->x;
+        polygon->ys[i] = v->y;
+    }
+    return polygon;
+}
+
+list_t *polygon_to_list(polygon_t *polygon) {
+    list_t *vertices = list_init(polygon->size, free);
+    for (size_t i = 0; i < polygon->size; i++) {
+        vector_t *v = malloc(sizeof(vector_t));
+        assert(v != NULL);
+        *v = polygon_get(polygon, i);
+        list_add(vertices, v);
+    }
+    return vertices;
+}
+
+polygon_t *polygon_copy(polygon_t *polygon) {
+    polygon_t *copy = polygon_init(polygon->size);
+    copy->radius = polygon->radius;
+    for (size_t i = 0; i < polygon->size; i++) {
+        copy->xs[i] = polygon->xs[i];
+        copy->ys[i] = polygon->ys[i];
+    }
+    copy->centroid = polygon->centroid;
+    copy->centroid_valid = polygon->centroid_valid;
+    copy->box = polygon->box;
+    copy->box_valid = polygon->box_valid;
+    copy->bounding_radius = polygon->bounding_radius;
+    copy->bounding_radius_valid = polygon->bounding_radius_valid;
+    return copy;
+}
+
+void polygon_free(polygon_t *polygon) {
+    free(polygon);
+}
+
+void _polygon_invalidate_cache(polygon_t *polygon) {
+    polygon->centroid_valid = false;
+    polygon->box_valid = false;
+    polygon->bounding_radius_valid = false;
+}
+
+size_t polygon_size(polygon_t *polygon) {
+    return polygon->size;
+}
+
+double polygon_radius(polygon_t *polygon) {
+    return polygon->radius;
+}
+
+vector_t polygon_get(polygon_t *polygon, size_t idx) {
+    assert(idx < polygon->size);
+    return (vector_t){polygon->xs[idx], polygon->ys[idx]};
+}
+
+void polygon_set(polygon_t *polygon, size_t idx, vector_t vertex) {
+    assert(idx < polygon->size);
+    polygon->xs[idx] = vertex.x;
+    polygon->ys[idx] = vertex.y;
+    _polygon_invalidate_cache(polygon);
+}
+
+const double *polygon_xs(polygon_t *polygon) {
+    return polygon->xs;
+}
+
+const double *polygon_ys(polygon_t *polygon) {
+    return polygon->ys;
+}
+
+void polygon_reverse(polygon_t *polygon) {
+    size_t n = polygon->size;
+    for (size_t i = 0; i < n / 2; i++) {
+        vector_t tmp = polygon_get(polygon, i);
+        polygon_set(polygon, i, polygon_get(polygon, n - 1 - i));
+        polygon_set(polygon, n - 1 - i, tmp);
+    }
+}
+
+double _polygon_vertex_area(polygon_t *polygon) {
     // Compute area using the Shoelace formula.
-    size_t n = list_size(polygon);
+    size_t n = polygon->size;
+    const double *xs = polygon->xs;
+    const double *ys = polygon->ys;
     // Running sum.
     double sum = 0;
     for (size_t i = 0; i < n; i++) {
-        sum += vec_cross(*(vector_t *)list_get(polygon, i),
-                         *(vector_t *)list_get(polygon, (i + 1) % n));
+        size_t j = i + 1 < n ? i + 1 : 0;
+        sum += xs[i] * ys[j] - ys[i] * xs[j];
     }
     // Shoelace formula: A(polygon) = |sum| / 2.
     return fabs(sum) / 2;
 }
 
-vector_t polygon_centroid(list_t *polygon) {
+double polygon_area(polygon_t *polygon) {
+    double area = _polygon_vertex_area(polygon);
+    double r = polygon->radius;
+    if (r == 0) {
+        return area;
+    }
+    // A rounded polygon adds a strip of width r along each edge, plus a sector
+    // at each vertex, which together make up a full circle. (A two vertex
+    // polygon goes along its edge twice, once for each side, so this holds for
+    // capsules too.)
+    double perimeter = 0;
+    for (size_t i = 0; i < polygon->size; i++) {
+        size_t j = i + 1 < polygon->size ? i + 1 : 0;
+        perimeter += hypot(polygon->xs[j] - polygon->xs[i],
+                           polygon->ys[j] - polygon->ys[i]);
+    }
+    return area + perimeter * r + M_PI * r * r;
+}
+
+vector_t polygon_centroid(polygon_t *polygon) {
+    if (polygon->centroid_valid) {
+        return polygon->centroid;
+    }
+    size_t n = polygon->size;
+    const double *xs = polygon->xs;
+    const double *ys = polygon->ys;
+    if (n < 3) {
+        // A circle or capsule, which is symmetric about its middle.
+        polygon->centroid = (vector_t){(xs[0] + xs[n - 1]) / 2,
+                                       (ys[0] + ys[n - 1]) / 2};
+        polygon->centroid_valid = true;
+        return polygon->centroid;
+    }
     // Compute using this formula:
     // https://en.wikipedia.org/wiki/Centroid#Of_a_polygon
-    size_t n = list_size(polygon);
-    double area = polygon_area(polygon);
+    double area = _polygon_vertex_area(polygon);
     double sum_x = 0;
     double sum_y = 0;
     for (size_t i = 0; i < n; i++) {
-        sum_x += (((vector_t *)list_get(polygon, i))->x
-                  + ((vector_t *)list_get(polygon, (i + 1) % n))->x)
-                 * (vec_cross(*(vector_t *)list_get(polygon, i),
-                              *(vector_t *)list_get(polygon, (i + 1) % n)));
-        sum_y += (((vector_t *)list_get(polygon, i))->y
-                  + ((vector_t *)list_get(polygon, (i + 1) % n))->y)
-                 * (vec_cross(*(vector_t *)list_get(polygon, i),
-                              *(vector_t *)list_get(polygon, (i + 1) % n)));
+        size_t j = i + 1 < n ? i + 1 : 0;
+        double cross = xs[i] * ys[j] - ys[i] * xs[j];
+        sum_x += (xs[i] + xs[j]) * cross;
+        sum_y += (ys[i] + ys[j]) * cross;
     }
     vector_t centroid = {.x = sum_x / (6 * area), .y = sum_y / (6 * area)};
+    polygon->centroid = centroid;
+    polygon->centroid_valid = true;
     return centroid;
 }
 
-void polygon_translate(list_t *polygon, vector_t translation) {
-    for (size_t i = 0; i < list_size(polygon); i++) {
-        vector_t *v = list_get(polygon, i);
-        *v = vec_add(*v, translation);
+void polygon_translate(polygon_t *polygon, vector_t translation) {
+    for (size_t i = 0; i < polygon->size; i++) {
+        polygon->xs[i] += translation.x;
+        polygon->ys[i] += translation.y;
     }
+    polygon->centroid = vec_add(polygon->centroid, translation);
+    polygon->box.min = vec_add(polygon->box.min, translation);
+    polygon->box.max = vec_add(polygon->box.max, translation);
 }
 
-void polygon_set_centroid(list_t *polygon, vector_t centroid) {
+void polygon_set_centroid(polygon_t *polygon, vector_t centroid) {
     polygon_translate(polygon,
                       vec_subtract(centroid, polygon_centroid(polygon)));
 }
 
-void polygon_rotate(list_t *polygon, double angle, vector_t point) {
-    for (size_t i = 0; i < list_size(polygon); i++) {
-        vector_t *v = list_get(polygon, i);
-        *v = vec_rotate_relative(*v, angle, point);
+void polygon_rotate(polygon_t *polygon, double angle, vector_t point) {
+    // Same as vec_rotate_relative on each vertex, but only computing the
+    // trigonometry once.
+    double c = cos(angle);
+    double s = sin(angle);
+    for (size_t i = 0; i < polygon->size; i++) {
+        double dx = polygon->xs[i] - point.x;
+        double dy = polygon->ys[i] - point.y;
+        polygon->xs[i] = point.x + c * dx - s * dy;
+        polygon->ys[i] = point.y + s * dx + c * dy;
+    }
+    vector_t d = vec_subtract(polygon->centroid, point);
+    polygon->centroid = (vector_t){point.x + c * d.x - s * d.y,
+                                   point.y + s * d.x + c * d.y};
+    polygon->box_valid = false;
+}
+
+void polygon_transform(polygon_t *dst,
+                       polygon_t *src,
+                       double angle,
+                       vector_t translation) {
+    assert(dst->size == src->size && src->size > 0);
+    dst->radius = src->radius;
+    // Carried along like the centroid below, so it is only ever computed once
+    // for the source, e.g. a body's local shape.
+    dst->bounding_radius = polygon_bounding_radius(src);
+    dst->bounding_radius_valid = true;
+    double c = cos(angle);
+    double s = sin(angle);
+    // The box is cheap to find while the vertices are being written anyway.
+    aabb_t box = {.min = {INFINITY, INFINITY}, .max = {-INFINITY, -INFINITY}};
+    for (size_t i = 0; i < src->size; i++) {
+        double x = src->xs[i];
+        double y = src->ys[i];
+        double wx = translation.x + c * x - s * y;
+        double wy = translation.y + s * x + c * y;
+        dst->xs[i] = wx;
+        dst->ys[i] = wy;
+        box.min.x = fmin(box.min.x, wx);
+        box.min.y = fmin(box.min.y, wy);
+        box.max.x = fmax(box.max.x, wx);
+        box.max.y = fmax(box.max.y, wy);
     }
+    vector_t r = {dst->radius, dst->radius};
+    dst->box = (aabb_t){vec_subtract(box.min, r), vec_add(box.max, r)};
+    dst->box_valid = true;
+    // The centroid is an affine combination of the vertices, so it transforms
+    // just like them.
+    vector_t d = src->centroid;
+    dst->centroid = (vector_t){translation.x + c * d.x - s * d.y,
+                               translation.y + s * d.x + c * d.y};
+    dst->centroid_valid = src->centroid_valid;
 }
 
-list_t *polygon_init_from_path(const char *path) {
-    return list_init_from_path(path, free, (parse_record_func_t)vec_parse_str);
+polygon_t *polygon_init_from_path(const char *path) {
+    list_t *vertices
+        = list_init_from_path(path, free, (parse_record_func_t)vec_parse_str);
+    polygon_t *polygon = polygon_init_from_list(vertices);
+    list_free(vertices);
+    return polygon;
 }
 
 list_t *polygon_init_many_from_paths(const list_t *paths) {
-    list_t *shapes = list_init(list_size(paths), free);
+    list_t *shapes = list_init(list_size(paths), (free_func_t)polygon_free);
     for (size_t i = 0; i < list_size(paths); i++) {
         list_add(shapes, polygon_init_from_path(list_get(paths, i)));
     }
     return shapes;
 }
 
-void polygon_scale(list_t *polygon, double factor) {
+void polygon_scale(polygon_t *polygon, double factor) {
     if (factor <= 0) {
         fprintf(stderr,
                 "Fatal error: negative polygon_scale factor invalid.\n");
@@ -80,71 +308,113 @@ void polygon_scale(list_t *polygon, double factor) {
 
     vector_t old_centroid = polygon_centroid(polygon);
 
-    for (size_t i = 0; i < list_size(polygon); i++) {
-        vector_t *v = list_get(polygon, i);
-        *v = vec_multiply(factor, *v);
+    for (size_t i = 0; i < polygon->size; i++) {
+        polygon->xs[i] *= factor;
+        polygon->ys[i] *= factor;
     }
+    polygon->radius *= factor;
+    _polygon_invalidate_cache(polygon);
 
     // translate back to original centroid
     polygon_set_centroid(polygon, old_centroid);
 }
 
-void polygon_scr_to_sce(list_t *polygon) {
+void polygon_scr_to_sce(polygon_t *polygon) {
     // Apply screen-to-sceen scaling factor.
     polygon_scale(polygon, 1.0 / sdl_sce_to_scr_scale());
     // Reflect vertically since screen y-coords are opposite screen y-coords.
     vector_t c = polygon_centroid(polygon);
-    for (size_t i = 0; i < list_size(polygon); i++) {
-        vector_t *v = list_get(polygon, i);
-        *v = (vector_t){v->x, c.y - (v->y - c.y)};
+    for (size_t i = 0; i < polygon->size; i++) {
+        polygon->ys[i] = c.y - (polygon->ys[i] - c.y);
     }
+    _polygon_invalidate_cache(polygon);
     // We need to reverse order after reflection to preserve anticlockwise
     // orientation.
-    list_reverse(polygon);
+    polygon_reverse(polygon);
+}
+
+vector_t polygon_topleft(polygon_t *polygon) {
+    assert(polygon->size > 3 || polygon->radius > 0);
+
+    aabb_t box = polygon_aabb(polygon);
+    return (vector_t){box.min.x, box.max.y};
 }
 
-vector_t polygon_topleft(list_t *polygon) {
-    assert(list_size(polygon) > 3);
+vector_t polygon_botright(polygon_t *polygon) {
+    assert(polygon->size > 3 || polygon->radius > 0);
+
+    aabb_t box = polygon_aabb(polygon);
+    return (vector_t){box.max.x, box.min.y};
+}
 
-    vector_t topleft = *(vector_t *)list_get(polygon, 0);
-    for (size_t i = 0; i < list_size(polygon); i++) {
-        vector_t *v = list_get(polygon, i);
-        if (topleft.x > v->x) {
-            topleft.x = v->x;
-        }
-        if (topleft.y < v->y) {
-            topleft.y = v->y;
-        }
+aabb_t polygon_aabb(polygon_t *polygon) {
+    assert(polygon->size > 0);
+    if (polygon->box_valid) {
+        return polygon->box;
     }
-    return topleft;
+
+    const double *xs = polygon->xs;
+    const double *ys = polygon->ys;
+    aabb_t box = {.min = {xs[0], ys[0]}, .max = {xs[0], ys[0]}};
+    for (size_t i = 1; i < polygon->size; i++) {
+        box.min.x = fmin(box.min.x, xs[i]);
+        box.min.y = fmin(box.min.y, ys[i]);
+        box.max.x = fmax(box.max.x, xs[i]);
+        box.max.y = fmax(box.max.y, ys[i]);
+    }
+    vector_t r = {polygon->radius, polygon->radius};
+    box.min = vec_subtract(box.min, r);
+    box.max = vec_add(box.max, r);
+    polygon->box = box;
+    polygon->box_valid = true;
+    return box;
 }
 
-vector_t polygon_botright(list_t *polygon) {
-    assert(list_size(polygon) > 3);
+double polygon_bounding_radius(polygon_t *polygon) {
+    assert(polygon->size > 0);
+    if (polygon->bounding_radius_valid) {
+        return polygon->bounding_radius;
+    }
+    vector_t c = polygon_centroid(polygon);
+    double max_sq = 0;
+    for (size_t i = 0; i < polygon->size; i++) {
+        double dx = polygon->xs[i] - c.x;
+        double dy = polygon->ys[i] - c.y;
+        max_sq = fmax(max_sq, dx * dx + dy * dy);
+    }
+    polygon->bounding_radius = sqrt(max_sq) + polygon->radius;
+    polygon->bounding_radius_valid = true;
+    return polygon->bounding_radius;
+}
 
-    vector_t botright = *(vector_t *)list_get(polygon, 0);
-    for (size_t i = 0; i < list_size(polygon); i++) {
-        vector_t *v = list_get(polygon, i);
-        if (botright.x < v->x) {
-            botright.x = v->x;
-        }
-        if (botright.y > v->y) {
-            botright.y = v->y;
-        }
+bool polygon_bounds_overlap(polygon_t *polygon1, polygon_t *polygon2) {
+    // The circles first, since their centres and radii are usually cached
+    // with the shapes and don't need the boxes.
+    vector_t d
+        = vec_subtract(polygon_centroid(polygon2), polygon_centroid(polygon1));
+    double r = polygon_bounding_radius(polygon1)
+               + polygon_bounding_radius(polygon2);
+    if (d.x * d.x + d.y * d.y > r * r) {
+        return false;
     }
-    return botright;
+    return aabb_overlap(polygon_aabb(polygon1), polygon_aabb(polygon2));
+}
+
+bool aabb_overlap(aabb_t box1, aabb_t box2) {
+    return box1.min.x <= box2.max.x && box2.min.x <= box1.max.x
+           && box1.min.y <= box2.max.y && box2.min.y <= box1.max.y;
 }
 
-vector_t polygon_center(list_t *polygon) {
+vector_t polygon_center(polygon_t *polygon) {
     return vec_multiply(
         1.0 / 2.0,
         vec_add(polygon_topleft(polygon), polygon_botright(polygon)));
 }
 
-vector_t polygon_centroid_to_topleft(list_t *polygon) {
+vector_t polygon_centroid_to_topleft(polygon_t *polygon) {
     return vec_subtract(polygon_topleft(polygon), polygon_centroid(polygon));
 }
 
-vector_t polygon_centroid_to_center(list_t *polygon) {
+vector_t polygon_centroid_to_center(polygon_t *polygon) {
     return vec_subtract(polygon_center(polygon), polygon_centroid(polygon));
 }
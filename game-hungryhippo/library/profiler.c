@@ -0,0 +1,350 @@
+#include "profiler.h"
+#include "list.h"
+#include <assert.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*** PRIVATE CONSTS ***/
+
+// Histogram buckets are a sixteenth of a power of two of nanoseconds wide, up
+// to 2^40 ns (about 18 minutes), so they are each within about 3% of their
+// middle.
+#define _PROFILER_SUB_BUCKETS 16
+#define _PROFILER_MAX_EXPONENT 40
+#define _PROFILER_BUCKETS (_PROFILER_SUB_BUCKETS * (_PROFILER_MAX_EXPONENT + 1))
+
+const char *_PROFILER_ZONE_NAMES[PROFILE_ZONE_COUNT] = {
+    "frame",
+    "events",
+    "physics",
+    "physics/gc",
+    "physics/forces",
+    "physics/collisions",
+    "physics/integrate",
+    "client tick",
+    "render",
+    "gc",
+};
+const size_t _PROFILER_INITIAL_TRACE_CAPACITY = 1024;
+const double _PROFILER_NS_PER_S = 1e9;
+const double _PROFILER_NS_PER_US = 1e3;
+const double _PROFILER_MS_PER_S = 1e3;
+const int _PROFILER_TAB_ROWHEIGHT = 15;
+const SDL_Color _PROFILER_TAB_COLOR = {0x00, 0x2b, 0x36, 0xfa};
+
+/*** STRUCTURES ***/
+
+/**
+ * One zone, as kept in a trace.
+ */
+typedef struct _profiler_event {
+    profile_zone_t zone;
+    uint64_t start;
+    uint64_t end;
+} _profiler_event_t;
+
+/**
+ * The last PROFILER_WINDOW frames of a zone. Each frame is kept as its
+ * bucket, so that it can be taken out of the counts once it is too old.
+ */
+typedef struct _profiler_histogram {
+    uint16_t frames[PROFILER_WINDOW]; // Ring of buckets, oldest at the head.
+    uint32_t counts[_PROFILER_BUCKETS];
+} _profiler_histogram_t;
+
+/*** GLOBALS ***/
+
+uint64_t _profiler_frame_ns[PROFILE_ZONE_COUNT]; // So far this frame.
+_profiler_histogram_t _profiler_histograms[PROFILE_ZONE_COUNT];
+size_t _profiler_frame_count = 0;
+size_t _profiler_frame_head = 0;
+
+bool _profiler_tracing = false;
+uint64_t _profiler_trace_start;
+_profiler_event_t *_profiler_trace = NULL;
+size_t _profiler_trace_size = 0;
+size_t _profiler_trace_capacity = 0;
+size_t _profiler_trace_dropped = 0;
+
+// Rows of overlay tables: a header, then each zone.
+list_t *_profiler_tab_rows = NULL;
+profile_zone_t _profiler_tab_zones[PROFILE_ZONE_COUNT + 1];
+
+/*** PRIVATE PROTOTYPES ***/
+
+/**
+ * Return the histogram bucket of a duration.
+ */
+size_t _profiler_bucket(uint64_t ns);
+
+/**
+ * Return the duration in the middle of a histogram bucket.
+ */
+double _profiler_bucket_ns(size_t bucket);
+
+void _profiler_tab_zone_col(profile_zone_t *zone, char *buf, size_t size);
+void _profiler_tab_p50_col(profile_zone_t *zone, char *buf, size_t size);
+void _profiler_tab_p99_col(profile_zone_t *zone, char *buf, size_t size);
+
+/**
+ * Write a percentile of the zone in milliseconds into a cell, or 'header' if
+ * the row is the header.
+ */
+void _profiler_tab_percentile_cell(profile_zone_t *zone,
+                                   double fraction,
+                                   char *header,
+                                   char *buf,
+                                   size_t size);
+
+/*** DEFINITIONS ***/
+
+uint64_t profiler_now(void) {
+    struct timespec now;
+#ifdef _WIN32
+    // MSVC has no clock_gettime. The wall clock is fine for timing frames,
+    // short of the clock being changed while profiling.
+    timespec_get(&now, TIME_UTC);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &now);
+#endif
+    return (uint64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+void profiler_record(profile_zone_t zone, uint64_t start, uint64_t end) {
+    assert(zone < PROFILE_ZONE_COUNT && start <= end);
+    _profiler_frame_ns[zone] += end - start;
+    if (!_profiler_tracing) {
+        return;
+    }
+    if (_profiler_trace_size == PROFILER_MAX_TRACE_EVENTS) {
+        _profiler_trace_dropped++;
+        return;
+    }
+    if (_profiler_trace_size == _profiler_trace_capacity) {
+        _profiler_trace_capacity = _profiler_trace_capacity == 0
+                                       ? _PROFILER_INITIAL_TRACE_CAPACITY
+                                       : 2 * _profiler_trace_capacity;
+        _profiler_trace = realloc(_profiler_trace,
+                                  _profiler_trace_capacity
+                                      * sizeof(_profiler_event_t));
+        assert(_profiler_trace != NULL);
+    }
+    _profiler_trace[_profiler_trace_size++]
+        = (_profiler_event_t){zone, start, end};
+}
+
+void profiler_end_frame(void) {
+    for (size_t i = 0; i < PROFILE_ZONE_COUNT; i++) {
+        _profiler_histogram_t *histogram = &_profiler_histograms[i];
+        size_t slot = (_profiler_frame_head + _profiler_frame_count)
+                      % PROFILER_WINDOW;
+        if (_profiler_frame_count == PROFILER_WINDOW) {
+            // The newest frame takes the oldest's place.
+            histogram->counts[histogram->frames[slot]]--;
+        }
+        size_t bucket = _profiler_bucket(_profiler_frame_ns[i]);
+        histogram->frames[slot] = bucket;
+        histogram->counts[bucket]++;
+        _profiler_frame_ns[i] = 0;
+    }
+    if (_profiler_frame_count == PROFILER_WINDOW) {
+        _profiler_frame_head = (_profiler_frame_head + 1) % PROFILER_WINDOW;
+    } else {
+        _profiler_frame_count++;
+    }
+}
+
+size_t profiler_frame_count(void) {
+    return _profiler_frame_count;
+}
+
+double profiler_percentile(profile_zone_t zone, double fraction) {
+    assert(zone < PROFILE_ZONE_COUNT && fraction >= 0 && fraction <= 1);
+    if (_profiler_frame_count == 0) {
+        return 0;
+    }
+    // The smallest bucket with at least 'rank' frames at or below it.
+    size_t rank = ceil(fraction * _profiler_frame_count);
+    if (rank == 0) {
+        rank = 1;
+    }
+    uint32_t *counts = _profiler_histograms[zone].counts;
+    size_t seen = 0;
+    size_t bucket = 0;
+    while (seen + counts[bucket] < rank) {
+        seen += counts[bucket];
+        bucket++;
+    }
+    return _profiler_bucket_ns(bucket) / _PROFILER_NS_PER_S;
+}
+
+const char *profiler_zone_name(profile_zone_t zone) {
+    assert(zone < PROFILE_ZONE_COUNT);
+    return _PROFILER_ZONE_NAMES[zone];
+}
+
+void profiler_print_report(FILE *out) {
+    fprintf(out,
+            "Frame profile over the last %zu frames (ms):\n"
+            "%-20s %10s %10s\n",
+            _profiler_frame_count,
+            "zone",
+            "p50",
+            "p99");
+    for (size_t i = 0; i < PROFILE_ZONE_COUNT; i++) {
+        fprintf(out,
+                "%-20s %10.3f %10.3f\n",
+                profiler_zone_name(i),
+                profiler_percentile(i, 0.5) * _PROFILER_MS_PER_S,
+                profiler_percentile(i, 0.99) * _PROFILER_MS_PER_S);
+    }
+}
+
+void profiler_start_trace(void) {
+    _profiler_tracing = true;
+    _profiler_trace_start = profiler_now();
+    _profiler_trace_size = 0;
+    _profiler_trace_dropped = 0;
+}
+
+void profiler_write_trace(const char *path) {
+    FILE *file = fopen(path, "w");
+    if (file == NULL) {
+        fprintf(stderr,
+                "Fatal error: profiler_write_trace: cannot open %s.\n",
+                path);
+        exit(1);
+    }
+    // Complete ("X") events, in microseconds since the trace started, all on
+    // one thread.
+    fprintf(file, "{\"traceEvents\":[");
+    for (size_t i = 0; i < _profiler_trace_size; i++) {
+        _profiler_event_t *event = &_profiler_trace[i];
+        uint64_t start = event->start > _profiler_trace_start
+                             ? event->start - _profiler_trace_start
+                             : 0;
+        fprintf(file,
+                "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+                "\"pid\":1,\"tid\":1}",
+                i == 0 ? "" : ",",
+                profiler_zone_name(event->zone),
+                start / _PROFILER_NS_PER_US,
+                (event->end - event->start) / _PROFILER_NS_PER_US);
+    }
+    fprintf(file, "\n],\"displayTimeUnit\":\"ms\"}\n");
+    fclose(file);
+    if (_profiler_trace_dropped > 0) {
+        fprintf(stderr,
+                "Warning: profiler_write_trace: dropped the last %zu events.\n",
+                _profiler_trace_dropped);
+    }
+    _profiler_tracing = false;
+}
+
+text_tab_t *profiler_create_tab(vector_t topleft) {
+    if (_profiler_tab_rows == NULL) {
+        _profiler_tab_rows = list_init(PROFILE_ZONE_COUNT + 1, NULL);
+        _profiler_tab_zones[PROFILE_ZONE_COUNT] = PROFILE_ZONE_COUNT;
+        list_add(_profiler_tab_rows, &_profiler_tab_zones[PROFILE_ZONE_COUNT]);
+        for (size_t i = 0; i < PROFILE_ZONE_COUNT; i++) {
+            _profiler_tab_zones[i] = i;
+            list_add(_profiler_tab_rows, &_profiler_tab_zones[i]);
+        }
+    }
+    text_tab_t *tab = text_tab_init(_profiler_tab_rows,
+                                    list_size(_profiler_tab_rows),
+                                    topleft,
+                                    _PROFILER_TAB_ROWHEIGHT);
+    text_tab_add_col(tab,
+                     150,
+                     (text_col_func_t)_profiler_tab_zone_col,
+                     _PROFILER_TAB_COLOR,
+                     TEXT_STYLE_BOLD);
+    text_tab_add_col(tab,
+                     70,
+                     (text_col_func_t)_profiler_tab_p50_col,
+                     _PROFILER_TAB_COLOR,
+                     TEXT_STYLE_NORMAL);
+    text_tab_add_col(tab,
+                     70,
+                     (text_col_func_t)_profiler_tab_p99_col,
+                     _PROFILER_TAB_COLOR,
+                     TEXT_STYLE_NORMAL);
+    return tab;
+}
+
+void profiler_free(void) {
+    if (_profiler_tab_rows != NULL) {
+        list_free(_profiler_tab_rows);
+        _profiler_tab_rows = NULL;
+    }
+    free(_profiler_trace);
+    _profiler_trace = NULL;
+    _profiler_trace_size = 0;
+    _profiler_trace_capacity = 0;
+    _profiler_trace_dropped = 0;
+    _profiler_tracing = false;
+    for (size_t i = 0; i < PROFILE_ZONE_COUNT; i++) {
+        _profiler_frame_ns[i] = 0;
+        _profiler_histograms[i] = (_profiler_histogram_t){0};
+    }
+    _profiler_frame_count = 0;
+    _profiler_frame_head = 0;
+}
+
+/*** DEFINITIONS OF PRIVATE FUNCTIONS ***/
+
+size_t _profiler_bucket(uint64_t ns) {
+    if (ns == 0) {
+        return 0;
+    }
+    // ns = mantissa * 2^exponent with mantissa in [0.5, 1), and exponent >= 1.
+    int exponent;
+    double mantissa = frexp(ns, &exponent);
+    if (exponent > _PROFILER_MAX_EXPONENT) {
+        return _PROFILER_BUCKETS - 1;
+    }
+    size_t sub = (mantissa - 0.5) * 2 * _PROFILER_SUB_BUCKETS;
+    return exponent * _PROFILER_SUB_BUCKETS + sub;
+}
+
+double _profiler_bucket_ns(size_t bucket) {
+    if (bucket == 0) {
+        return 0;
+    }
+    int exponent = bucket / _PROFILER_SUB_BUCKETS;
+    double sub = bucket % _PROFILER_SUB_BUCKETS + 0.5;
+    return ldexp(0.5 + sub / (2 * _PROFILER_SUB_BUCKETS), exponent);
+}
+
+void _profiler_tab_zone_col(profile_zone_t *zone, char *buf, size_t size) {
+    snprintf(buf,
+             size,
+             "%s",
+             *zone == PROFILE_ZONE_COUNT ? "zone" : profiler_zone_name(*zone));
+}
+
+void _profiler_tab_p50_col(profile_zone_t *zone, char *buf, size_t size) {
+    _profiler_tab_percentile_cell(zone, 0.5, "p50 ms", buf, size);
+}
+
+void _profiler_tab_p99_col(profile_zone_t *zone, char *buf, size_t size) {
+    _profiler_tab_percentile_cell(zone, 0.99, "p99 ms", buf, size);
+}
+
+void _profiler_tab_percentile_cell(profile_zone_t *zone,
+                                   double fraction,
+                                   char *header,
+                                   char *buf,
+                                   size_t size) {
+    if (*zone == PROFILE_ZONE_COUNT) {
+        snprintf(buf, size, "%s", header);
+    } else {
+        snprintf(buf,
+                 size,
+                 "%.2f",
+                 profiler_percentile(*zone, fraction) * _PROFILER_MS_PER_S);
+    }
+}
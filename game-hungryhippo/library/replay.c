@@ -0,0 +1,227 @@
+#include "replay.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+/*** PRIVATE CONSTS ***/
+const char _REPLAY_MAGIC[4] = {'E', 'H', 'R', 'P'};
+const uint32_t _REPLAY_VERSION = 2;
+const uint32_t _REPLAY_MAX_PARAMS = 256; // Sanity check on corrupt headers.
+
+/*** STRUCTURES ***/
+struct replay {
+    FILE *file;
+    bool playback;
+    bool ended; // Whether playback has reached the end of the log.
+    uint32_t seed;
+    uint32_t *params;
+    size_t param_count;
+};
+
+/*** PRIVATE PROTOTYPES ***/
+
+/**
+ * Write the low 'size' bytes of 'value', little-endian.
+ */
+void _replay_write(replay_t *replay, uint64_t value, size_t size);
+
+/**
+ * Read a 'size' byte little-endian number into 'value' and return whether
+ * there were enough bytes left in the file.
+ */
+bool _replay_read(replay_t *replay, size_t size, uint64_t *value);
+
+/*** DEFINITIONS ***/
+
+replay_t *replay_init_record(const char *path,
+                             uint32_t seed,
+                             const uint32_t *params,
+                             size_t param_count) {
+    assert(param_count <= _REPLAY_MAX_PARAMS);
+    replay_t *replay = malloc(sizeof(replay_t));
+    assert(replay != NULL);
+    replay->file = fopen(path, "wb");
+    if (replay->file == NULL) {
+        fprintf(stderr,
+                "Fatal error: replay_init_record: cannot open %s.\n",
+                path);
+        exit(1);
+    }
+    replay->playback = false;
+    replay->ended = false;
+    replay->seed = seed;
+    replay->param_count = param_count;
+    replay->params = malloc(param_count * sizeof(uint32_t));
+    assert(replay->params != NULL || param_count == 0);
+
+    for (size_t i = 0; i < sizeof(_REPLAY_MAGIC); i++) {
+        _replay_write(replay, _REPLAY_MAGIC[i], 1);
+    }
+    _replay_write(replay, _REPLAY_VERSION, 4);
+    _replay_write(replay, seed, 4);
+    _replay_write(replay, param_count, 4);
+    for (size_t i = 0; i < param_count; i++) {
+        replay->params[i] = params[i];
+        _replay_write(replay, params[i], 4);
+    }
+    return replay;
+}
+
+replay_t *replay_init_playback(const char *path) {
+    replay_t *replay = malloc(sizeof(replay_t));
+    assert(replay != NULL);
+    replay->file = fopen(path, "rb");
+    if (replay->file == NULL) {
+        fprintf(stderr,
+                "Fatal error: replay_init_playback: cannot open %s.\n",
+                path);
+        exit(1);
+    }
+    replay->playback = true;
+    replay->ended = false;
+
+    bool ok = true;
+    uint64_t value;
+    for (size_t i = 0; i < sizeof(_REPLAY_MAGIC); i++) {
+        ok = ok && _replay_read(replay, 1, &value)
+             && value == (uint8_t)_REPLAY_MAGIC[i];
+    }
+    ok = ok && _replay_read(replay, 4, &value) && value == _REPLAY_VERSION;
+    ok = ok && _replay_read(replay, 4, &value);
+    replay->seed = value;
+    ok = ok && _replay_read(replay, 4, &value) && value <= _REPLAY_MAX_PARAMS;
+    if (!ok) {
+        fprintf(stderr,
+                "Fatal error: replay_init_playback: %s is not a replay from "
+                "this version of the game.\n",
+                path);
+        exit(1);
+    }
+    replay->param_count = value;
+    replay->params = malloc(replay->param_count * sizeof(uint32_t));
+    assert(replay->params != NULL || replay->param_count == 0);
+    for (size_t i = 0; i < replay->param_count; i++) {
+        if (!_replay_read(replay, 4, &value)) {
+            fprintf(stderr,
+                    "Fatal error: replay_init_playback: %s is truncated.\n",
+                    path);
+            exit(1);
+        }
+        replay->params[i] = value;
+    }
+    return replay;
+}
+
+void replay_free(replay_t *replay) {
+    if (fclose(replay->file) != 0) {
+        fprintf(stderr, "replay_free: error closing replay file.\n");
+    }
+    free(replay->params);
+    free(replay);
+}
+
+bool replay_is_playback(replay_t *replay) {
+    return replay->playback;
+}
+
+uint32_t replay_get_seed(replay_t *replay) {
+    return replay->seed;
+}
+
+const uint32_t *replay_get_params(replay_t *replay, size_t *param_count) {
+    *param_count = replay->param_count;
+    return replay->params;
+}
+
+void replay_record_key(replay_t *replay, SDL_KeyboardEvent key) {
+    _replay_write(replay, REPLAY_EVENT_KEY, 1);
+    _replay_write(replay, key.state, 1);
+    _replay_write(replay, (uint32_t)key.keysym.sym, 4);
+    _replay_write(replay, key.keysym.scancode, 2);
+    _replay_write(replay, key.keysym.mod, 2);
+}
+
+void replay_record_quit(replay_t *replay) {
+    _replay_write(replay, REPLAY_EVENT_QUIT, 1);
+}
+
+void replay_record_tick(replay_t *replay, double dt) {
+    uint64_t bits;
+    memcpy(&bits, &dt, sizeof(bits));
+    _replay_write(replay, REPLAY_EVENT_TICK, 1);
+    _replay_write(replay, bits, 8);
+}
+
+replay_event_t replay_read(replay_t *replay) {
+    assert(replay->playback);
+    replay_event_t event;
+    memset(&event, 0, sizeof(event));
+    event.type = REPLAY_EVENT_END;
+    if (replay->ended) {
+        return event;
+    }
+
+    uint64_t type, a, b, c, d;
+    bool ok = _replay_read(replay, 1, &type);
+    if (ok) {
+        switch (type) {
+        case REPLAY_EVENT_KEY:
+            ok = _replay_read(replay, 1, &a) && _replay_read(replay, 4, &b)
+                 && _replay_read(replay, 2, &c) && _replay_read(replay, 2, &d);
+            if (!ok) {
+                break;
+            }
+            event.key.type = a == SDL_PRESSED ? SDL_KEYDOWN : SDL_KEYUP;
+            event.key.state = a;
+            event.key.keysym.sym = (int32_t)(uint32_t)b;
+            event.key.keysym.scancode = c;
+            event.key.keysym.mod = d;
+            break;
+        case REPLAY_EVENT_QUIT:
+            break;
+        case REPLAY_EVENT_TICK:
+            ok = _replay_read(replay, 8, &a);
+            if (!ok) {
+                break;
+            }
+            memcpy(&event.dt, &a, sizeof(event.dt));
+            break;
+        default:
+            ok = false;
+            break;
+        }
+    }
+    if (!ok) {
+        replay->ended = true;
+        memset(&event, 0, sizeof(event));
+        event.type = REPLAY_EVENT_END;
+        return event;
+    }
+    event.type = type;
+    return event;
+}
+
+void _replay_write(replay_t *replay, uint64_t value, size_t size) {
+    assert(!replay->playback && size <= 8);
+    unsigned char bytes[8];
+    for (size_t i = 0; i < size; i++) {
+        bytes[i] = (value >> (8 * i)) & 0xff;
+    }
+    if (fwrite(bytes, 1, size, replay->file) != size) {
+        fprintf(stderr, "Fatal error: replay: error writing replay file.\n");
+        exit(1);
+    }
+}
+
+bool _replay_read(replay_t *replay, size_t size, uint64_t *value) {
+    assert(size <= 8);
+    unsigned char bytes[8];
+    if (fread(bytes, 1, size, replay->file) != size) {
+        return false;
+    }
+    *value = 0;
+    for (size_t i = 0; i < size; i++) {
+        *value |= (uint64_t)bytes[i] << (8 * i);
+    }
+    return true;
+}
@@ -49,6 +49,12 @@ SDL_Window *window = NULL;
  */
 SDL_Renderer *renderer = NULL;
 
+/**
+ * Whether SDL was initialized without a window or renderer (see
+ * sdl_init_headless).
+ */
+bool headless = false;
+
 // triggers the program that controls
 // your graphics hardware and sets flags
 Uint32 RENDER_FLAGS = SDL_RENDERER_ACCELERATED;
@@ -71,26 +77,32 @@ void *key_handler_aux = NULL;
 uint32_t key_start_timestamp;
 
 /**
- * The value of clock() when time_since_last_tick() was last called.
- * Initially 0.
+ * Scratch memory for the current frame, owned by the game (see
+ * sdl_set_frame_arena).
+ */
+arena_t *frame_arena = NULL;
+
+/**
+ * The value of SDL_GetPerformanceCounter() when time_since_last_tick() was last
+ * called. Initially 0.
  */
-clock_t last_clock = 0;
+Uint64 last_counter = 0;
 
 /** Computes the center of the window in pixel coordinates */
 vector_t get_window_center(void) {
+    if (headless) {
+        // Convert coordinates as if there were a window of the default size.
+        return (vector_t){WINDOW_WIDTH / 2.0, WINDOW_HEIGHT / 2.0};
+    }
     if (window == NULL) {
         fprintf(stderr,
                 "Fatal error: sdl_wrapper/get_window_center: window not "
                 "initialized yet.\n");
         exit(1);
     }
-    int *width = malloc(sizeof(*width)), *height = malloc(sizeof(*height));
-    assert(width != NULL);
-    assert(height != NULL);
-    SDL_GetWindowSize(window, width, height);
-    vector_t dimensions = {.x = *width, .y = *height};
-    free(width);
-    free(height);
+    int width, height;
+    SDL_GetWindowSize(window, &width, &height);
+    vector_t dimensions = {.x = width, .y = height};
     return vec_multiply(0.5, dimensions);
 }
 
@@ -166,13 +178,19 @@ char get_keycode(SDL_Keycode key) {
     }
 }
 
-void sdl_init(vector_t min, vector_t max) {
+/** Sets up the scene coordinates for the window (or lack thereof) */
+void init_scene(vector_t min, vector_t max) {
     // Check parameters
     assert(min.x < max.x);
     assert(min.y < max.y);
 
     center = vec_multiply(0.5, vec_add(min, max));
     max_diff = vec_subtract(max, center);
+}
+
+void sdl_init(vector_t min, vector_t max) {
+    init_scene(min, max);
+    headless = false;
     // retutns zero on success else non-zero
     if (SDL_Init(SDL_INIT_EVERYTHING) != 0) {
         fprintf(stderr, "Fatal error initializing SDL: %s\n", SDL_GetError());
@@ -187,13 +205,24 @@ void sdl_init(vector_t min, vector_t max) {
     renderer = SDL_CreateRenderer(window, -1, RENDER_FLAGS);
 }
 
+void sdl_init_headless(vector_t min, vector_t max) {
+    init_scene(min, max);
+    headless = true;
+    // Just the event queue, which is still polled every tick.
+    if (SDL_Init(SDL_INIT_EVENTS) != 0) {
+        fprintf(stderr, "Fatal error initializing SDL: %s\n", SDL_GetError());
+    }
+}
+
+bool sdl_is_headless(void) {
+    return headless;
+}
+
 bool sdl_is_done(void) {
-    SDL_Event *event = malloc(sizeof(*event));
-    assert(event != NULL);
-    while (SDL_PollEvent(event)) {
-        switch (event->type) {
+    SDL_Event event;
+    while (SDL_PollEvent(&event)) {
+        switch (event.type) {
         case SDL_QUIT:
-            free(event);
             return true;
         case SDL_KEYDOWN:
         case SDL_KEYUP:
@@ -201,22 +230,21 @@ bool sdl_is_done(void) {
             // or an unrecognized key was pressed
             if (key_handler == NULL)
                 break;
-            char key = get_keycode(event->key.keysym.sym);
+            char key = get_keycode(event.key.keysym.sym);
             if (key == '\0')
                 break;
 
-            uint32_t timestamp = event->key.timestamp;
-            if (!event->key.repeat) {
+            uint32_t timestamp = event.key.timestamp;
+            if (!event.key.repeat) {
                 key_start_timestamp = timestamp;
             }
             key_event_type_t type
-                = event->type == SDL_KEYDOWN ? KEY_PRESSED : KEY_RELEASED;
+                = event.type == SDL_KEYDOWN ? KEY_PRESSED : KEY_RELEASED;
             double held_time = (timestamp - key_start_timestamp) / MS_PER_S;
             key_handler(key, type, held_time, key_handler_aux);
             break;
         }
     }
-    free(event);
     return false;
 }
 
@@ -225,10 +253,70 @@ void sdl_clear(void) {
     SDL_RenderClear(renderer);
 }
 
-void sdl_draw_polygon(list_t *points, rgb_color_t color) {
+/**
+ * Draws the rounded border of a polygon with the given vertices in pixels,
+ * i.e. a circle at each vertex and a strip along each edge.
+ */
+void draw_rounded_border(int16_t *x_points,
+                         int16_t *y_points,
+                         size_t n,
+                         double radius,
+                         rgb_color_t color) {
+    for (size_t i = 0; i < n; i++) {
+        filledCircleRGBA(renderer,
+                         x_points[i],
+                         y_points[i],
+                         round(radius),
+                         color.r * 255,
+                         color.g * 255,
+                         color.b * 255,
+                         255);
+    }
+    // A two vertex polygon only has the one edge, not one in each direction.
+    size_t n_edges = n == 2 ? 1 : n;
+    for (size_t i = 0; n > 1 && i < n_edges; i++) {
+        size_t j = (i + 1) % n;
+        double dx = x_points[j] - x_points[i];
+        double dy = y_points[j] - y_points[i];
+        double length = sqrt(dx * dx + dy * dy);
+        if (length == 0) {
+            continue;
+        }
+        // Offset both ends of the edge by radius on either side.
+        double nx = -dy / length * radius;
+        double ny = dx / length * radius;
+        int16_t xs[4] = {x_points[i] + nx,
+                         x_points[j] + nx,
+                         x_points[j] - nx,
+                         x_points[i] - nx};
+        int16_t ys[4] = {y_points[i] + ny,
+                         y_points[j] + ny,
+                         y_points[j] - ny,
+                         y_points[i] - ny};
+        filledPolygonRGBA(renderer,
+                          xs,
+                          ys,
+                          4,
+                          color.r * 255,
+                          color.g * 255,
+                          color.b * 255,
+                          255);
+    }
+}
+
+void sdl_draw_polygon(polygon_t *polygon, rgb_color_t color) {
+    sdl_draw_polygon_moved(polygon, color, 0, VEC_ZERO, VEC_ZERO);
+}
+
+void sdl_draw_polygon_moved(polygon_t *polygon,
+                            rgb_color_t color,
+                            double angle,
+                            vector_t from,
+                            vector_t to) {
     // Check parameters
-    size_t n = list_size(points);
-    assert(n >= 3);
+    size_t n = polygon_size(polygon);
+    double radius = polygon_radius(polygon);
+    assert(n >= 3 || radius > 0);
     assert(0 <= color.r && color.r <= 1);
     assert(0 <= color.g && color.g <= 1);
     assert(0 <= color.b && color.b <= 1);
@@ -236,28 +324,37 @@ void sdl_draw_polygon(list_t *points, rgb_color_t color) {
     vector_t window_center = get_window_center();
 
     // Convert each vertex to a point on screen
-    int16_t *x_points = malloc(sizeof(*x_points) * n),
-            *y_points = malloc(sizeof(*y_points) * n);
-    assert(x_points != NULL);
-    assert(y_points != NULL);
+    arena_t *arena = sdl_get_frame_arena();
+    int16_t *x_points = arena_alloc(arena, sizeof(*x_points) * n),
+            *y_points = arena_alloc(arena, sizeof(*y_points) * n);
+    double c = cos(angle);
+    double s = sin(angle);
     for (size_t i = 0; i < n; i++) {
-        vector_t *vertex = list_get(points, i);
-        vector_t pixel = get_window_position(*vertex, window_center);
+        vector_t d = vec_subtract(polygon_get(polygon, i), from);
+        vector_t vertex = {to.x + c * d.x - s * d.y, to.y + s * d.x + c * d.y};
+        vector_t pixel = get_window_position(vertex, window_center);
         x_points[i] = pixel.x;
         y_points[i] = pixel.y;
     }
 
     // Draw polygon with the given color
-    filledPolygonRGBA(renderer,
-                      x_points,
-                      y_points,
-                      n,
-                      color.r * 255,
-                      color.g * 255,
-                      color.b * 255,
-                      255);
-    free(x_points);
-    free(y_points);
+    if (n >= 3) {
+        filledPolygonRGBA(renderer,
+                          x_points,
+                          y_points,
+                          n,
+                          color.r * 255,
+                          color.g * 255,
+                          color.b * 255,
+                          255);
+    }
+    if (radius > 0) {
+        draw_rounded_border(x_points,
+                            y_points,
+                            n,
+                            radius * get_scene_scale(window_center),
+                            color);
+    }
 }
 
 void sdl_show(void) {
@@ -267,14 +364,12 @@ void sdl_show(void) {
              min = vec_subtract(center, max_diff);
     vector_t max_pixel = get_window_position(max, window_center),
              min_pixel = get_window_position(min, window_center);
-    SDL_Rect *boundary = malloc(sizeof(*boundary));
-    boundary->x = min_pixel.x;
-    boundary->y = max_pixel.y;
-    boundary->w = max_pixel.x - min_pixel.x;
-    boundary->h = min_pixel.y - max_pixel.y;
+    SDL_Rect boundary = {.x = min_pixel.x,
+                         .y = max_pixel.y,
+                         .w = max_pixel.x - min_pixel.x,
+                         .h = min_pixel.y - max_pixel.y};
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-    SDL_RenderDrawRect(renderer, boundary);
-    free(boundary);
+    SDL_RenderDrawRect(renderer, &boundary);
 
     SDL_RenderPresent(renderer);
 }
@@ -285,7 +380,14 @@ void sdl_render_body(body_t *body) {
         sdl_render_gfx(gfx_aux);
     }
     if (gfx_aux == NULL || ALWAYS_RENDER_SHAPE) {
-        sdl_draw_polygon(body_get_shape_nocp(body), body_get_color(body));
+        // The world shape is where the body is now; move it to where the body
+        // is drawn between ticks.
+        double angle = *body_get_angle_p(body) - body_get_rotation(body);
+        sdl_draw_polygon_moved(body_get_shape_nocp(body),
+                               body_get_color(body),
+                               angle,
+                               body_get_centroid(body),
+                               *body_get_anchor(body));
     }
 }
 
@@ -303,11 +405,12 @@ void sdl_on_key(key_handler_t handler, void *aux) {
 }
 
 double time_since_last_tick(void) {
-    clock_t now = clock();
-    double difference = last_clock
-                            ? (double)(now - last_clock) / CLOCKS_PER_SEC
-                            : 0.0; // return 0 the first time this is called
-    last_clock = now;
+    // A monotonic wall clock; clock() would measure CPU time instead.
+    Uint64 now = SDL_GetPerformanceCounter();
+    double difference = last_counter ? (double)(now - last_counter)
+                                           / SDL_GetPerformanceFrequency()
+                                     : 0.0; // return 0 the first time
+    last_counter = now;
     return difference;
 }
 
@@ -320,9 +423,25 @@ SDL_Renderer *sdl_get_renderer() {
     return renderer;
 }
 
+void sdl_set_frame_arena(arena_t *arena) {
+    frame_arena = arena;
+}
+
+arena_t *sdl_get_frame_arena(void) {
+    if (frame_arena == NULL) {
+        fprintf(stderr,
+                "Fatal error: sdl_get_frame_arena: no frame arena in "
+                "sdl_wrapper\n");
+        exit(1);
+    }
+    return frame_arena;
+}
+
 void sdl_free_all(void) {
-    SDL_DestroyRenderer(renderer);
-    SDL_DestroyWindow(window);
+    if (!headless) {
+        SDL_DestroyRenderer(renderer);
+        SDL_DestroyWindow(window);
+    }
 }
 
 void sdl_handle_error(char *loc, bool success) {
@@ -0,0 +1,83 @@
+#include "shape_template.h"
+#include "list.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*** STRUCTURES ***/
+
+typedef struct _shape_template {
+    char *path;
+    double scale;
+    bool scr; // Whether the CSV is in screen coordinates.
+    polygon_t *shape;
+} _shape_template_t;
+
+/*** GLOBALS ***/
+
+/**
+ * Every template loaded so far. NULL while there are none.
+ */
+list_t *_shape_templates = NULL;
+
+/*** PRIVATE PROTOTYPES ***/
+
+void _shape_template_free(_shape_template_t *template);
+
+/**
+ * Return the template for (path, scale, scr), loading it if needed.
+ */
+polygon_t *_shape_template_get(const char *path, double scale, bool scr);
+
+/*** DEFINITIONS ***/
+
+void _shape_template_free(_shape_template_t *template) {
+    free(template->path);
+    polygon_free(template->shape);
+    free(template);
+}
+
+polygon_t *_shape_template_get(const char *path, double scale, bool scr) {
+    if (_shape_templates == NULL) {
+        _shape_templates = list_init(1, (free_func_t)_shape_template_free);
+    }
+    for (size_t i = 0; i < list_size(_shape_templates); i++) {
+        _shape_template_t *template = list_get(_shape_templates, i);
+        if (template->scale == scale && template->scr == scr
+            && strcmp(template->path, path) == 0) {
+            return template->shape;
+        }
+    }
+
+    polygon_t *shape = polygon_init_from_path(path);
+    if (scr) {
+        polygon_scr_to_sce(shape);
+    }
+    polygon_scale(shape, scale);
+    polygon_set_centroid(shape, VEC_ZERO);
+
+    _shape_template_t *template = malloc(sizeof(_shape_template_t));
+    assert(template != NULL);
+    template->path = strdup(path);
+    assert(template->path != NULL);
+    template->scale = scale;
+    template->scr = scr;
+    template->shape = shape;
+    list_add(_shape_templates, template);
+    return shape;
+}
+
+polygon_t *shape_template_init(const char *path, double scale) {
+    return polygon_copy(_shape_template_get(path, scale, false));
+}
+
+polygon_t *shape_template_init_scr(const char *path, double scale) {
+    return polygon_copy(_shape_template_get(path, scale, true));
+}
+
+void shape_template_free_all(void) {
+    if (_shape_templates != NULL) {
+        list_free(_shape_templates);
+        _shape_templates = NULL;
+    }
+}
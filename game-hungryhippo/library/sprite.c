@@ -1,13 +1,16 @@
 #include "sprite.h"
+#include "alloc_stats.h"
 #include "polygon.h"
 #include "sdl_wrapper.h"
+#include "texture.h"
 #include "vector.h"
-#include <SDL2/SDL2_rotozoom.h>
+#include <math.h>
 
 /*** STRUCTS ***/
 
 struct sprite {
-    SDL_Texture *tex;
+    // Shared with every sprite of the same image. NULL if headless.
+    texture_t *texture;
     /**
      * offset - A vector in scene coordinates that points from the anchor to
      * the top left corner of the sprite's rectangle.
@@ -25,20 +28,18 @@ struct sprite {
 
 sprite_t *sprite_init(const char *img_path, double scale, vector_t offset) {
     sprite_t *sprite = calloc(1, sizeof(sprite_t));
-    SDL_Surface *surface_original = IMG_Load(img_path);
-    sdl_handle_error("sprite_init: IMG_Load", surface_original != NULL);
-    SDL_Surface *surface
-        = rotozoomSurface(surface_original, 0, scale, SMOOTHING_ON);
-    sprite->tex = SDL_CreateTextureFromSurface(sdl_get_renderer(), surface);
-    SDL_FreeSurface(surface_original);
-    SDL_FreeSurface(surface);
+    ALLOC_STATS_ALLOC(SPRITE, sizeof(sprite_t));
+    ALLOC_STATS_CREATE(SPRITE);
     sprite->anchor = NULL;
     sprite->angle = NULL;
-    SDL_QueryTexture(sprite->tex,
-                     NULL,
-                     NULL,
-                     &(sprite->dims.x),
-                     &(sprite->dims.y));
+    // Without a display the sprite is never drawn, so don't load anything.
+    sprite->texture
+        = sdl_is_headless() ? NULL : texture_acquire(img_path, scale);
+    if (sprite->texture != NULL) {
+        SDL_Rect region = texture_get_region(sprite->texture);
+        sprite->dims.x = region.w;
+        sprite->dims.y = region.h;
+    }
 
     vector_t center_to_topleft_sce = vec_multiply(
         1.0 / sdl_sce_to_scr_scale() / 2.0,
@@ -78,15 +79,53 @@ void sprite_setup_with_body(sprite_t *sprite, body_t *body) {
 }
 
 void sprite_free(sprite_t *sprite) {
-    SDL_DestroyTexture(sprite->tex);
+    if (sprite->texture != NULL) {
+        texture_release(sprite->texture);
+    }
     free(sprite);
+    ALLOC_STATS_DESTROY(SPRITE);
+}
+
+bool sprite_get_quad(sprite_t *sprite, SDL_Vertex quad[4]) {
+    if (sprite->texture == NULL || !texture_in_atlas(sprite->texture)) {
+        return false;
+    }
+    // Same placement as sprite_render; see there.
+    SDL_Point anchor_scr = sdl_sce_to_scr_coord(*(sprite->anchor));
+    SDL_Point rect_topleft_scr
+        = sdl_sce_to_scr_coord(vec_add(*(sprite->anchor), sprite->offset));
+    double angle = sdl_sce_to_scr_angle(*(sprite->angle)) * M_PI / 180;
+    double cos_angle = cos(angle), sin_angle = sin(angle);
+    SDL_Point atlas_dims = texture_get_sdl_dims(sprite->texture);
+    SDL_Rect region = texture_get_region(sprite->texture);
+
+    // Corners clockwise from the top left, relative to the pivot.
+    double pivot_x = anchor_scr.x - rect_topleft_scr.x;
+    double pivot_y = anchor_scr.y - rect_topleft_scr.y;
+    int corner_xs[4] = {0, sprite->dims.x, sprite->dims.x, 0};
+    int corner_ys[4] = {0, 0, sprite->dims.y, sprite->dims.y};
+    for (size_t i = 0; i < 4; i++) {
+        double x = corner_xs[i] - pivot_x, y = corner_ys[i] - pivot_y;
+        // Clockwise on screen, as with SDL_RenderCopyEx.
+        quad[i].position.x = anchor_scr.x + x * cos_angle - y * sin_angle;
+        quad[i].position.y = anchor_scr.y + x * sin_angle + y * cos_angle;
+        quad[i].color = (SDL_Color){255, 255, 255, 255};
+        quad[i].tex_coord.x
+            = (float)(region.x + corner_xs[i]) / atlas_dims.x;
+        quad[i].tex_coord.y
+            = (float)(region.y + corner_ys[i]) / atlas_dims.y;
+    }
+    return true;
 }
 
 void sprite_render(sprite_t *sprite) {
+    if (sprite->texture == NULL) {
+        return;
+    }
     const vector_t *anchor = sprite->anchor;
     vector_t offset = sprite->offset;
-    SDL_Rect *rect = malloc(sizeof(SDL_Rect));
-    SDL_Point *pivot = malloc(sizeof(SDL_Point));
+    SDL_Rect rect;
+    SDL_Point pivot;
 
     // Convert anchor to screen coordinates for later.
     SDL_Point anchor_scr = sdl_sce_to_scr_coord(*anchor);
@@ -101,25 +140,23 @@ void sprite_render(sprite_t *sprite) {
     double angle_scr = sdl_sce_to_scr_angle(*(sprite->angle));
 
     // Populate rectangle.
-    rect->w = sprite->dims.x;
-    rect->h = sprite->dims.y;
-    rect->x = rect_topleft_scr.x;
-    rect->y = rect_topleft_scr.y;
+    rect.w = sprite->dims.x;
+    rect.h = sprite->dims.y;
+    rect.x = rect_topleft_scr.x;
+    rect.y = rect_topleft_scr.y;
 
     // Compute pivot relative to top left corner.
     // Abstractly, the pivot is literally the negative of the offset, but this
     // seems the simplest way to convert from scene to screen coordinates.
-    pivot->x = anchor_scr.x - rect_topleft_scr.x;
-    pivot->y = anchor_scr.y - rect_topleft_scr.y;
+    pivot.x = anchor_scr.x - rect_topleft_scr.x;
+    pivot.y = anchor_scr.y - rect_topleft_scr.y;
 
+    SDL_Rect region = texture_get_region(sprite->texture);
     SDL_RenderCopyEx(sdl_get_renderer(),
-                     sprite->tex,
-                     NULL,
-                     rect,
+                     texture_get_sdl(sprite->texture),
+                     &region,
+                     &rect,
                      angle_scr,
-                     pivot,
+                     &pivot,
                      SDL_FLIP_NONE);
-
-    free(rect);
-    free(pivot);
 }
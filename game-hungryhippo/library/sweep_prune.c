@@ -0,0 +1,661 @@
+#include "sweep_prune.h"
+#include <assert.h>
+#include <stdlib.h>
+
+/*** PRIVATE CONSTS ***/
+
+#define _SWEEP_PRUNE_AXES 2
+const uint32_t _SWEEP_PRUNE_NONE = UINT32_MAX;
+const size_t _SWEEP_PRUNE_INITIAL_TABLE_CAPACITY = 16; // A power of two.
+const double _SWEEP_PRUNE_MAX_LOAD = 0.5;
+const uint64_t _SWEEP_PRUNE_HASH_MULTIPLIER = 0x9e3779b97f4a7c15;
+// New objects start after everything else, so each costs a step for every end
+// it passes. When this many of them are new, e.g. on the first tick, sorting
+// from scratch is cheaper.
+const double _SWEEP_PRUNE_REBUILD_FRACTION = 0.25;
+
+/*** STRUCTURES ***/
+
+/**
+ * The lower or upper end of an object's box along one axis.
+ */
+typedef struct _sweep_prune_end {
+    double value;
+    uint32_t proxy;
+    bool is_max;
+} _sweep_prune_end_t;
+
+/**
+ * An object, under an id that is reused once the object is dropped.
+ */
+typedef struct _sweep_prune_proxy {
+    void *obj;
+    uint64_t key;
+    size_t side;
+    aabb_t box;
+    size_t ends[_SWEEP_PRUNE_AXES][2]; // Indices of the ends, min then max.
+    size_t synced;                     // Tick in which it was last synced.
+    bool alive;
+} _sweep_prune_proxy_t;
+
+/**
+ * A pair of objects whose boxes overlap.
+ */
+typedef struct _sweep_prune_pair {
+    uint32_t proxy1; // On side 0 unless within a single group.
+    uint32_t proxy2;
+    bool flag;
+} _sweep_prune_pair_t;
+
+/**
+ * A hash table from nonzero keys to indices, with linear probing.
+ */
+typedef struct _sweep_prune_slot {
+    uint64_t key; // 0 if the slot is empty.
+    uint32_t value;
+} _sweep_prune_slot_t;
+
+typedef struct _sweep_prune_table {
+    _sweep_prune_slot_t *slots;
+    size_t capacity; // A power of two.
+    size_t size;
+} _sweep_prune_table_t;
+
+struct sweep_prune {
+    bool self;
+    size_t tick;
+    _sweep_prune_proxy_t *proxies;
+    size_t n_proxies; // Ids handed out so far, some of which may be free.
+    size_t proxies_capacity;
+    uint32_t *free_ids; // Same capacity as proxies.
+    size_t n_free_ids;
+    size_t size;  // Live objects.
+    size_t n_new; // Objects new since the last update.
+    // The ends of every box along each axis, sorted as of the last update.
+    _sweep_prune_end_t *ends[_SWEEP_PRUNE_AXES];
+    size_t n_ends;
+    size_t ends_capacity;
+    _sweep_prune_pair_t *pairs;
+    size_t n_pairs;
+    size_t pairs_capacity;
+    _sweep_prune_table_t objects; // Object and side to proxy id.
+    _sweep_prune_table_t pair_ids; // Pair of proxy ids to index in pairs.
+};
+
+/*** PRIVATE PROTOTYPES ***/
+
+void _sweep_prune_table_init(_sweep_prune_table_t *table, size_t capacity);
+
+/**
+ * Return the index of the slot where the search for 'key' starts.
+ */
+size_t _sweep_prune_table_home(_sweep_prune_table_t *table, uint64_t key);
+
+/**
+ * Return the index of the slot holding 'key', or of the empty slot where it
+ * would go.
+ */
+size_t _sweep_prune_table_find(_sweep_prune_table_t *table, uint64_t key);
+
+/**
+ * Return the value of 'key', or _SWEEP_PRUNE_NONE if it is not in the table.
+ */
+uint32_t _sweep_prune_table_get(_sweep_prune_table_t *table, uint64_t key);
+
+/**
+ * Set the value of 'key', adding it if needed.
+ */
+void _sweep_prune_table_put(_sweep_prune_table_t *table,
+                            uint64_t key,
+                            uint32_t value);
+
+/**
+ * Remove 'key' if it is in the table, shifting back the keys after it so that
+ * every key stays reachable from its home slot.
+ */
+void _sweep_prune_table_remove(_sweep_prune_table_t *table, uint64_t key);
+
+uint64_t _sweep_prune_object_key(void *obj, size_t side);
+uint64_t _sweep_prune_pair_key(uint32_t proxy1, uint32_t proxy2);
+
+/**
+ * Return whether end1 comes before end2. At equal values lower ends come
+ * first, so that boxes that only touch are in overlapping order, as
+ * aabb_overlap counts touching as overlapping.
+ */
+bool _sweep_prune_end_before(_sweep_prune_end_t *end1,
+                             _sweep_prune_end_t *end2);
+
+/**
+ * Start tracking a pair if the boxes of its objects overlap and it isn't
+ * tracked yet, after the lower end of one passed the upper end of the other.
+ */
+void _sweep_prune_add_pair(sweep_prune_t *sweep_prune,
+                           uint32_t proxy1,
+                           uint32_t proxy2,
+                           sweep_prune_event_func_t func,
+                           void *aux);
+
+/**
+ * Stop tracking a pair if the boxes of its objects no longer overlap, after
+ * the upper end of one passed the lower end of the other.
+ */
+void _sweep_prune_remove_pair(sweep_prune_t *sweep_prune,
+                              uint32_t proxy1,
+                              uint32_t proxy2,
+                              sweep_prune_event_func_t func,
+                              void *aux);
+
+/**
+ * Stop tracking the pair at 'idx' in pairs.
+ */
+void _sweep_prune_drop_pair(sweep_prune_t *sweep_prune,
+                            size_t idx,
+                            sweep_prune_event_func_t func,
+                            void *aux);
+
+/**
+ * Drop every object that wasn't synced this tick, along with its ends and
+ * pairs.
+ */
+void _sweep_prune_drop_unsynced(sweep_prune_t *sweep_prune,
+                                sweep_prune_event_func_t func,
+                                void *aux);
+
+/**
+ * qsort comparator ordering ends like _sweep_prune_end_before, then by proxy.
+ */
+int _sweep_prune_end_cmp(const void *end1, const void *end2);
+
+/**
+ * Sort the ends from scratch and find the pairs with a single sweep, calling
+ * 'func' on the pairs that begin or end, like _sweep_prune_sort_axis does.
+ */
+void _sweep_prune_rebuild(sweep_prune_t *sweep_prune,
+                          sweep_prune_event_func_t func,
+                          void *aux);
+
+/**
+ * Insertion sort the ends along an axis, adding and removing pairs as ends
+ * pass each other.
+ */
+void _sweep_prune_sort_axis(sweep_prune_t *sweep_prune,
+                            size_t axis,
+                            sweep_prune_event_func_t func,
+                            void *aux);
+
+/*** DEFINITIONS ***/
+
+sweep_prune_t *sweep_prune_init(bool self) {
+    sweep_prune_t *sweep_prune = malloc(sizeof(sweep_prune_t));
+    assert(sweep_prune != NULL);
+    sweep_prune->self = self;
+    sweep_prune->tick = 0;
+    sweep_prune->n_proxies = 0;
+    sweep_prune->proxies_capacity = 1;
+    sweep_prune->proxies = malloc(sizeof(_sweep_prune_proxy_t));
+    sweep_prune->free_ids = malloc(sizeof(uint32_t));
+    assert(sweep_prune->proxies != NULL && sweep_prune->free_ids != NULL);
+    sweep_prune->n_free_ids = 0;
+    sweep_prune->size = 0;
+    sweep_prune->n_new = 0;
+    sweep_prune->n_ends = 0;
+    sweep_prune->ends_capacity = 2;
+    for (size_t axis = 0; axis < _SWEEP_PRUNE_AXES; axis++) {
+        sweep_prune->ends[axis] = malloc(2 * sizeof(_sweep_prune_end_t));
+        assert(sweep_prune->ends[axis] != NULL);
+    }
+    sweep_prune->n_pairs = 0;
+    sweep_prune->pairs_capacity = 1;
+    sweep_prune->pairs = malloc(sizeof(_sweep_prune_pair_t));
+    assert(sweep_prune->pairs != NULL);
+    _sweep_prune_table_init(&sweep_prune->objects,
+                            _SWEEP_PRUNE_INITIAL_TABLE_CAPACITY);
+    _sweep_prune_table_init(&sweep_prune->pair_ids,
+                            _SWEEP_PRUNE_INITIAL_TABLE_CAPACITY);
+    return sweep_prune;
+}
+
+void sweep_prune_free(sweep_prune_t *sweep_prune) {
+    free(sweep_prune->proxies);
+    free(sweep_prune->free_ids);
+    for (size_t axis = 0; axis < _SWEEP_PRUNE_AXES; axis++) {
+        free(sweep_prune->ends[axis]);
+    }
+    free(sweep_prune->pairs);
+    free(sweep_prune->objects.slots);
+    free(sweep_prune->pair_ids.slots);
+    free(sweep_prune);
+}
+
+void sweep_prune_begin(sweep_prune_t *sweep_prune) {
+    sweep_prune->tick++;
+}
+
+void sweep_prune_sync(sweep_prune_t *sweep_prune,
+                      void *obj,
+                      uint64_t key,
+                      aabb_t box,
+                      size_t side) {
+    assert(side == 0 || side == 1);
+    uint64_t object_key = _sweep_prune_object_key(obj, side);
+    uint32_t id = _sweep_prune_table_get(&sweep_prune->objects, object_key);
+    if (id != _SWEEP_PRUNE_NONE && sweep_prune->proxies[id].key == key) {
+        _sweep_prune_proxy_t *proxy = &sweep_prune->proxies[id];
+        proxy->box = box;
+        proxy->synced = sweep_prune->tick;
+        for (size_t axis = 0; axis < _SWEEP_PRUNE_AXES; axis++) {
+            _sweep_prune_end_t *ends = sweep_prune->ends[axis];
+            ends[proxy->ends[axis][0]].value = axis == 0 ? box.min.x
+                                                         : box.min.y;
+            ends[proxy->ends[axis][1]].value = axis == 0 ? box.max.x
+                                                         : box.max.y;
+        }
+        return;
+    }
+    // Either a new object or a new one in an old one's place, in which case
+    // the old one is dropped at the update since it isn't synced any more.
+
+    if (sweep_prune->n_free_ids > 0) {
+        id = sweep_prune->free_ids[--sweep_prune->n_free_ids];
+    } else {
+        assert(sweep_prune->n_proxies < _SWEEP_PRUNE_NONE);
+        if (sweep_prune->n_proxies == sweep_prune->proxies_capacity) {
+            sweep_prune->proxies_capacity *= 2;
+            sweep_prune->proxies
+                = realloc(sweep_prune->proxies,
+                          sweep_prune->proxies_capacity
+                              * sizeof(_sweep_prune_proxy_t));
+            sweep_prune->free_ids
+                = realloc(sweep_prune->free_ids,
+                          sweep_prune->proxies_capacity * sizeof(uint32_t));
+            assert(sweep_prune->proxies != NULL
+                   && sweep_prune->free_ids != NULL);
+        }
+        id = sweep_prune->n_proxies++;
+    }
+    _sweep_prune_table_put(&sweep_prune->objects, object_key, id);
+    sweep_prune->size++;
+    sweep_prune->n_new++;
+
+    if (sweep_prune->n_ends + 2 > sweep_prune->ends_capacity) {
+        sweep_prune->ends_capacity *= 2;
+        for (size_t axis = 0; axis < _SWEEP_PRUNE_AXES; axis++) {
+            sweep_prune->ends[axis]
+                = realloc(sweep_prune->ends[axis],
+                          sweep_prune->ends_capacity
+                              * sizeof(_sweep_prune_end_t));
+            assert(sweep_prune->ends[axis] != NULL);
+        }
+    }
+    // Its ends go after everything else, i.e. as if it overlapped nothing,
+    // which the update then sorts out.
+    _sweep_prune_proxy_t *proxy = &sweep_prune->proxies[id];
+    *proxy = (_sweep_prune_proxy_t){.obj = obj,
+                                    .key = key,
+                                    .side = side,
+                                    .box = box,
+                                    .synced = sweep_prune->tick,
+                                    .alive = true};
+    size_t min_idx = sweep_prune->n_ends;
+    sweep_prune->ends[0][min_idx] = (_sweep_prune_end_t){box.min.x, id, false};
+    sweep_prune->ends[0][min_idx + 1]
+        = (_sweep_prune_end_t){box.max.x, id, true};
+    sweep_prune->ends[1][min_idx] = (_sweep_prune_end_t){box.min.y, id, false};
+    sweep_prune->ends[1][min_idx + 1]
+        = (_sweep_prune_end_t){box.max.y, id, true};
+    for (size_t axis = 0; axis < _SWEEP_PRUNE_AXES; axis++) {
+        proxy->ends[axis][0] = min_idx;
+        proxy->ends[axis][1] = min_idx + 1;
+    }
+    sweep_prune->n_ends += 2;
+}
+
+void sweep_prune_update(sweep_prune_t *sweep_prune,
+                        sweep_prune_event_func_t func,
+                        void *aux) {
+    _sweep_prune_drop_unsynced(sweep_prune, func, aux);
+    if (sweep_prune->n_new
+        > _SWEEP_PRUNE_REBUILD_FRACTION * sweep_prune->size) {
+        _sweep_prune_rebuild(sweep_prune, func, aux);
+    } else {
+        for (size_t axis = 0; axis < _SWEEP_PRUNE_AXES; axis++) {
+            _sweep_prune_sort_axis(sweep_prune, axis, func, aux);
+        }
+    }
+    sweep_prune->n_new = 0;
+}
+
+size_t sweep_prune_size(sweep_prune_t *sweep_prune) {
+    return sweep_prune->size;
+}
+
+size_t sweep_prune_pair_count(sweep_prune_t *sweep_prune) {
+    return sweep_prune->n_pairs;
+}
+
+void sweep_prune_for_each_pair(sweep_prune_t *sweep_prune,
+                               sweep_prune_pair_func_t func,
+                               void *aux) {
+    for (size_t i = 0; i < sweep_prune->n_pairs; i++) {
+        _sweep_prune_pair_t *pair = &sweep_prune->pairs[i];
+        func(sweep_prune->proxies[pair->proxy1].obj,
+             sweep_prune->proxies[pair->proxy2].obj,
+             &pair->flag,
+             aux);
+    }
+}
+
+/*** DEFINITIONS OF PRIVATE FUNCTIONS ***/
+
+void _sweep_prune_table_init(_sweep_prune_table_t *table, size_t capacity) {
+    table->slots = calloc(capacity, sizeof(_sweep_prune_slot_t));
+    assert(table->slots != NULL);
+    table->capacity = capacity;
+    table->size = 0;
+}
+
+size_t _sweep_prune_table_home(_sweep_prune_table_t *table, uint64_t key) {
+    return (key * _SWEEP_PRUNE_HASH_MULTIPLIER >> 32) & (table->capacity - 1);
+}
+
+size_t _sweep_prune_table_find(_sweep_prune_table_t *table, uint64_t key) {
+    size_t idx = _sweep_prune_table_home(table, key);
+    while (table->slots[idx].key != 0 && table->slots[idx].key != key) {
+        idx = (idx + 1) & (table->capacity - 1);
+    }
+    return idx;
+}
+
+uint32_t _sweep_prune_table_get(_sweep_prune_table_t *table, uint64_t key) {
+    _sweep_prune_slot_t *slot
+        = &table->slots[_sweep_prune_table_find(table, key)];
+    return slot->key == key ? slot->value : _SWEEP_PRUNE_NONE;
+}
+
+void _sweep_prune_table_put(_sweep_prune_table_t *table,
+                            uint64_t key,
+                            uint32_t value) {
+    assert(key != 0);
+    if (table->size + 1 > table->capacity * _SWEEP_PRUNE_MAX_LOAD) {
+        _sweep_prune_table_t old = *table;
+        _sweep_prune_table_init(table, 2 * old.capacity);
+        for (size_t i = 0; i < old.capacity; i++) {
+            if (old.slots[i].key != 0) {
+                table->slots[_sweep_prune_table_find(table, old.slots[i].key)]
+                    = old.slots[i];
+            }
+        }
+        table->size = old.size;
+        free(old.slots);
+    }
+    _sweep_prune_slot_t *slot
+        = &table->slots[_sweep_prune_table_find(table, key)];
+    if (slot->key == 0) {
+        table->size++;
+    }
+    *slot = (_sweep_prune_slot_t){key, value};
+}
+
+void _sweep_prune_table_remove(_sweep_prune_table_t *table, uint64_t key) {
+    size_t mask = table->capacity - 1;
+    size_t hole = _sweep_prune_table_find(table, key);
+    if (table->slots[hole].key == 0) {
+        return;
+    }
+    table->size--;
+    for (size_t idx = (hole + 1) & mask; table->slots[idx].key != 0;
+         idx = (idx + 1) & mask) {
+        // A key can fill the hole if the hole is between its home and it.
+        size_t home = _sweep_prune_table_home(table, table->slots[idx].key);
+        if (((idx - home) & mask) >= ((idx - hole) & mask)) {
+            table->slots[hole] = table->slots[idx];
+            hole = idx;
+        }
+    }
+    table->slots[hole].key = 0;
+}
+
+uint64_t _sweep_prune_object_key(void *obj, size_t side) {
+    // Objects are at least two-byte aligned, so the lowest bit is free.
+    assert(obj != NULL && ((uintptr_t)obj & 1) == 0);
+    return (uintptr_t)obj | side;
+}
+
+uint64_t _sweep_prune_pair_key(uint32_t proxy1, uint32_t proxy2) {
+    // Never 0, since the two differ.
+    return proxy1 < proxy2 ? (uint64_t)proxy1 << 32 | proxy2
+                           : (uint64_t)proxy2 << 32 | proxy1;
+}
+
+bool _sweep_prune_end_before(_sweep_prune_end_t *end1,
+                             _sweep_prune_end_t *end2) {
+    return end1->value < end2->value
+           || (end1->value == end2->value && !end1->is_max && end2->is_max);
+}
+
+void _sweep_prune_add_pair(sweep_prune_t *sweep_prune,
+                           uint32_t proxy1,
+                           uint32_t proxy2,
+                           sweep_prune_event_func_t func,
+                           void *aux) {
+    _sweep_prune_proxy_t *proxies = sweep_prune->proxies;
+    if (!sweep_prune->self && proxies[proxy1].side == proxies[proxy2].side) {
+        return;
+    }
+    if (!aabb_overlap(proxies[proxy1].box, proxies[proxy2].box)) {
+        return;
+    }
+    uint64_t key = _sweep_prune_pair_key(proxy1, proxy2);
+    if (_sweep_prune_table_get(&sweep_prune->pair_ids, key)
+        != _SWEEP_PRUNE_NONE) {
+        return;
+    }
+
+    if (sweep_prune->n_pairs == sweep_prune->pairs_capacity) {
+        sweep_prune->pairs_capacity *= 2;
+        sweep_prune->pairs = realloc(sweep_prune->pairs,
+                                     sweep_prune->pairs_capacity
+                                         * sizeof(_sweep_prune_pair_t));
+        assert(sweep_prune->pairs != NULL);
+    }
+    if (sweep_prune->self ? proxy2 < proxy1 : proxies[proxy1].side == 1) {
+        uint32_t tmp = proxy1;
+        proxy1 = proxy2;
+        proxy2 = tmp;
+    }
+    _sweep_prune_table_put(&sweep_prune->pair_ids, key, sweep_prune->n_pairs);
+    sweep_prune->pairs[sweep_prune->n_pairs++]
+        = (_sweep_prune_pair_t){proxy1, proxy2, false};
+    if (func != NULL) {
+        func(proxies[proxy1].obj, proxies[proxy2].obj, true, aux);
+    }
+}
+
+void _sweep_prune_remove_pair(sweep_prune_t *sweep_prune,
+                              uint32_t proxy1,
+                              uint32_t proxy2,
+                              sweep_prune_event_func_t func,
+                              void *aux) {
+    if (aabb_overlap(sweep_prune->proxies[proxy1].box,
+                     sweep_prune->proxies[proxy2].box)) {
+        return;
+    }
+    uint32_t idx
+        = _sweep_prune_table_get(&sweep_prune->pair_ids,
+                                 _sweep_prune_pair_key(proxy1, proxy2));
+    if (idx != _SWEEP_PRUNE_NONE) {
+        _sweep_prune_drop_pair(sweep_prune, idx, func, aux);
+    }
+}
+
+void _sweep_prune_drop_pair(sweep_prune_t *sweep_prune,
+                            size_t idx,
+                            sweep_prune_event_func_t func,
+                            void *aux) {
+    _sweep_prune_pair_t *pairs = sweep_prune->pairs;
+    _sweep_prune_pair_t pair = pairs[idx];
+    _sweep_prune_table_remove(&sweep_prune->pair_ids,
+                              _sweep_prune_pair_key(pair.proxy1, pair.proxy2));
+    // The last pair takes its place.
+    size_t last = --sweep_prune->n_pairs;
+    if (idx != last) {
+        pairs[idx] = pairs[last];
+        _sweep_prune_table_put(
+            &sweep_prune->pair_ids,
+            _sweep_prune_pair_key(pairs[idx].proxy1, pairs[idx].proxy2),
+            idx);
+    }
+    if (func != NULL) {
+        func(sweep_prune->proxies[pair.proxy1].obj,
+             sweep_prune->proxies[pair.proxy2].obj,
+             false,
+             aux);
+    }
+}
+
+void _sweep_prune_drop_unsynced(sweep_prune_t *sweep_prune,
+                                sweep_prune_event_func_t func,
+                                void *aux) {
+    _sweep_prune_proxy_t *proxies = sweep_prune->proxies;
+    size_t tick = sweep_prune->tick;
+    size_t n_dropped = 0;
+    for (size_t id = 0; id < sweep_prune->n_proxies; id++) {
+        n_dropped += proxies[id].alive && proxies[id].synced != tick;
+    }
+    if (n_dropped == 0) {
+        return;
+    }
+
+    // Backwards, so that the pairs moved into dropped pairs' places have
+    // already been looked at.
+    for (size_t i = sweep_prune->n_pairs; i-- > 0;) {
+        _sweep_prune_pair_t *pair = &sweep_prune->pairs[i];
+        if (proxies[pair->proxy1].synced != tick
+            || proxies[pair->proxy2].synced != tick) {
+            _sweep_prune_drop_pair(sweep_prune, i, func, aux);
+        }
+    }
+    for (size_t axis = 0; axis < _SWEEP_PRUNE_AXES; axis++) {
+        _sweep_prune_end_t *ends = sweep_prune->ends[axis];
+        size_t kept = 0;
+        for (size_t i = 0; i < sweep_prune->n_ends; i++) {
+            _sweep_prune_proxy_t *proxy = &proxies[ends[i].proxy];
+            if (proxy->synced == tick) {
+                proxy->ends[axis][ends[i].is_max] = kept;
+                ends[kept++] = ends[i];
+            }
+        }
+    }
+    sweep_prune->n_ends -= 2 * n_dropped;
+    for (size_t id = 0; id < sweep_prune->n_proxies; id++) {
+        _sweep_prune_proxy_t *proxy = &proxies[id];
+        if (!proxy->alive || proxy->synced == tick) {
+            continue;
+        }
+        // Unless a new object has taken its place.
+        uint64_t object_key = _sweep_prune_object_key(proxy->obj, proxy->side);
+        if (_sweep_prune_table_get(&sweep_prune->objects, object_key) == id) {
+            _sweep_prune_table_remove(&sweep_prune->objects, object_key);
+        }
+        proxy->alive = false;
+        sweep_prune->free_ids[sweep_prune->n_free_ids++] = id;
+        sweep_prune->size--;
+    }
+}
+
+void _sweep_prune_sort_axis(sweep_prune_t *sweep_prune,
+                            size_t axis,
+                            sweep_prune_event_func_t func,
+                            void *aux) {
+    _sweep_prune_end_t *ends = sweep_prune->ends[axis];
+    _sweep_prune_proxy_t *proxies = sweep_prune->proxies;
+    for (size_t i = 1; i < sweep_prune->n_ends; i++) {
+        _sweep_prune_end_t end = ends[i];
+        size_t j = i;
+        while (j > 0 && _sweep_prune_end_before(&end, &ends[j - 1])) {
+            _sweep_prune_end_t *other = &ends[j - 1];
+            if (!end.is_max && other->is_max) {
+                _sweep_prune_add_pair(sweep_prune,
+                                      end.proxy,
+                                      other->proxy,
+                                      func,
+                                      aux);
+            } else if (end.is_max && !other->is_max) {
+                _sweep_prune_remove_pair(sweep_prune,
+                                         end.proxy,
+                                         other->proxy,
+                                         func,
+                                         aux);
+            }
+            ends[j] = *other;
+            proxies[other->proxy].ends[axis][other->is_max] = j;
+            j--;
+        }
+        ends[j] = end;
+        proxies[end.proxy].ends[axis][end.is_max] = j;
+    }
+}
+
+int _sweep_prune_end_cmp(const void *end1, const void *end2) {
+    const _sweep_prune_end_t *e1 = end1;
+    const _sweep_prune_end_t *e2 = end2;
+    if (e1->value != e2->value) {
+        return e1->value < e2->value ? -1 : 1;
+    }
+    if (e1->is_max != e2->is_max) {
+        return e1->is_max ? 1 : -1;
+    }
+    return e1->proxy < e2->proxy ? -1 : e1->proxy > e2->proxy;
+}
+
+void _sweep_prune_rebuild(sweep_prune_t *sweep_prune,
+                          sweep_prune_event_func_t func,
+                          void *aux) {
+    _sweep_prune_proxy_t *proxies = sweep_prune->proxies;
+    for (size_t axis = 0; axis < _SWEEP_PRUNE_AXES; axis++) {
+        _sweep_prune_end_t *ends = sweep_prune->ends[axis];
+        qsort(ends,
+              sweep_prune->n_ends,
+              sizeof(_sweep_prune_end_t),
+              _sweep_prune_end_cmp);
+        for (size_t i = 0; i < sweep_prune->n_ends; i++) {
+            proxies[ends[i].proxy].ends[axis][ends[i].is_max] = i;
+        }
+    }
+
+    // Backwards, as in _sweep_prune_drop_unsynced.
+    for (size_t i = sweep_prune->n_pairs; i-- > 0;) {
+        _sweep_prune_pair_t *pair = &sweep_prune->pairs[i];
+        if (!aabb_overlap(proxies[pair->proxy1].box,
+                          proxies[pair->proxy2].box)) {
+            _sweep_prune_drop_pair(sweep_prune, i, func, aux);
+        }
+    }
+
+    // Sweep along x, keeping the boxes that the sweep line is in. This is
+    // rare, so the buffers aren't kept.
+    uint32_t *active = malloc(sweep_prune->size * sizeof(uint32_t));
+    size_t *active_idx = malloc(sweep_prune->n_proxies * sizeof(size_t));
+    assert((active != NULL || sweep_prune->size == 0)
+           && (active_idx != NULL || sweep_prune->n_proxies == 0));
+    size_t active_count = 0;
+    _sweep_prune_end_t *ends = sweep_prune->ends[0];
+    for (size_t i = 0; i < sweep_prune->n_ends; i++) {
+        uint32_t proxy = ends[i].proxy;
+        if (ends[i].is_max) {
+            // The last active box takes its place.
+            size_t idx = active_idx[proxy];
+            active[idx] = active[--active_count];
+            active_idx[active[idx]] = idx;
+            continue;
+        }
+        for (size_t j = 0; j < active_count; j++) {
+            _sweep_prune_add_pair(sweep_prune, active[j], proxy, func, aux);
+        }
+        active_idx[proxy] = active_count;
+        active[active_count++] = proxy;
+    }
+    free(active);
+    free(active_idx);
+}
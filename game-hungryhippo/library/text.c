@@ -4,12 +4,51 @@
 /*** PRIVATE CONSTS ***/
 const char *_FONT_PATHS[TEXT_STYLE_COUNT]
     = {"static/font/UbuntuMono-R.ttf", "static/font/UbuntuMono-B.ttf"};
+// Glyphs are cached for printable ASCII; anything else is drawn as '?'.
+#define _TEXT_GLYPH_FIRST ' '
+#define _TEXT_GLYPH_LAST '~'
+#define _TEXT_GLYPH_COUNT (_TEXT_GLYPH_LAST - _TEXT_GLYPH_FIRST + 1)
+// Glyph sheets are laid out in a grid this many glyphs wide.
+const int _TEXT_GLYPH_COLS = 16;
+const int _TEXT_VERTICES_PER_CHAR = 6; // Two triangles.
 
 /*** PRIVATE GLOBALS ***/
 int _text_count = 0;
+/**
+ * Every font in use, shared by all texts with the same style and height.
+ */
+list_t *_text_fonts = NULL;
 
 /*** STRUCTURES ***/
 
+/**
+ * A font with every glyph rasterized once, in white, into one texture.
+ * Strings are drawn as a quad per character, tinted with the text's color.
+ */
+typedef struct _text_font {
+    text_style_t style;
+    int height;
+    size_t ref_count;
+    TTF_Font *font; // NULL if headless, as is 'glyphs'.
+    int line_height;
+    SDL_Texture *glyphs;
+    SDL_Point glyphs_dims;
+    SDL_Rect regions[_TEXT_GLYPH_COUNT]; // Of each glyph in 'glyphs'.
+    int advances[_TEXT_GLYPH_COUNT];
+} _text_font_t;
+
+/**
+ * A string laid out as glyph quads, which are only rebuilt when the string or
+ * its position changes.
+ */
+typedef struct _text_cell {
+    char *str;
+    SDL_Point topleft;
+    SDL_Vertex *vertices;
+    size_t vertex_count;
+    size_t vertex_capacity;
+} _text_cell_t;
+
 struct text_tab {
     SDL_Point topleft; // Top left of table in screen coordinates.
     int row_height; // In pixels (i.e. screen proportions). Also used for font.
@@ -23,67 +62,279 @@ typedef struct _text_col {
     int width;
     text_col_func_t func;
     SDL_Color color;
-    TTF_Font *font;
+    _text_font_t *font;
+    list_t *cells; // Of each row rendered so far, top to bottom.
 } _text_col_t;
 
 struct text_ln {
     SDL_Point center;
     int height;
-    char *str;
     SDL_Color color;
-    TTF_Font *font;
+    _text_font_t *font;
+    _text_cell_t *cell;
     bool removed;
 };
 
 /*** PRIVATE PROTOTYPES ***/
-void _text_render_cell(char *s,
-                       TTF_Font *font,
-                       SDL_Color color,
-                       SDL_Rect *rect);
 _text_col_t *_text_col_init(int left,
                             int width,
                             text_col_func_t func,
                             SDL_Color color,
-                            TTF_Font *font);
+                            _text_font_t *font);
 void _text_col_free(_text_col_t *col);
-TTF_Font *_text_init_font(text_style_t style, int height);
+
+/**
+ * Return the shared font for 'style' at 'height', loading it and rasterizing
+ * its glyphs if nobody is using it yet. Release it with '_text_font_release'.
+ */
+_text_font_t *_text_font_acquire(text_style_t style, int height);
+void _text_font_release(_text_font_t *font);
+
+/**
+ * Return the index of the glyph drawn for the character 'c'.
+ */
+size_t _text_font_glyph_idx(char c);
+
+/**
+ * Return the width of 's' in pixels when drawn in 'font'.
+ */
+int _text_font_measure(_text_font_t *font, const char *s);
+
+_text_cell_t *_text_cell_init();
+void _text_cell_free(_text_cell_t *cell);
+
+/**
+ * Lay out 's' with its top left at 'topleft', unless the cell already has that
+ * string at that position.
+ */
+void _text_cell_update(_text_cell_t *cell,
+                       _text_font_t *font,
+                       const char *s,
+                       SDL_Color color,
+                       SDL_Point topleft);
+void _text_cell_render(_text_cell_t *cell, _text_font_t *font);
 
 /*** DEFINITIONS ***/
-void _text_render_cell(char *s,
-                       TTF_Font *font,
+_text_font_t *_text_font_acquire(text_style_t style, int height) {
+    if (_text_fonts == NULL) {
+        _text_fonts = list_init(1, NULL);
+    }
+    for (size_t i = 0; i < list_size(_text_fonts); i++) {
+        _text_font_t *font = list_get(_text_fonts, i);
+        if (font->style == style && font->height == height) {
+            font->ref_count++;
+            return font;
+        }
+    }
+
+    _text_font_t *font = malloc(sizeof(_text_font_t));
+    assert(font != NULL);
+    font->style = style;
+    font->height = height;
+    font->ref_count = 1;
+    list_add(_text_fonts, font);
+    if (sdl_is_headless()) {
+        // Nothing is drawn, so don't load anything; strings take up no space.
+        font->font = NULL;
+        font->line_height = 0;
+        font->glyphs = NULL;
+        font->glyphs_dims = (SDL_Point){1, 1};
+        memset(font->regions, 0, sizeof(font->regions));
+        memset(font->advances, 0, sizeof(font->advances));
+        return font;
+    }
+    font->font = TTF_OpenFont(_FONT_PATHS[style], height);
+    sdl_handle_error("_text_font_acquire: TTF_OpenFont", font->font != NULL);
+    font->line_height = TTF_FontHeight(font->font);
+
+    // Rasterize every glyph, then lay them out in a grid of equal cells, with
+    // a pixel between them so that they don't bleed into each other.
+    SDL_Color white = {0xff, 0xff, 0xff, 0xff};
+    SDL_Surface *surfaces[_TEXT_GLYPH_COUNT];
+    SDL_Point cell_dims = {0, 0};
+    for (size_t i = 0; i < _TEXT_GLYPH_COUNT; i++) {
+        Uint16 c = _TEXT_GLYPH_FIRST + i;
+        surfaces[i] = TTF_RenderGlyph_Blended(font->font, c, white);
+        sdl_handle_error("_text_font_acquire: TTF_RenderGlyph_Blended",
+                         surfaces[i] != NULL);
+        sdl_handle_error("_text_font_acquire: TTF_GlyphMetrics",
+                         TTF_GlyphMetrics(font->font,
+                                          c,
+                                          NULL,
+                                          NULL,
+                                          NULL,
+                                          NULL,
+                                          &(font->advances[i]))
+                             == 0);
+        if (surfaces[i]->w + 1 > cell_dims.x) {
+            cell_dims.x = surfaces[i]->w + 1;
+        }
+        if (surfaces[i]->h + 1 > cell_dims.y) {
+            cell_dims.y = surfaces[i]->h + 1;
+        }
+    }
+    int rows = (_TEXT_GLYPH_COUNT + _TEXT_GLYPH_COLS - 1) / _TEXT_GLYPH_COLS;
+    font->glyphs_dims.x = cell_dims.x * _TEXT_GLYPH_COLS;
+    font->glyphs_dims.y = cell_dims.y * rows;
+    SDL_Surface *sheet
+        = SDL_CreateRGBSurfaceWithFormat(0,
+                                         font->glyphs_dims.x,
+                                         font->glyphs_dims.y,
+                                         32,
+                                         SDL_PIXELFORMAT_RGBA32);
+    sdl_handle_error("_text_font_acquire: SDL_CreateRGBSurfaceWithFormat",
+                     sheet != NULL);
+    for (size_t i = 0; i < _TEXT_GLYPH_COUNT; i++) {
+        SDL_Rect *region = &(font->regions[i]);
+        region->x = (i % _TEXT_GLYPH_COLS) * cell_dims.x;
+        region->y = (i / _TEXT_GLYPH_COLS) * cell_dims.y;
+        region->w = surfaces[i]->w;
+        region->h = surfaces[i]->h;
+        SDL_SetSurfaceBlendMode(surfaces[i], SDL_BLENDMODE_NONE);
+        sdl_handle_error("_text_font_acquire: SDL_BlitSurface",
+                         SDL_BlitSurface(surfaces[i], NULL, sheet, region)
+                             == 0);
+        SDL_FreeSurface(surfaces[i]);
+    }
+    font->glyphs = SDL_CreateTextureFromSurface(sdl_get_renderer(), sheet);
+    sdl_handle_error("_text_font_acquire: SDL_CreateTextureFromSurface",
+                     font->glyphs != NULL);
+    SDL_SetTextureBlendMode(font->glyphs, SDL_BLENDMODE_BLEND);
+    SDL_FreeSurface(sheet);
+    return font;
+}
+
+void _text_font_release(_text_font_t *font) {
+    assert(font->ref_count > 0);
+    if (--font->ref_count > 0) {
+        return;
+    }
+    for (size_t i = 0; i < list_size(_text_fonts); i++) {
+        if (list_get(_text_fonts, i) == font) {
+            list_remove(_text_fonts, i);
+            break;
+        }
+    }
+    if (list_size(_text_fonts) == 0) {
+        list_free(_text_fonts);
+        _text_fonts = NULL;
+    }
+    if (font->font != NULL) {
+        SDL_DestroyTexture(font->glyphs);
+        TTF_CloseFont(font->font);
+    }
+    free(font);
+}
+
+size_t _text_font_glyph_idx(char c) {
+    if (c < _TEXT_GLYPH_FIRST || c > _TEXT_GLYPH_LAST) {
+        c = '?';
+    }
+    return c - _TEXT_GLYPH_FIRST;
+}
+
+int _text_font_measure(_text_font_t *font, const char *s) {
+    int width = 0;
+    for (; *s != '\0'; s++) {
+        width += font->advances[_text_font_glyph_idx(*s)];
+    }
+    return width;
+}
+
+_text_cell_t *_text_cell_init() {
+    _text_cell_t *cell = malloc(sizeof(_text_cell_t));
+    assert(cell != NULL);
+    cell->str = NULL;
+    cell->topleft = (SDL_Point){0, 0};
+    cell->vertices = NULL;
+    cell->vertex_count = 0;
+    cell->vertex_capacity = 0;
+    return cell;
+}
+
+void _text_cell_free(_text_cell_t *cell) {
+    free(cell->str);
+    free(cell->vertices);
+    free(cell);
+}
+
+void _text_cell_update(_text_cell_t *cell,
+                       _text_font_t *font,
+                       const char *s,
                        SDL_Color color,
-                       SDL_Rect *rect) {
-    SDL_Surface *surface = TTF_RenderText_Solid(font, s, color);
-    sdl_handle_error("text_render_cell: TTF_RenderText_Solid", surface != NULL);
-    SDL_Texture *tex
-        = SDL_CreateTextureFromSurface(sdl_get_renderer(), surface);
-    sdl_handle_error("_text_render_cell: SDL_CreateTextureFromSurface",
-                     tex != NULL);
-    sdl_handle_error("_text_render_cell: SDL_RenderCopy",
-                     SDL_RenderCopy(sdl_get_renderer(), tex, NULL, rect) == 0);
-    SDL_FreeSurface(surface);
-    SDL_DestroyTexture(tex);
+                       SDL_Point topleft) {
+    if (cell->str != NULL && strcmp(cell->str, s) == 0
+        && cell->topleft.x == topleft.x && cell->topleft.y == topleft.y) {
+        return;
+    }
+    free(cell->str);
+    cell->str = strdup(s);
+    assert(cell->str != NULL);
+    cell->topleft = topleft;
+
+    size_t len = strlen(s);
+    if (len * _TEXT_VERTICES_PER_CHAR > cell->vertex_capacity) {
+        cell->vertex_capacity = len * _TEXT_VERTICES_PER_CHAR;
+        cell->vertices = realloc(cell->vertices,
+                                 sizeof(SDL_Vertex) * cell->vertex_capacity);
+        assert(cell->vertices != NULL);
+    }
+
+    // Corners of each quad, as two anticlockwise (on screen) triangles.
+    const int corner_xs[6] = {0, 0, 1, 0, 1, 1};
+    const int corner_ys[6] = {0, 1, 1, 0, 1, 0};
+    SDL_Vertex *vertex = cell->vertices;
+    int pen = topleft.x;
+    for (size_t i = 0; i < len; i++) {
+        size_t glyph = _text_font_glyph_idx(s[i]);
+        SDL_Rect region = font->regions[glyph];
+        for (size_t k = 0; k < _TEXT_VERTICES_PER_CHAR; k++) {
+            int dx = corner_xs[k] * region.w, dy = corner_ys[k] * region.h;
+            vertex->position.x = pen + dx;
+            vertex->position.y = topleft.y + dy;
+            vertex->color = color;
+            vertex->tex_coord.x = (float)(region.x + dx) / font->glyphs_dims.x;
+            vertex->tex_coord.y = (float)(region.y + dy) / font->glyphs_dims.y;
+            vertex++;
+        }
+        pen += font->advances[glyph];
+    }
+    cell->vertex_count = len * _TEXT_VERTICES_PER_CHAR;
+}
+
+void _text_cell_render(_text_cell_t *cell, _text_font_t *font) {
+    if (cell->vertex_count == 0 || font->glyphs == NULL) {
+        return;
+    }
+    sdl_handle_error("_text_cell_render: SDL_RenderGeometry",
+                     SDL_RenderGeometry(sdl_get_renderer(),
+                                        font->glyphs,
+                                        cell->vertices,
+                                        cell->vertex_count,
+                                        NULL,
+                                        0)
+                         == 0);
 }
 
 void text_tab_render(text_tab_t *tab) {
     size_t row_cnt = tab->max_rows < list_size(tab->datas)
                          ? tab->max_rows
                          : list_size(tab->datas);
+    char s[TEXT_CELL_SIZE];
     // Loop through cols.
     for (size_t col_idx = 0; col_idx < list_size(tab->cols); col_idx++) {
         _text_col_t *col = list_get(tab->cols, col_idx);
+        while (list_size(col->cells) < row_cnt) {
+            list_add(col->cells, _text_cell_init());
+        }
         // Loop through rows.
         for (size_t row_idx = 0; row_idx < row_cnt; row_idx++) {
-            char *s = col->func(list_get(tab->datas, row_idx));
-            SDL_Rect *rect = malloc(sizeof(SDL_Rect));
-            rect->x = col->left;
-            rect->y = tab->topleft.y + row_idx * tab->row_height;
-            sdl_handle_error("text_tab_render: TTF_SizeText",
-                             TTF_SizeText(col->font, s, &(rect->w), &(rect->h))
-                                 == 0);
-            _text_render_cell(s, col->font, col->color, rect);
-            free(rect);
-            free(s);
+            col->func(list_get(tab->datas, row_idx), s, sizeof(s));
+            _text_cell_t *cell = list_get(col->cells, row_idx);
+            SDL_Point topleft
+                = {col->left, tab->topleft.y + row_idx * tab->row_height};
+            _text_cell_update(cell, col->font, s, col->color, topleft);
+            _text_cell_render(cell, col->font);
         }
     }
 }
@@ -109,7 +360,7 @@ text_tab_t *text_tab_init(list_t *datas,
 }
 
 void text_tab_free(text_tab_t *tab) {
-    list_free(tab->cols);
+    list_free(tab->cols); // Releases the fonts before TTF_Quit.
     free(tab);
     _text_count--;
 
@@ -119,17 +370,12 @@ void text_tab_free(text_tab_t *tab) {
     }
 }
 
-TTF_Font *_text_init_font(text_style_t style, int height) {
-    return TTF_OpenFont(_FONT_PATHS[style], height);
-}
-
 void text_tab_add_col(text_tab_t *tab,
                       int width,
                       text_col_func_t func,
                       SDL_Color color,
                       text_style_t style) {
-    TTF_Font *font = _text_init_font(style, tab->row_height);
-    sdl_handle_error("text_tab_add_col: _text_init_font", font != NULL);
+    _text_font_t *font = _text_font_acquire(style, tab->row_height);
     int left = tab->topleft.x;
     for (size_t i = 0; i < list_size(tab->cols); i++) {
         left += ((_text_col_t *)list_get(tab->cols, i))->width;
@@ -142,7 +388,7 @@ _text_col_t *_text_col_init(int left,
                             int width,
                             text_col_func_t func,
                             SDL_Color color,
-                            TTF_Font *font) {
+                            _text_font_t *font) {
     _text_col_t *col = malloc(sizeof(_text_col_t));
     assert(col != NULL);
     col->left = left;
@@ -150,11 +396,13 @@ _text_col_t *_text_col_init(int left,
     col->func = func;
     col->font = font;
     col->color = color;
+    col->cells = list_init(1, (free_func_t)_text_cell_free);
     return col;
 }
 
 void _text_col_free(_text_col_t *col) {
-    TTF_CloseFont(col->font);
+    list_free(col->cells);
+    _text_font_release(col->font);
     free(col);
 }
 
@@ -177,8 +425,8 @@ text_ln_t *text_ln_init(char *str,
     ln->center = sdl_sce_to_scr_coord(center);
     ln->height = height;
     ln->color = color;
-    ln->font = _text_init_font(style, height);
-    ln->str = calloc(1, sizeof(char));
+    ln->font = _text_font_acquire(style, height);
+    ln->cell = _text_cell_init();
     text_ln_update(ln, str);
     ln->removed = false;
     _text_count++;
@@ -194,8 +442,8 @@ bool text_ln_is_removed(text_ln_t *text_ln) {
 }
 
 void text_ln_free(text_ln_t *text_ln) {
-    free(text_ln->str);
-    TTF_CloseFont(text_ln->font);
+    _text_cell_free(text_ln->cell);
+    _text_font_release(text_ln->font);
     free(text_ln);
     _text_count--;
 
@@ -206,20 +454,17 @@ void text_ln_free(text_ln_t *text_ln) {
 }
 
 void text_ln_render(text_ln_t *text_ln) {
-    SDL_Rect *rect = malloc(sizeof(SDL_Rect));
-    assert(rect != NULL);
-    sdl_handle_error(
-        "text_ln_render: TTF_SizeText",
-        TTF_SizeText(text_ln->font, text_ln->str, &(rect->w), &(rect->h)) == 0);
-    rect->x = text_ln->center.x - rect->w / 2;
-    rect->y = text_ln->center.y - rect->h / 2;
-    _text_render_cell(text_ln->str, text_ln->font, text_ln->color, rect);
-    free(rect);
+    _text_cell_render(text_ln->cell, text_ln->font);
 }
 
 void text_ln_update(text_ln_t *text_ln, char *str) {
-    free(text_ln->str);
-    text_ln->str = calloc(strlen(str) + 1, sizeof(char));
-    assert(text_ln->str != NULL);
-    strcpy(text_ln->str, str);
+    // Only the width depends on the string; the glyphs are all the same height.
+    SDL_Point topleft
+        = {text_ln->center.x - _text_font_measure(text_ln->font, str) / 2,
+           text_ln->center.y - text_ln->font->line_height / 2};
+    _text_cell_update(text_ln->cell,
+                      text_ln->font,
+                      str,
+                      text_ln->color,
+                      topleft);
 }
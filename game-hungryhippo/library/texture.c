@@ -0,0 +1,162 @@
+#include "texture.h"
+#include "atlas.h"
+#include "list.h"
+#include "sdl_wrapper.h"
+#include <SDL2/SDL2_rotozoom.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*** STRUCTURES ***/
+
+struct texture {
+    char *img_path;
+    double scale;
+    size_t ref_count;
+    SDL_Texture *tex; // The texture's own, or NULL if it is in the atlas.
+    SDL_Rect region;
+};
+
+/*** GLOBALS ***/
+
+/**
+ * The atlas that textures are packed into when they fit, or NULL.
+ */
+atlas_t *_texture_atlas = NULL;
+
+/**
+ * Every texture with at least one reference. NULL while there are none.
+ */
+list_t *_texture_cache = NULL;
+
+/*** PRIVATE PROTOTYPES ***/
+
+/**
+ * Load the image at 'img_path' scaled by 'scale'. The caller frees it.
+ */
+SDL_Surface *_texture_load_surface(const char *img_path, double scale);
+
+/**
+ * Return the index of the cached texture for (img_path, scale), or the size of
+ * the cache if there is none.
+ */
+size_t _texture_cache_find(const char *img_path, double scale);
+
+/*** DEFINITIONS ***/
+
+SDL_Surface *_texture_load_surface(const char *img_path, double scale) {
+    SDL_Surface *surface_original = IMG_Load(img_path);
+    sdl_handle_error("texture_acquire: IMG_Load", surface_original != NULL);
+    SDL_Surface *surface
+        = rotozoomSurface(surface_original, 0, scale, SMOOTHING_ON);
+    SDL_FreeSurface(surface_original);
+    return surface;
+}
+
+size_t _texture_cache_find(const char *img_path, double scale) {
+    size_t i = 0;
+    for (; i < list_size(_texture_cache); i++) {
+        texture_t *texture = list_get(_texture_cache, i);
+        if (texture->scale == scale
+            && strcmp(texture->img_path, img_path) == 0) {
+            break;
+        }
+    }
+    return i;
+}
+
+void texture_set_atlas(atlas_t *atlas) {
+    _texture_atlas = atlas;
+}
+
+void texture_preload(const char *img_path, double scale) {
+    SDL_Rect region;
+    if (_texture_atlas == NULL
+        || atlas_find(_texture_atlas, img_path, scale, &region)) {
+        return;
+    }
+    SDL_Surface *surface = _texture_load_surface(img_path, scale);
+    atlas_add(_texture_atlas, img_path, scale, surface, &region);
+    SDL_FreeSurface(surface);
+}
+
+texture_t *texture_acquire(const char *img_path, double scale) {
+    if (_texture_cache == NULL) {
+        _texture_cache = list_init(1, NULL);
+    }
+    size_t idx = _texture_cache_find(img_path, scale);
+    if (idx < list_size(_texture_cache)) {
+        texture_t *texture = list_get(_texture_cache, idx);
+        texture->ref_count++;
+        return texture;
+    }
+
+    texture_t *texture = malloc(sizeof(texture_t));
+    assert(texture != NULL);
+    texture->img_path = strdup(img_path);
+    assert(texture->img_path != NULL);
+    texture->scale = scale;
+    texture->ref_count = 1;
+    texture->tex = NULL;
+    if (_texture_atlas == NULL
+        || !atlas_find(_texture_atlas, img_path, scale, &(texture->region))) {
+        SDL_Surface *surface = _texture_load_surface(img_path, scale);
+        if (_texture_atlas == NULL
+            || !atlas_add(_texture_atlas,
+                          img_path,
+                          scale,
+                          surface,
+                          &(texture->region))) {
+            // Too big for, or no room left in, the atlas.
+            texture->tex
+                = SDL_CreateTextureFromSurface(sdl_get_renderer(), surface);
+            sdl_handle_error("texture_acquire: SDL_CreateTextureFromSurface",
+                             texture->tex != NULL);
+            texture->region = (SDL_Rect){0, 0, surface->w, surface->h};
+        }
+        SDL_FreeSurface(surface);
+    }
+    list_add(_texture_cache, texture);
+    return texture;
+}
+
+void texture_release(texture_t *texture) {
+    assert(texture->ref_count > 0);
+    if (--texture->ref_count > 0) {
+        return;
+    }
+    list_remove(_texture_cache,
+                _texture_cache_find(texture->img_path, texture->scale));
+    if (list_size(_texture_cache) == 0) {
+        list_free(_texture_cache);
+        _texture_cache = NULL;
+    }
+    // Images in the atlas stay there, so reacquiring them is still cheap.
+    if (texture->tex != NULL) {
+        SDL_DestroyTexture(texture->tex);
+    }
+    free(texture->img_path);
+    free(texture);
+}
+
+bool texture_in_atlas(texture_t *texture) {
+    return texture->tex == NULL;
+}
+
+SDL_Texture *texture_get_sdl(texture_t *texture) {
+    if (texture->tex != NULL) {
+        return texture->tex;
+    }
+    return atlas_get_texture(_texture_atlas, sdl_get_renderer());
+}
+
+SDL_Point texture_get_sdl_dims(texture_t *texture) {
+    if (texture->tex != NULL) {
+        return (SDL_Point){texture->region.w, texture->region.h};
+    }
+    return atlas_get_dims(_texture_atlas);
+}
+
+SDL_Rect texture_get_region(texture_t *texture) {
+    return texture->region;
+}
@@ -0,0 +1,171 @@
+#include "thread_pool.h"
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#ifdef _WIN32
+// There are no POSIX threads with MSVC, so every pool is just the caller.
+
+/*** STRUCTURES ***/
+
+struct thread_pool {
+    size_t thread_count;
+};
+
+/*** DEFINITIONS ***/
+
+thread_pool_t *thread_pool_init(size_t thread_count) {
+    assert(thread_count > 0);
+    thread_pool_t *pool = malloc(sizeof(thread_pool_t));
+    assert(pool != NULL);
+    pool->thread_count = 1;
+    return pool;
+}
+
+void thread_pool_free(thread_pool_t *pool) {
+    free(pool);
+}
+
+void thread_pool_run(thread_pool_t *pool, thread_pool_func_t func, void *aux) {
+    func(aux, 0, 1);
+}
+
+size_t thread_pool_size(thread_pool_t *pool) {
+    return pool->thread_count;
+}
+
+#else
+#include <pthread.h>
+
+/*** STRUCTURES ***/
+
+typedef struct _thread_pool_worker {
+    thread_pool_t *pool;
+    size_t idx;
+    pthread_t thread;
+} _thread_pool_worker_t;
+
+struct thread_pool {
+    size_t thread_count;
+    _thread_pool_worker_t *workers; // thread_count - 1, for indices 1 onwards.
+    pthread_mutex_t mutex;
+    pthread_cond_t start; // Signalled when there is a new run, or to quit.
+    pthread_cond_t done;  // Signalled when the last worker finishes a run.
+    // The rest is protected by the mutex.
+    thread_pool_func_t func;
+    void *aux;
+    size_t run_count; // Runs started so far, so workers can tell a new one.
+    size_t running;   // Workers that have yet to finish the current run.
+    bool quitting;
+};
+
+/*** PRIVATE PROTOTYPES ***/
+
+void *_thread_pool_work(_thread_pool_worker_t *worker);
+
+/*** DEFINITIONS ***/
+
+thread_pool_t *thread_pool_init(size_t thread_count) {
+    assert(thread_count > 0);
+    thread_pool_t *pool = malloc(sizeof(thread_pool_t));
+    assert(pool != NULL);
+    pool->thread_count = thread_count;
+    pool->func = NULL;
+    pool->aux = NULL;
+    pool->run_count = 0;
+    pool->running = 0;
+    pool->quitting = false;
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->done, NULL);
+
+    pool->workers = malloc((thread_count - 1) * sizeof(_thread_pool_worker_t));
+    assert(pool->workers != NULL || thread_count == 1);
+    for (size_t i = 0; i < thread_count - 1; i++) {
+        _thread_pool_worker_t *worker = &pool->workers[i];
+        worker->pool = pool;
+        worker->idx = i + 1;
+        if (pthread_create(&worker->thread,
+                           NULL,
+                           (void *(*)(void *))_thread_pool_work,
+                           worker)
+            != 0) {
+            fprintf(stderr, "Fatal error: thread_pool_init: cannot start.\n");
+            exit(1);
+        }
+    }
+    return pool;
+}
+
+void thread_pool_free(thread_pool_t *pool) {
+    pthread_mutex_lock(&pool->mutex);
+    pool->quitting = true;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->mutex);
+    for (size_t i = 0; i < pool->thread_count - 1; i++) {
+        pthread_join(pool->workers[i].thread, NULL);
+    }
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->start);
+    pthread_mutex_destroy(&pool->mutex);
+    free(pool->workers);
+    free(pool);
+}
+
+void thread_pool_run(thread_pool_t *pool, thread_pool_func_t func, void *aux) {
+    if (pool->thread_count == 1) {
+        func(aux, 0, 1);
+        return;
+    }
+
+    pthread_mutex_lock(&pool->mutex);
+    assert(pool->running == 0);
+    pool->func = func;
+    pool->aux = aux;
+    pool->running = pool->thread_count - 1;
+    pool->run_count++;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->mutex);
+
+    func(aux, 0, pool->thread_count);
+
+    pthread_mutex_lock(&pool->mutex);
+    while (pool->running > 0) {
+        pthread_cond_wait(&pool->done, &pool->mutex);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+}
+
+size_t thread_pool_size(thread_pool_t *pool) {
+    return pool->thread_count;
+}
+
+void *_thread_pool_work(_thread_pool_worker_t *worker) {
+    thread_pool_t *pool = worker->pool;
+    size_t runs_seen = 0;
+    pthread_mutex_lock(&pool->mutex);
+    while (true) {
+        while (pool->run_count == runs_seen && !pool->quitting) {
+            pthread_cond_wait(&pool->start, &pool->mutex);
+        }
+        if (pool->quitting) {
+            break;
+        }
+        runs_seen = pool->run_count;
+        thread_pool_func_t func = pool->func;
+        void *aux = pool->aux;
+        pthread_mutex_unlock(&pool->mutex);
+
+        func(aux, worker->idx, pool->thread_count);
+
+        pthread_mutex_lock(&pool->mutex);
+        pool->running--;
+        if (pool->running == 0) {
+            pthread_cond_signal(&pool->done);
+        }
+    }
+    pthread_mutex_unlock(&pool->mutex);
+    return NULL;
+}
+
+#endif // #ifdef _WIN32
@@ -0,0 +1,282 @@
+#include "timer_wheel.h"
+#include <assert.h>
+#include <math.h>
+#include <stdbool.h>
+
+/*** PRIVATE CONSTS ***/
+
+// Each level has 2^_TIMER_WHEEL_BITS slots, and each slot of a level spans a
+// whole turn of the level below, so four levels of 64 slots reach about 4.6
+// hours ahead. Timers further away wait in the last level and are placed again
+// as they come closer.
+#define _TIMER_WHEEL_BITS 6
+#define _TIMER_WHEEL_SLOTS (1 << _TIMER_WHEEL_BITS)
+#define _TIMER_WHEEL_LEVELS 4
+const uint64_t _TIMER_WHEEL_MASK = _TIMER_WHEEL_SLOTS - 1;
+const uint64_t _TIMER_WHEEL_SPAN = (uint64_t)1
+                                   << (_TIMER_WHEEL_BITS * _TIMER_WHEEL_LEVELS);
+
+/*** STRUCTURES ***/
+
+struct wheel_timer {
+    wheel_timer_t *prev;
+    wheel_timer_t *next;
+    uint64_t expires; // Milliseconds.
+    uint64_t seq;     // When the timer was (re-)armed, to break ties.
+    uint32_t interval;
+    wheel_timer_func_t func;
+    void *aux;
+};
+
+struct timer_wheel {
+    // Sentinels of circular doubly linked lists of timers, so that any timer
+    // can be unlinked in constant time without knowing where it is.
+    wheel_timer_t slots[_TIMER_WHEEL_LEVELS][_TIMER_WHEEL_SLOTS];
+    wheel_timer_t expired;  // Due now but not yet called.
+    wheel_timer_t *spare;   // Recycled timers, linked by 'next'.
+    wheel_timer_t *firing;  // Timer whose callback is running, if any.
+    bool firing_cancelled;  // Whether 'firing' was cancelled by its callback.
+    uint64_t now;           // Milliseconds.
+    double fraction;        // Milliseconds advanced past 'now'.
+    size_t size;
+    uint64_t next_seq;
+};
+
+/*** PRIVATE PROTOTYPES ***/
+
+void _timer_wheel_list_init(wheel_timer_t *sentinel);
+bool _timer_wheel_list_empty(wheel_timer_t *sentinel);
+void _timer_wheel_link(wheel_timer_t *sentinel, wheel_timer_t *timer);
+void _timer_wheel_unlink(wheel_timer_t *timer);
+
+/**
+ * Link a timer into the slot it belongs in given its expiry, keeping the slot
+ * sorted by 'seq'. Timers are usually armed last, so this is usually at the
+ * end, but cascading brings older timers down among newer ones.
+ */
+void _timer_wheel_place(timer_wheel_t *wheel, wheel_timer_t *timer);
+
+/**
+ * Put a timer that is no longer linked anywhere aside for reuse.
+ */
+void _timer_wheel_recycle(timer_wheel_t *wheel, wheel_timer_t *timer);
+
+/**
+ * Release every timer in a list.
+ */
+void _timer_wheel_recycle_list(timer_wheel_t *wheel, wheel_timer_t *sentinel);
+
+/**
+ * Advance by one millisecond.
+ */
+void _timer_wheel_step(timer_wheel_t *wheel);
+
+/*** DEFINITIONS ***/
+
+void _timer_wheel_list_init(wheel_timer_t *sentinel) {
+    sentinel->prev = sentinel;
+    sentinel->next = sentinel;
+}
+
+bool _timer_wheel_list_empty(wheel_timer_t *sentinel) {
+    return sentinel->next == sentinel;
+}
+
+void _timer_wheel_link(wheel_timer_t *sentinel, wheel_timer_t *timer) {
+    timer->prev = sentinel->prev;
+    timer->next = sentinel;
+    sentinel->prev->next = timer;
+    sentinel->prev = timer;
+}
+
+void _timer_wheel_unlink(wheel_timer_t *timer) {
+    timer->prev->next = timer->next;
+    timer->next->prev = timer->prev;
+    timer->prev = NULL;
+    timer->next = NULL;
+}
+
+timer_wheel_t *timer_wheel_init(void) {
+    timer_wheel_t *wheel = malloc(sizeof(timer_wheel_t));
+    assert(wheel != NULL);
+    for (size_t level = 0; level < _TIMER_WHEEL_LEVELS; level++) {
+        for (size_t slot = 0; slot < _TIMER_WHEEL_SLOTS; slot++) {
+            _timer_wheel_list_init(&wheel->slots[level][slot]);
+        }
+    }
+    _timer_wheel_list_init(&wheel->expired);
+    wheel->spare = NULL;
+    wheel->firing = NULL;
+    wheel->firing_cancelled = false;
+    wheel->now = 0;
+    wheel->fraction = 0;
+    wheel->size = 0;
+    wheel->next_seq = 0;
+    return wheel;
+}
+
+void timer_wheel_free(timer_wheel_t *wheel) {
+    assert(wheel->firing == NULL);
+    timer_wheel_cancel_all(wheel);
+    while (wheel->spare != NULL) {
+        wheel_timer_t *next = wheel->spare->next;
+        free(wheel->spare);
+        wheel->spare = next;
+    }
+    free(wheel);
+}
+
+wheel_timer_t *timer_wheel_add(timer_wheel_t *wheel,
+                               uint32_t interval,
+                               wheel_timer_func_t func,
+                               void *aux) {
+    wheel_timer_t *timer = wheel->spare;
+    if (timer != NULL) {
+        wheel->spare = timer->next;
+    } else {
+        timer = malloc(sizeof(wheel_timer_t));
+        assert(timer != NULL);
+    }
+    if (interval == 0) {
+        interval = 1;
+    }
+    timer->expires = wheel->now + interval;
+    timer->interval = interval;
+    timer->func = func;
+    timer->aux = aux;
+    timer->seq = wheel->next_seq++;
+    _timer_wheel_place(wheel, timer);
+    wheel->size++;
+    return timer;
+}
+
+void timer_wheel_cancel(timer_wheel_t *wheel, wheel_timer_t *timer) {
+    if (timer == wheel->firing) {
+        wheel->firing_cancelled = true;
+        return;
+    }
+    _timer_wheel_unlink(timer);
+    _timer_wheel_recycle(wheel, timer);
+    wheel->size--;
+}
+
+void timer_wheel_cancel_all(timer_wheel_t *wheel) {
+    for (size_t level = 0; level < _TIMER_WHEEL_LEVELS; level++) {
+        for (size_t slot = 0; slot < _TIMER_WHEEL_SLOTS; slot++) {
+            _timer_wheel_recycle_list(wheel, &wheel->slots[level][slot]);
+        }
+    }
+    _timer_wheel_recycle_list(wheel, &wheel->expired);
+    if (wheel->firing != NULL) {
+        wheel->firing_cancelled = true;
+    }
+    wheel->size = 0;
+}
+
+void timer_wheel_advance(timer_wheel_t *wheel, double seconds) {
+    assert(seconds >= 0);
+    wheel->fraction += seconds * 1000;
+    double whole = floor(wheel->fraction);
+    wheel->fraction -= whole;
+    uint64_t steps = whole;
+    if (wheel->size == 0) {
+        // Nothing can come due, and empty slots need no upkeep.
+        wheel->now += steps;
+        return;
+    }
+    for (uint64_t i = 0; i < steps; i++) {
+        _timer_wheel_step(wheel);
+    }
+}
+
+uint64_t timer_wheel_now(timer_wheel_t *wheel) {
+    return wheel->now;
+}
+
+size_t timer_wheel_size(timer_wheel_t *wheel) {
+    return wheel->size;
+}
+
+void _timer_wheel_place(timer_wheel_t *wheel, wheel_timer_t *timer) {
+    assert(timer->expires >= wheel->now);
+    uint64_t delta = timer->expires - wheel->now;
+    uint64_t expires = timer->expires;
+    if (delta >= _TIMER_WHEEL_SPAN) {
+        expires = wheel->now + _TIMER_WHEEL_SPAN - 1;
+        delta = _TIMER_WHEEL_SPAN - 1;
+    }
+    size_t level = 0;
+    while (delta >> (_TIMER_WHEEL_BITS * (level + 1)) != 0) {
+        level++;
+    }
+    size_t slot = (expires >> (_TIMER_WHEEL_BITS * level)) & _TIMER_WHEEL_MASK;
+    wheel_timer_t *sentinel = &wheel->slots[level][slot];
+    // Link before the first timer from the end that isn't newer.
+    wheel_timer_t *after = sentinel->prev;
+    while (after != sentinel && after->seq > timer->seq) {
+        after = after->prev;
+    }
+    _timer_wheel_link(after->next, timer);
+}
+
+void _timer_wheel_recycle(timer_wheel_t *wheel, wheel_timer_t *timer) {
+    timer->next = wheel->spare;
+    wheel->spare = timer;
+}
+
+void _timer_wheel_recycle_list(timer_wheel_t *wheel, wheel_timer_t *sentinel) {
+    while (!_timer_wheel_list_empty(sentinel)) {
+        wheel_timer_t *timer = sentinel->next;
+        _timer_wheel_unlink(timer);
+        _timer_wheel_recycle(wheel, timer);
+    }
+}
+
+void _timer_wheel_step(timer_wheel_t *wheel) {
+    wheel->now++;
+
+    // Whenever a level comes full circle, spread the next slot of the level
+    // above over the levels below, where all of its timers now fit.
+    for (size_t level = 1; level < _TIMER_WHEEL_LEVELS; level++) {
+        if (((wheel->now >> (_TIMER_WHEEL_BITS * (level - 1)))
+             & _TIMER_WHEEL_MASK)
+            != 0) {
+            break;
+        }
+        size_t slot
+            = (wheel->now >> (_TIMER_WHEEL_BITS * level)) & _TIMER_WHEEL_MASK;
+        wheel_timer_t *sentinel = &wheel->slots[level][slot];
+        while (!_timer_wheel_list_empty(sentinel)) {
+            wheel_timer_t *timer = sentinel->next;
+            _timer_wheel_unlink(timer);
+            _timer_wheel_place(wheel, timer);
+        }
+    }
+
+    // Move the due timers out of the wheel first, so that callbacks can add
+    // and cancel timers freely while we go through them.
+    wheel_timer_t *due = &wheel->slots[0][wheel->now & _TIMER_WHEEL_MASK];
+    while (!_timer_wheel_list_empty(due)) {
+        wheel_timer_t *timer = due->next;
+        _timer_wheel_unlink(timer);
+        _timer_wheel_link(&wheel->expired, timer);
+    }
+    while (!_timer_wheel_list_empty(&wheel->expired)) {
+        wheel_timer_t *timer = wheel->expired.next;
+        _timer_wheel_unlink(timer);
+        wheel->size--;
+        wheel->firing = timer;
+        wheel->firing_cancelled = false;
+        uint32_t interval = timer->func(timer->interval, timer->aux);
+        wheel->firing = NULL;
+        if (interval > 0 && !wheel->firing_cancelled) {
+            timer->interval = interval;
+            timer->expires = wheel->now + interval;
+            timer->seq = wheel->next_seq++;
+            _timer_wheel_place(wheel, timer);
+            wheel->size++;
+        } else {
+            _timer_wheel_recycle(wheel, timer);
+        }
+    }
+}
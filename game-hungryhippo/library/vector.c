@@ -1,4 +1,5 @@
 #include "vector.h"
+#include "alloc_stats.h"
 #include <assert.h>
 #include <math.h>
 #include <stdbool.h>
@@ -60,6 +61,7 @@ vector_t vec_rotate_relative(vector_t v, double angle, vector_t point) {
 
 vector_t *vec_p_copy(vector_t *v) {
     vector_t *vec_copy_obj = malloc(sizeof(vector_t));
+    ALLOC_STATS_ALLOC(VECTOR, sizeof(vector_t));
     vec_copy_obj->x = v->x;
     vec_copy_obj->y = v->y;
     return vec_copy_obj;
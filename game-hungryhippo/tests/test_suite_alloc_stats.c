@@ -0,0 +1,128 @@
+#include "alloc_stats.h"
+#include "body.h"
+#include "forces.h"
+#include "list.h"
+#include "physics.h"
+#include "test_util.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+void test_alloc_stats_ticks() {
+    alloc_stats_reset();
+    alloc_stats_alloc(ALLOC_SUBSYSTEM_SPRITE, 100);
+    alloc_stats_alloc(ALLOC_SUBSYSTEM_SPRITE, 20);
+    alloc_stats_live(ALLOC_SUBSYSTEM_SPRITE, 2);
+    alloc_stats_end_tick();
+    alloc_counts_t tick = alloc_stats_last_tick(ALLOC_SUBSYSTEM_SPRITE);
+    assert(tick.allocs == 2 && tick.bytes == 120 && tick.live == 2);
+
+    // Counts per tick start over, but totals and live objects carry on.
+    alloc_stats_alloc(ALLOC_SUBSYSTEM_SPRITE, 8);
+    alloc_stats_live(ALLOC_SUBSYSTEM_SPRITE, -1);
+    alloc_stats_end_tick();
+    tick = alloc_stats_last_tick(ALLOC_SUBSYSTEM_SPRITE);
+    assert(tick.allocs == 1 && tick.bytes == 8 && tick.live == 1);
+    alloc_counts_t total = alloc_stats_total(ALLOC_SUBSYSTEM_SPRITE);
+    assert(total.allocs == 3 && total.bytes == 128 && total.live == 1);
+    // Other subsystems are untouched.
+    total = alloc_stats_total(ALLOC_SUBSYSTEM_AUX);
+    assert(total.allocs == 0 && total.bytes == 0 && total.live == 0);
+    alloc_stats_reset();
+}
+
+void test_alloc_stats_report() {
+    alloc_stats_reset();
+    alloc_stats_alloc(ALLOC_SUBSYSTEM_BODY, 1000);
+    alloc_stats_end_tick();
+    alloc_stats_alloc(ALLOC_SUBSYSTEM_BODY, 10);
+    alloc_stats_alloc(ALLOC_SUBSYSTEM_BODY, 10);
+    alloc_stats_live(ALLOC_SUBSYSTEM_BODY, 3);
+    alloc_stats_end_tick();
+
+    char *report;
+    size_t size;
+    FILE *out = open_memstream(&report, &size);
+    alloc_stats_report(out, "round 1");
+    // A new period starts after each report.
+    alloc_stats_report(out, "round 2");
+    fclose(out);
+
+    char *round2 = strstr(report, "round 2");
+    assert(strstr(report, "Allocations in round 1, over 2 ticks:") != NULL);
+    assert(round2 != NULL);
+    // allocs, bytes, allocs/tick, max allocs, max bytes, live.
+    char *body = strstr(report, "\nbody ");
+    assert(body != NULL && body < round2);
+    size_t allocs, bytes, max_allocs, max_bytes, live;
+    double per_tick;
+    assert(sscanf(body,
+                  " body %zu %zu %lf %zu %zu %zu",
+                  &allocs,
+                  &bytes,
+                  &per_tick,
+                  &max_allocs,
+                  &max_bytes,
+                  &live)
+           == 6);
+    assert(allocs == 3 && bytes == 1020 && per_tick == 1.5);
+    assert(max_allocs == 2 && max_bytes == 1000 && live == 3);
+    assert(strstr(strstr(round2, "\nbody "), " 0 ") != NULL);
+    // Vectors can't count their live objects.
+    assert(strstr(report, "\nvector ") != NULL);
+    free(report);
+    alloc_stats_reset();
+}
+
+#ifdef ALLOC_STATS
+void test_alloc_stats_tagged_sites() {
+    alloc_stats_reset();
+    list_t *list = list_init(2, NULL);
+    alloc_counts_t lists = alloc_stats_total(ALLOC_SUBSYSTEM_LIST);
+    assert(lists.allocs == 2 && lists.live == 1);
+    for (size_t i = 0; i < 3; i++) {
+        list_add(list, list);
+    }
+    // The list grew once.
+    assert(alloc_stats_total(ALLOC_SUBSYSTEM_LIST).allocs == 3);
+    list_free(list);
+    assert(alloc_stats_total(ALLOC_SUBSYSTEM_LIST).live == 0);
+
+    // Typed force auxes count as live until the force is freed.
+    physics_t *physics = physics_init();
+    list_t *shape = list_init(1, free);
+    vector_t *v = malloc(sizeof(*v));
+    assert(v != NULL);
+    *v = VEC_ZERO;
+    list_add(shape, v);
+    body_t *body = body_init(shape, 1, (rgb_color_t){0, 0, 0});
+    list_t *group = list_init(1, NULL);
+    create_drag(physics, 1, body);
+    create_group_drag(physics, 1, group);
+    create_physics_collision_rule(physics, 1, group, group, NULL, NULL);
+    assert(alloc_stats_total(ALLOC_SUBSYSTEM_AUX).live == 3);
+    physics_free(physics);
+    assert(alloc_stats_total(ALLOC_SUBSYSTEM_AUX).live == 0);
+    list_free(group);
+    body_free(body);
+    alloc_stats_reset();
+}
+#endif
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_alloc_stats_ticks)
+    DO_TEST(test_alloc_stats_report)
+#ifdef ALLOC_STATS
+    DO_TEST(test_alloc_stats_tagged_sites)
+#endif
+
+    puts("alloc_stats_test PASS");
+}
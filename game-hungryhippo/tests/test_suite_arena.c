@@ -0,0 +1,67 @@
+#include "arena.h"
+#include "test_util.h"
+#include <assert.h>
+#include <stdalign.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+void test_arena_alloc() {
+    arena_t *arena = arena_init(64);
+    assert(arena_used(arena) == 0);
+
+    char *s = arena_alloc(arena, 3);
+    double *d = arena_alloc(arena, sizeof(double));
+    assert((uintptr_t)s % alignof(max_align_t) == 0);
+    assert((uintptr_t)d % alignof(max_align_t) == 0);
+    assert((char *)d >= s + 3);
+    strcpy(s, "hi");
+    *d = 1.5;
+    assert(strcmp(s, "hi") == 0 && *d == 1.5);
+    assert(arena_used(arena) >= 3 + sizeof(double));
+
+    arena_free(arena);
+}
+
+void test_arena_grow_and_reset() {
+    arena_t *arena = arena_init(16);
+
+    // Much more than the initial capacity, so the arena has to grow.
+    int *ints[100];
+    for (size_t i = 0; i < 100; i++) {
+        ints[i] = arena_alloc(arena, sizeof(int));
+        *ints[i] = i;
+    }
+    for (size_t i = 0; i < 100; i++) {
+        assert(*ints[i] == i);
+    }
+    size_t used = arena_used(arena);
+
+    // After a reset, the same allocations fit in one block, so they come back
+    // contiguously from the start.
+    arena_reset(arena);
+    assert(arena_used(arena) == 0);
+    char *first = arena_alloc(arena, sizeof(int));
+    for (size_t i = 1; i < 100; i++) {
+        char *curr = arena_alloc(arena, sizeof(int));
+        assert(curr == first + i * alignof(max_align_t));
+    }
+    assert(arena_used(arena) == used);
+
+    arena_free(arena);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_arena_alloc)
+    DO_TEST(test_arena_grow_and_reset)
+
+    puts("arena_test PASS");
+}
@@ -0,0 +1,175 @@
+#include "barnes_hut.h"
+#include "body.h"
+#include "forces.h"
+#include "list.h"
+#include "physics.h"
+#include "shapes_geometry.h"
+#include "test_util.h"
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+#define N_BODIES 500
+
+const double G = 1e3;
+
+/**
+ * Make a lumpy cloud of bodies, the same every time.
+ */
+list_t *make_bodies() {
+    srand(42);
+    list_t *bodies = list_init(N_BODIES, (free_func_t)body_free);
+    for (size_t i = 0; i < N_BODIES; i++) {
+        // A few clusters of different sizes.
+        double spread = 50.0 * (1 + i % 4);
+        vector_t cluster = {300.0 * (i % 3), 200.0 * (i % 5)};
+        vector_t offset = {spread * rand() / RAND_MAX,
+                           spread * rand() / RAND_MAX};
+        body_t *body = make_rectangle((rgb_color_t){0},
+                                      vec_add(cluster, offset),
+                                      2,
+                                      2,
+                                      1 + rand() % 10,
+                                      NULL,
+                                      NULL);
+        list_add(bodies, body);
+    }
+    return bodies;
+}
+
+/**
+ * How far the gravity from 'create_barnes_hut_gravity' is from the exact
+ * pairwise gravity.
+ */
+typedef struct gravity_error {
+    double worst; // Largest error, relative to the mean gravity on a body.
+    double mean;  // Mean error, each relative to the body's own gravity.
+} gravity_error_t;
+
+/**
+ * Return the errors in the velocities the Barnes-Hut force with the given
+ * theta gives after one tick, against those of the exact pairwise force.
+ */
+gravity_error_t gravity_error(double theta) {
+    list_t *exact = make_bodies();
+    list_t *approx = make_bodies();
+    physics_t *physics_exact = physics_init();
+    physics_t *physics_approx = physics_init();
+    physics_add_bodies(physics_exact, exact);
+    physics_add_bodies(physics_approx, approx);
+    for (size_t i = 0; i < N_BODIES; i++) {
+        for (size_t j = i + 1; j < N_BODIES; j++) {
+            create_newtonian_gravity(physics_exact,
+                                     G,
+                                     list_get(exact, i),
+                                     list_get(exact, j));
+        }
+    }
+    create_barnes_hut_gravity(physics_approx, G, theta, approx);
+    physics_tick(physics_exact, 1e-2);
+    physics_tick(physics_approx, 1e-2);
+
+    // All bodies start at rest, so their velocities are proportional to their
+    // accelerations.
+    double mean_magnitude = 0;
+    double worst = 0;
+    gravity_error_t error = {0, 0};
+    for (size_t i = 0; i < N_BODIES; i++) {
+        vector_t v_exact = body_get_velocity(list_get(exact, i));
+        vector_t v_approx = body_get_velocity(list_get(approx, i));
+        double diff = vec_magnitude(vec_subtract(v_approx, v_exact));
+        mean_magnitude += vec_magnitude(v_exact) / N_BODIES;
+        worst = fmax(worst, diff);
+        error.mean += diff / vec_magnitude(v_exact) / N_BODIES;
+    }
+    error.worst = worst / mean_magnitude;
+
+    physics_free(physics_exact);
+    physics_free(physics_approx);
+    list_free(exact);
+    list_free(approx);
+    return error;
+}
+
+void test_barnes_hut_exact() {
+    // Nothing is lumped together, so only rounding differs.
+    gravity_error_t error = gravity_error(0);
+    assert(error.worst < 1e-9);
+    assert(error.mean < 1e-9);
+}
+
+void test_barnes_hut_tolerance() {
+    // As promised in barnes_hut.h.
+    gravity_error_t error = gravity_error(0.5);
+    assert(error.worst < 1e-2);
+    assert(error.mean < 5e-3);
+    // Rougher, but still in the right direction.
+    error = gravity_error(1);
+    assert(error.worst < 0.2);
+    assert(error.mean < 5e-2);
+}
+
+void test_barnes_hut_field() {
+    barnes_hut_t *tree = barnes_hut_init();
+    list_t *bodies = list_init(3, (free_func_t)body_free);
+    list_add(bodies,
+             make_rectangle((rgb_color_t){0}, VEC_ZERO, 2, 2, 2, NULL, NULL));
+    list_add(bodies,
+             make_rectangle((rgb_color_t){0},
+                            (vector_t){10, 0},
+                            2,
+                            2,
+                            3,
+                            NULL,
+                            NULL));
+    list_add(bodies,
+             make_rectangle((rgb_color_t){0},
+                            (vector_t){0, -20},
+                            2,
+                            2,
+                            INFINITY,
+                            NULL,
+                            NULL));
+
+    // Empty.
+    list_t *empty = list_init(1, NULL);
+    barnes_hut_build(tree, empty);
+    assert(barnes_hut_size(tree) == 0);
+    assert(vec_equal(barnes_hut_field(tree, VEC_ZERO, NULL, 0.5, 0), VEC_ZERO));
+    list_free(empty);
+
+    // Infinite masses are left out, as are bodies too close and 'exclude'.
+    barnes_hut_build(tree, bodies);
+    assert(barnes_hut_size(tree) == 2);
+    assert(vec_isclose(barnes_hut_field(tree, VEC_ZERO, NULL, 0.5, 5),
+                       (vector_t){3.0 / 100, 0}));
+    assert(vec_isclose(
+        barnes_hut_field(tree, VEC_ZERO, list_get(bodies, 1), 0.5, 0),
+        VEC_ZERO));
+    assert(vec_isclose(barnes_hut_field(tree, (vector_t){20, 0}, NULL, 0, 0),
+                       (vector_t){-3.0 / 100 - 2.0 / 400, 0}));
+
+    // So are removed bodies.
+    body_remove(list_get(bodies, 0));
+    barnes_hut_build(tree, bodies);
+    assert(barnes_hut_size(tree) == 1);
+
+    barnes_hut_free(tree);
+    list_free(bodies);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_barnes_hut_exact)
+    DO_TEST(test_barnes_hut_tolerance)
+    DO_TEST(test_barnes_hut_field)
+
+    puts("barnes_hut_test PASS");
+}
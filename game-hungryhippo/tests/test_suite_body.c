@@ -1,4 +1,6 @@
 #include "body.h"
+#include "polygon.h"
+#include "shapes_geometry.h"
 #include "test_util.h"
 #include <assert.h>
 #include <math.h>
@@ -123,6 +125,105 @@ void test_body_tick() {
     body_free(body);
 }
 
+// A 1x1 square with its bottom left corner at 'corner'.
+void test_body_world_shapes() {
+    list_t *shapes = list_init(2, (free_func_t)polygon_free);
+    list_add(shapes, make_rectangle_polygon(VEC_ZERO, 1, 1));
+    list_add(shapes, make_rectangle_polygon((vector_t){2.5, 0.5}, 1, 1));
+    body_t *body = body_init_with_gfx(1, NULL, NULL, shapes, NULL);
+    assert(body_get_num_shapes(body) == 2);
+
+    // Both shapes move with the body, about its centroid (the main shape's).
+    body_set_rotation(body, M_PI / 2);
+    body_translate(body, (vector_t){10, 0});
+    polygon_t *alt = body_get_shape_alt(body, 1);
+    assert(vec_isclose(polygon_get(alt, 0), (vector_t){10, 2}));
+    assert(vec_isclose(polygon_get(alt, 2), (vector_t){9, 3}));
+    assert(vec_isclose(polygon_centroid(alt), (vector_t){9.5, 2.5}));
+    polygon_t *main = body_get_shape_main(body);
+    assert(vec_isclose(polygon_get(main, 0), (vector_t){10.5, -0.5}));
+
+    // Moving again brings the alternate shape up to date when it is next
+    // asked for, whether or not the main shape was.
+    body_translate(body, (vector_t){0, 5});
+    body_rotate(body, M_PI / 2);
+    alt = body_get_shape_alt(body, 1);
+    assert(vec_isclose(polygon_get(alt, 0), (vector_t){8, 5}));
+    assert(vec_isclose(polygon_get(alt, 2), (vector_t){7, 4}));
+    aabb_t box = polygon_aabb(alt);
+    assert(vec_isclose(box.min, (vector_t){7, 4}));
+    assert(vec_isclose(box.max, (vector_t){8, 5}));
+    body_free(body);
+}
+
+void test_body_interpolate() {
+    list_t *shape = list_init(3, free);
+    vector_t *v = malloc(sizeof(*v));
+    *v = (vector_t){+1, 0};
+    list_add(shape, v);
+    v = malloc(sizeof(*v));
+    *v = (vector_t){0, +1};
+    list_add(shape, v);
+    v = malloc(sizeof(*v));
+    *v = (vector_t){-1, 0};
+    list_add(shape, v);
+    body_t *body = body_init(shape, 1, (rgb_color_t){0, 0, 0});
+
+    // Before the first tick, the body is drawn where it is.
+    body_set_centroid(body, (vector_t){5, 5});
+    body_interpolate(body, 0.5);
+    assert(vec_isclose(*body_get_anchor(body), (vector_t){5, 5}));
+
+    body_set_velocity(body, (vector_t){4, 0});
+    body_set_angular_velocity(body, 2);
+    body_tick(body, 1);
+    body_interpolate(body, 0.25);
+    assert(vec_isclose(*body_get_anchor(body), (vector_t){6, 5}));
+    assert(isclose(*body_get_angle_p(body), 0.5));
+    body_interpolate(body, 1);
+    assert(vec_equal(*body_get_anchor(body), body_get_centroid(body)));
+    assert(isclose(*body_get_angle_p(body), body_get_rotation(body)));
+    body_free(body);
+}
+
+void test_body_interpolate_teleport() {
+    list_t *shape = list_init(3, free);
+    vector_t *v = malloc(sizeof(*v));
+    *v = (vector_t){+1, 0};
+    list_add(shape, v);
+    v = malloc(sizeof(*v));
+    *v = (vector_t){0, +1};
+    list_add(shape, v);
+    v = malloc(sizeof(*v));
+    *v = (vector_t){-1, 0};
+    list_add(shape, v);
+    body_t *body = body_init(shape, 1, (rgb_color_t){0, 0, 0});
+
+    body_set_velocity(body, (vector_t){4, 0});
+    body_set_angular_velocity(body, 2);
+    body_tick(body, 1);
+    // Teleported after the tick, e.g. by a game's tick function: drawn there
+    // straight away rather than partway across the jump.
+    body_set_centroid(body, (vector_t){100, 100});
+    body_set_rotation(body, 3);
+    body_interpolate(body, 0.5);
+    assert(vec_isclose(*body_get_anchor(body), (vector_t){100, 100}));
+    assert(isclose(*body_get_angle_p(body), 3));
+
+    // Relative moves are still drawn as motion.
+    body_translate(body, (vector_t){2, 0});
+    body_rotate(body, 1);
+    body_interpolate(body, 0.5);
+    assert(vec_isclose(*body_get_anchor(body), (vector_t){101, 100}));
+    assert(isclose(*body_get_angle_p(body), 3.5));
+
+    // The next tick starts from where it was put.
+    body_tick(body, 1);
+    body_interpolate(body, 0);
+    assert(vec_isclose(*body_get_anchor(body), (vector_t){102, 100}));
+    body_free(body);
+}
+
 void test_infinite_mass() {
     list_t *shape = list_init(10, free);
     vector_t *v = malloc(sizeof(*v));
@@ -200,6 +301,32 @@ void test_body_remove() {
     body_free(body);
 }
 
+void test_body_handle() {
+    list_t *shape = list_init(3, free);
+    vector_t *v = malloc(sizeof(*v));
+    *v = (vector_t){+1, 0};
+    list_add(shape, v);
+    v = malloc(sizeof(*v));
+    *v = (vector_t){0, +1};
+    list_add(shape, v);
+    v = malloc(sizeof(*v));
+    *v = (vector_t){-1, 0};
+    list_add(shape, v);
+    list_t *shape2 = list_copy(shape, (copy_func_t)vec_p_copy);
+    body_t *body = body_init(shape, 1, (rgb_color_t){0, 0, 0});
+    body_handle_t handle = body_get_handle(body);
+    assert(body_handle_get(handle) == body);
+    body_free(body);
+    assert(body_handle_get(handle) == NULL);
+
+    // The freed slot is reused, but the old handle still doesn't refer to it.
+    body_t *body2 = body_init(shape2, 1, (rgb_color_t){0, 0, 0});
+    assert(body2 == body);
+    assert(body_handle_get(handle) == NULL);
+    assert(body_handle_get(body_get_handle(body2)) == body2);
+    body_free(body2);
+}
+
 void test_body_info() {
     list_t *shape = list_init(3, free);
     vector_t *v = malloc(sizeof(*v));
@@ -264,9 +391,13 @@ int main(int argc, char *argv[]) {
     DO_TEST(test_body_init)
     DO_TEST(test_body_setters)
     DO_TEST(test_body_tick)
+    DO_TEST(test_body_world_shapes)
+    DO_TEST(test_body_interpolate)
+    DO_TEST(test_body_interpolate_teleport)
     DO_TEST(test_infinite_mass)
     DO_TEST(test_forces)
     DO_TEST(test_body_remove)
+    DO_TEST(test_body_handle)
     DO_TEST(test_body_info)
     DO_TEST(test_body_info_freer)
 
@@ -0,0 +1,170 @@
+#include "collision.h"
+#include "polygon.h"
+#include "shapes_geometry.h"
+#include "test_util.h"
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+void test_rounded_area_centroid() {
+    polygon_t *circle = polygon_init_circle((vector_t){1, 2}, 3);
+    assert(polygon_size(circle) == 1);
+    assert(isclose(polygon_radius(circle), 3));
+    assert(isclose(polygon_area(circle), M_PI * 9));
+    assert(vec_isclose(polygon_centroid(circle), (vector_t){1, 2}));
+
+    polygon_t *capsule
+        = polygon_init_capsule((vector_t){0, 0}, (vector_t){4, 0}, 1);
+    assert(isclose(polygon_area(capsule), 8 + M_PI));
+    assert(vec_isclose(polygon_centroid(capsule), (vector_t){2, 0}));
+    aabb_t box = polygon_aabb(capsule);
+    assert(vec_isclose(box.min, (vector_t){-1, -1}));
+    assert(vec_isclose(box.max, (vector_t){5, 1}));
+
+    polygon_free(circle);
+    polygon_free(capsule);
+}
+
+void test_circle_circle() {
+    polygon_t *circle1 = polygon_init_circle((vector_t){0, 0}, 1);
+    polygon_t *circle2 = polygon_init_circle((vector_t){1.5, 0}, 1);
+    collision_info_t info = find_collision(circle1, circle2);
+    assert(info.collided);
+    assert(vec_isclose(info.axis, (vector_t){1, 0}));
+    assert(vec_isclose(info.collision_point, (vector_t){0.75, 0}));
+
+    info = find_collision(circle2, circle1);
+    assert(info.collided);
+    assert(vec_isclose(info.axis, (vector_t){-1, 0}));
+
+    polygon_set(circle2, 0, (vector_t){0, 2.5});
+    assert(!find_collision(circle1, circle2).collided);
+
+    polygon_free(circle1);
+    polygon_free(circle2);
+}
+
+void test_circle_polygon() {
+    polygon_t *square = make_rectangle_polygon(VEC_ZERO, 2, 2);
+    polygon_t *circle = polygon_init_circle((vector_t){1.5, 0}, 1);
+
+    // Against an edge.
+    collision_info_t info = find_collision(square, circle);
+    assert(info.collided);
+    assert(vec_isclose(info.axis, (vector_t){1, 0}));
+    info = find_collision(circle, square);
+    assert(info.collided);
+    assert(vec_isclose(info.axis, (vector_t){-1, 0}));
+
+    // Against a corner.
+    polygon_set(circle, 0, (vector_t){1.5, 1.5});
+    info = find_collision(square, circle);
+    assert(info.collided);
+    assert(vec_isclose(info.axis, vec_normalize((vector_t){1, 1})));
+    assert(vec_isclose(info.collision_point, (vector_t){1, 1}));
+
+    // Near the corner, inside both bounding boxes but not touching.
+    polygon_set(circle, 0, (vector_t){1.8, 1.8});
+    assert(!find_collision(square, circle).collided);
+
+    // Center inside the square.
+    polygon_set(circle, 0, (vector_t){0, 0.5});
+    info = find_collision(square, circle);
+    assert(info.collided);
+    assert(vec_isclose(info.axis, (vector_t){0, 1}));
+
+    polygon_free(square);
+    polygon_free(circle);
+}
+
+void test_capsule() {
+    polygon_t *square = make_rectangle_polygon(VEC_ZERO, 2, 2);
+    polygon_t *capsule
+        = polygon_init_capsule((vector_t){2.5, -3}, (vector_t){2.5, 3}, 1);
+    assert(!find_collision(square, capsule).collided);
+
+    polygon_translate(capsule, (vector_t){-1, 0});
+    collision_info_t info = find_collision(square, capsule);
+    assert(info.collided);
+    assert(vec_isclose(info.axis, (vector_t){1, 0}));
+    info = find_collision(capsule, square);
+    assert(info.collided);
+    assert(vec_isclose(info.axis, (vector_t){-1, 0}));
+
+    // A capsule whose end is near, but not touching, the square's corner.
+    polygon_t *diagonal
+        = polygon_init_capsule((vector_t){1.8, 1.8}, (vector_t){5, 5}, 1);
+    assert(!find_collision(square, diagonal).collided);
+    assert(find_collision(capsule, diagonal).collided);
+
+    // Against a circle, which uses the exact test.
+    polygon_t *circle = polygon_init_circle((vector_t){0, 4}, 1);
+    info = find_collision(circle, capsule);
+    assert(info.collided);
+    assert(vec_isclose(info.axis, vec_normalize((vector_t){1.5, -1})));
+
+    polygon_free(square);
+    polygon_free(capsule);
+    polygon_free(diagonal);
+    polygon_free(circle);
+}
+
+void test_bounds() {
+    polygon_t *square = make_rectangle_polygon(VEC_ZERO, 2, 2);
+    assert(isclose(polygon_bounding_radius(square), sqrt(2)));
+
+    // Moving the square moves its cached box along with it.
+    aabb_t box = polygon_aabb(square);
+    polygon_translate(square, (vector_t){10, 0});
+    box = polygon_aabb(square);
+    assert(vec_isclose(box.min, (vector_t){9, -1}));
+    assert(vec_isclose(box.max, (vector_t){11, 1}));
+    polygon_rotate(square, M_PI / 4, (vector_t){10, 0});
+    box = polygon_aabb(square);
+    assert(vec_isclose(box.max, (vector_t){10 + sqrt(2), sqrt(2)}));
+    assert(isclose(polygon_bounding_radius(square), sqrt(2)));
+    polygon_set(square, 0, (vector_t){8, 0});
+    assert(isclose(polygon_aabb(square).min.x, 8));
+
+    // A transformed copy gets its box as it is written.
+    polygon_t *local = make_rectangle_polygon(VEC_ZERO, 2, 2);
+    polygon_t *world = make_rectangle_polygon(VEC_ZERO, 2, 2);
+    polygon_transform(world, local, M_PI / 4, (vector_t){0, 5});
+    box = polygon_aabb(world);
+    assert(vec_isclose(box.min, (vector_t){-sqrt(2), 5 - sqrt(2)}));
+    assert(vec_isclose(box.max, (vector_t){sqrt(2), 5 + sqrt(2)}));
+    assert(isclose(polygon_bounding_radius(world), sqrt(2)));
+
+    // Boxes that overlap at a corner, but circles that don't.
+    polygon_t *circle1 = polygon_init_circle((vector_t){0, 0}, 1);
+    polygon_t *circle2 = polygon_init_circle((vector_t){1.8, 1.8}, 1);
+    assert(aabb_overlap(polygon_aabb(circle1), polygon_aabb(circle2)));
+    assert(!polygon_bounds_overlap(circle1, circle2));
+    polygon_set(circle2, 0, (vector_t){1.2, 1.2});
+    assert(polygon_bounds_overlap(circle1, circle2));
+    assert(!polygon_bounds_overlap(circle1, world));
+
+    polygon_free(square);
+    polygon_free(local);
+    polygon_free(world);
+    polygon_free(circle1);
+    polygon_free(circle2);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_rounded_area_centroid)
+    DO_TEST(test_circle_circle)
+    DO_TEST(test_circle_polygon)
+    DO_TEST(test_capsule)
+    DO_TEST(test_bounds)
+
+    puts("collision_test PASS");
+}
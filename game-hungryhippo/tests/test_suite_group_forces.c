@@ -0,0 +1,149 @@
+#include "body.h"
+#include "forces.h"
+#include "list.h"
+#include "physics.h"
+#include "shapes_geometry.h"
+#include "test_util.h"
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+#define N_BODIES 20
+
+/**
+ * Make a group of moving bodies, the same every time.
+ */
+list_t *make_bodies() {
+    list_t *bodies = list_init(N_BODIES, (free_func_t)body_free);
+    for (size_t i = 0; i < N_BODIES; i++) {
+        vector_t center = {10.0 * i, 3.0 * (i % 4)};
+        body_t *body = make_rectangle((rgb_color_t){0},
+                                      center,
+                                      2,
+                                      2,
+                                      1 + i % 3,
+                                      NULL,
+                                      NULL);
+        body_set_velocity(body, (vector_t){cos(i), sin(2 * i)});
+        list_add(bodies, body);
+    }
+    return bodies;
+}
+
+void test_group_drag() {
+    // The same as drag on each body.
+    list_t *group = make_bodies();
+    list_t *single = make_bodies();
+    physics_t *physics = physics_init();
+    physics_add_bodies(physics, group);
+    physics_add_bodies(physics, single);
+    create_group_drag(physics, 0.3, group);
+    for (size_t i = 0; i < N_BODIES; i++) {
+        create_drag(physics, 0.3, list_get(single, i));
+    }
+    for (size_t tick = 0; tick < 100; tick++) {
+        physics_tick(physics, 1e-2);
+    }
+    for (size_t i = 0; i < N_BODIES; i++) {
+        assert(vec_equal(body_get_velocity(list_get(group, i)),
+                         body_get_velocity(list_get(single, i))));
+    }
+
+    // Removing a body from the group leaves drag on the rest.
+    body_remove(list_get(group, 0));
+    physics_tick(physics, 1e-2);
+    body_free(list_remove(group, 0));
+    vector_t v = body_get_velocity(list_get(group, 0));
+    physics_tick(physics, 1e-2);
+    assert(vec_magnitude(body_get_velocity(list_get(group, 0)))
+           < vec_magnitude(v));
+
+    physics_free(physics);
+    list_free(group);
+    list_free(single);
+}
+
+void test_group_field() {
+    const vector_t G = {0, -9.8};
+    list_t *bodies = make_bodies();
+    body_t *fixed = make_rectangle((rgb_color_t){0},
+                                   VEC_ZERO,
+                                   2,
+                                   2,
+                                   INFINITY,
+                                   NULL,
+                                   NULL);
+    list_add(bodies, fixed);
+    physics_t *physics = physics_init();
+    physics_add_bodies(physics, bodies);
+    create_group_field(physics, G, bodies);
+    // Every body falls the same way whatever its mass.
+    for (size_t tick = 0; tick < 10; tick++) {
+        physics_tick(physics, 0.1);
+    }
+    for (size_t i = 0; i < N_BODIES; i++) {
+        vector_t v0 = {cos(i), sin(2 * i)};
+        assert(vec_isclose(body_get_velocity(list_get(bodies, i)),
+                           vec_add(v0, G)));
+    }
+    assert(vec_equal(body_get_velocity(fixed), VEC_ZERO));
+    physics_free(physics);
+    list_free(bodies);
+}
+
+void test_springs() {
+    // A chain, the same as a spring along each link.
+    list_t *group = make_bodies();
+    list_t *single = make_bodies();
+    physics_t *physics = physics_init();
+    physics_add_bodies(physics, group);
+    physics_add_bodies(physics, single);
+    body_t *edges[2 * (N_BODIES - 1)];
+    for (size_t i = 0; i + 1 < N_BODIES; i++) {
+        edges[2 * i] = list_get(group, i);
+        edges[2 * i + 1] = list_get(group, i + 1);
+        create_spring(physics, 2, list_get(single, i), list_get(single, i + 1));
+    }
+    create_springs(physics, 2, edges, N_BODIES - 1);
+    for (size_t tick = 0; tick < 100; tick++) {
+        physics_tick(physics, 1e-2);
+    }
+    for (size_t i = 0; i < N_BODIES; i++) {
+        assert(vec_isclose(body_get_centroid(list_get(group, i)),
+                           body_get_centroid(list_get(single, i))));
+    }
+
+    // Freeing the first body loses only the first link.
+    body_remove(list_get(group, 0));
+    body_remove(list_get(single, 0));
+    physics_tick(physics, 1e-2);
+    body_free(list_remove(group, 0));
+    body_free(list_remove(single, 0));
+    for (size_t tick = 0; tick < 100; tick++) {
+        physics_tick(physics, 1e-2);
+    }
+    for (size_t i = 0; i < N_BODIES - 1; i++) {
+        assert(vec_isclose(body_get_centroid(list_get(group, i)),
+                           body_get_centroid(list_get(single, i))));
+    }
+
+    physics_free(physics);
+    list_free(group);
+    list_free(single);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_group_drag)
+    DO_TEST(test_group_field)
+    DO_TEST(test_springs)
+
+    puts("group_forces_test PASS");
+}
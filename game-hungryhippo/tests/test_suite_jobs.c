@@ -0,0 +1,85 @@
+#include "jobs.h"
+#include "test_util.h"
+#include "thread_pool.h"
+#include <assert.h>
+#include <stdlib.h>
+
+#define COUNT 1000
+
+typedef struct visits {
+    int counts[COUNT]; // Only ever written by the thread that visits it.
+    size_t threads[COUNT]; // Thread that visited each index.
+    size_t chunk_size;
+} visits_t;
+
+void visit(visits_t *visits, size_t start, size_t end, size_t thread_idx) {
+    assert(start < end && end <= COUNT);
+    assert(end - start <= visits->chunk_size);
+    for (size_t i = start; i < end; i++) {
+        visits->counts[i]++;
+        visits->threads[i] = thread_idx;
+    }
+}
+
+void test_jobs_covers_range() {
+    const size_t THREAD_COUNTS[] = {1, 2, 5};
+    const size_t CHUNK_SIZES[] = {1, 7, 64, 2000};
+    for (size_t t = 0; t < 3; t++) {
+        thread_pool_t *pool = thread_pool_init(THREAD_COUNTS[t]);
+        jobs_t *jobs = jobs_init(pool);
+        for (size_t c = 0; c < 4; c++) {
+            for (int deterministic = 0; deterministic < 2; deterministic++) {
+                visits_t *visits = calloc(1, sizeof(visits_t));
+                visits->chunk_size = CHUNK_SIZES[c];
+                jobs_for(jobs,
+                         COUNT,
+                         CHUNK_SIZES[c],
+                         deterministic,
+                         (jobs_func_t)visit,
+                         visits);
+                for (size_t i = 0; i < COUNT; i++) {
+                    assert(visits->counts[i] == 1);
+                }
+                free(visits);
+            }
+        }
+        // Nothing to do is fine too.
+        jobs_for(jobs, 0, 8, false, (jobs_func_t)visit, NULL);
+        jobs_free(jobs);
+        thread_pool_free(pool);
+    }
+}
+
+void test_jobs_deterministic() {
+    // Each thread gets the same contiguous run of chunks every time.
+    thread_pool_t *pool = thread_pool_init(4);
+    // Fewer on platforms without threads (see thread_pool.h).
+    const size_t THREAD_COUNT = thread_pool_size(pool);
+    jobs_t *jobs = jobs_init(pool);
+    for (size_t run = 0; run < 20; run++) {
+        visits_t *visits = calloc(1, sizeof(visits_t));
+        visits->chunk_size = 10;
+        jobs_for(jobs, COUNT, 10, true, (jobs_func_t)visit, visits);
+        for (size_t i = 0; i < COUNT; i++) {
+            assert(visits->threads[i] == i / 10 * THREAD_COUNT / 100);
+        }
+        free(visits);
+    }
+    jobs_free(jobs);
+    thread_pool_free(pool);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_jobs_covers_range)
+    DO_TEST(test_jobs_deterministic)
+
+    puts("jobs_test PASS");
+}
@@ -0,0 +1,111 @@
+#include "body.h"
+#include "forces.h"
+#include "list.h"
+#include "physics.h"
+#include "shapes_geometry.h"
+#include "test_util.h"
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+const size_t N_BODIES = 40;
+
+/**
+ * Add an n-body system with gravity between every pair, some springs and some
+ * drag to a new physics layer, with the given number of threads.
+ */
+physics_t *make_system(list_t *bodies, size_t thread_count) {
+    physics_t *physics = physics_init();
+    physics_set_threads(physics, thread_count);
+    for (size_t i = 0; i < N_BODIES; i++) {
+        vector_t center = {100 * cos(i * 2.4), 100 * sin(i * 2.4) + i};
+        body_t *body = make_rectangle((rgb_color_t){0},
+                                      center,
+                                      2,
+                                      2,
+                                      1 + i % 7,
+                                      NULL,
+                                      NULL);
+        body_set_velocity(body, (vector_t){sin(i), cos(3 * i)});
+        list_add(bodies, body);
+    }
+    physics_add_bodies(physics, bodies);
+    for (size_t i = 0; i < N_BODIES; i++) {
+        for (size_t j = i + 1; j < N_BODIES; j++) {
+            create_newtonian_gravity(physics,
+                                     1e3,
+                                     list_get(bodies, i),
+                                     list_get(bodies, j));
+        }
+        if (i % 5 == 0) {
+            create_spring(physics,
+                          0.1,
+                          list_get(bodies, i),
+                          list_get(bodies, (i + 1) % N_BODIES));
+            create_drag(physics, 0.05, list_get(bodies, i));
+        }
+    }
+    return physics;
+}
+
+void test_physics_threads_deterministic() {
+    const size_t THREAD_COUNTS[] = {1, 2, 3, 8};
+    const size_t RUNS = sizeof(THREAD_COUNTS) / sizeof(*THREAD_COUNTS);
+    list_t *bodies[RUNS];
+    physics_t *physics[RUNS];
+    for (size_t r = 0; r < RUNS; r++) {
+        bodies[r] = list_init(N_BODIES, (free_func_t)body_free);
+        physics[r] = make_system(bodies[r], THREAD_COUNTS[r]);
+    }
+
+    for (size_t tick = 0; tick < 200; tick++) {
+        for (size_t r = 0; r < RUNS; r++) {
+            physics_tick(physics[r], 1e-2);
+        }
+    }
+
+    // Exactly the same, not just close.
+    for (size_t i = 0; i < N_BODIES; i++) {
+        body_t *expected = list_get(bodies[0], i);
+        for (size_t r = 1; r < RUNS; r++) {
+            body_t *body = list_get(bodies[r], i);
+            assert(vec_equal(body_get_centroid(body),
+                             body_get_centroid(expected)));
+            assert(vec_equal(body_get_velocity(body),
+                             body_get_velocity(expected)));
+        }
+    }
+
+    for (size_t r = 0; r < RUNS; r++) {
+        physics_free(physics[r]);
+        list_free(bodies[r]);
+    }
+}
+
+void test_physics_threads_change() {
+    // The thread count can change between ticks, e.g. back to serial.
+    list_t *bodies = list_init(N_BODIES, (free_func_t)body_free);
+    physics_t *physics = make_system(bodies, 4);
+    physics_tick(physics, 1e-2);
+    physics_set_threads(physics, 1);
+    physics_tick(physics, 1e-2);
+    physics_set_threads(physics, 2);
+    physics_tick(physics, 1e-2);
+    physics_free(physics);
+    list_free(bodies);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_physics_threads_deterministic)
+    DO_TEST(test_physics_threads_change)
+
+    puts("physics_test PASS");
+}
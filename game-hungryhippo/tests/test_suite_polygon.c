@@ -0,0 +1,105 @@
+#include "polygon.h"
+#include "shapes_geometry.h"
+#include "test_util.h"
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+void test_polygon_list_round_trip() {
+    polygon_t *square = make_rectangle_polygon((vector_t){1, 1}, 2, 2);
+    list_t *vertices = polygon_to_list(square);
+    assert(list_size(vertices) == 4);
+    polygon_t *polygon = polygon_init_from_list(vertices);
+    assert(polygon_size(polygon) == 4);
+    assert(polygon_radius(polygon) == 0);
+
+    for (size_t i = 0; i < 4; i++) {
+        vector_t v = polygon_get(square, i);
+        assert(vec_equal(*(vector_t *)list_get(vertices, i), v));
+        assert(vec_equal(polygon_get(polygon, i), v));
+        assert(polygon_xs(polygon)[i] == v.x);
+        assert(polygon_ys(polygon)[i] == v.y);
+    }
+
+    list_free(vertices);
+    polygon_free(square);
+    polygon_free(polygon);
+}
+
+void test_polygon_get_set_reverse() {
+    polygon_t *polygon = polygon_init(3);
+    polygon_set(polygon, 0, (vector_t){0, 0});
+    polygon_set(polygon, 1, (vector_t){3, 0});
+    polygon_set(polygon, 2, (vector_t){0, 3});
+    assert(vec_equal(polygon_get(polygon, 1), (vector_t){3, 0}));
+    polygon_set(polygon, 1, (vector_t){6, 0});
+    assert(vec_equal(polygon_get(polygon, 1), (vector_t){6, 0}));
+    assert(isclose(polygon_area(polygon), 9));
+
+    polygon_reverse(polygon);
+    assert(vec_equal(polygon_get(polygon, 0), (vector_t){0, 3}));
+    assert(vec_equal(polygon_get(polygon, 1), (vector_t){6, 0}));
+    assert(vec_equal(polygon_get(polygon, 2), (vector_t){0, 0}));
+    // The same shape, just wound the other way.
+    assert(isclose(polygon_area(polygon), 9));
+    polygon_reverse(polygon);
+    assert(vec_equal(polygon_get(polygon, 0), (vector_t){0, 0}));
+    assert(vec_isclose(polygon_centroid(polygon), (vector_t){2, 1}));
+
+    polygon_t *copy = polygon_copy(polygon);
+    assert(vec_isclose(polygon_centroid(copy), (vector_t){2, 1}));
+    for (size_t i = 0; i < 3; i++) {
+        assert(vec_equal(polygon_get(copy, i), polygon_get(polygon, i)));
+    }
+    polygon_free(copy);
+    polygon_free(polygon);
+}
+
+void test_polygon_cache_invalidation() {
+    polygon_t *polygon = make_rectangle_polygon((vector_t){1, 1}, 2, 2);
+
+    // Fill the caches, then change a vertex.
+    assert(vec_isclose(polygon_centroid(polygon), (vector_t){1, 1}));
+    aabb_t box = polygon_aabb(polygon);
+    assert(vec_isclose(box.max, (vector_t){2, 2}));
+    polygon_set(polygon, 2, (vector_t){4, 4});
+    box = polygon_aabb(polygon);
+    assert(vec_isclose(box.max, (vector_t){4, 4}));
+    polygon_set(polygon, 2, (vector_t){2, 2});
+    assert(vec_isclose(polygon_centroid(polygon), (vector_t){1, 1}));
+
+    // Scaling keeps the centroid but not the box.
+    polygon_aabb(polygon);
+    polygon_scale(polygon, 2);
+    assert(vec_isclose(polygon_centroid(polygon), (vector_t){1, 1}));
+    box = polygon_aabb(polygon);
+    assert(vec_isclose(box.min, (vector_t){-1, -1}));
+    assert(vec_isclose(box.max, (vector_t){3, 3}));
+    assert(isclose(polygon_bounding_radius(polygon), 2 * sqrt(2)));
+
+    // Rotating about a corner moves the centroid and the box.
+    polygon_rotate(polygon, M_PI / 2, (vector_t){-1, -1});
+    assert(vec_isclose(polygon_centroid(polygon), (vector_t){-3, 1}));
+    box = polygon_aabb(polygon);
+    assert(vec_isclose(box.min, (vector_t){-5, -1}));
+    assert(vec_isclose(box.max, (vector_t){-1, 3}));
+    assert(isclose(polygon_bounding_radius(polygon), 2 * sqrt(2)));
+
+    polygon_free(polygon);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_polygon_list_round_trip)
+    DO_TEST(test_polygon_get_set_reverse)
+    DO_TEST(test_polygon_cache_invalidation)
+
+    puts("polygon_test PASS");
+}
@@ -0,0 +1,100 @@
+#include "profiler.h"
+#include "test_util.h"
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+const char *TRACE_PATH = "out/test_profiler_trace.json";
+
+// One millisecond in nanoseconds.
+const uint64_t MS = 1000000;
+
+void test_profiler_percentiles() {
+    assert(profiler_frame_count() == 0);
+    assert(profiler_percentile(PROFILE_ZONE_FRAME, 0.5) == 0);
+
+    // Frames of 1 to 100 ms, with physics taking two 1 ms steps each.
+    for (uint64_t i = 1; i <= 100; i++) {
+        profiler_record(PROFILE_ZONE_FRAME, 0, i * MS);
+        profiler_record(PROFILE_ZONE_PHYSICS, 0, MS);
+        profiler_record(PROFILE_ZONE_PHYSICS, 5 * MS, 6 * MS);
+        profiler_end_frame();
+    }
+    assert(profiler_frame_count() == 100);
+    double p50 = profiler_percentile(PROFILE_ZONE_FRAME, 0.5);
+    double p99 = profiler_percentile(PROFILE_ZONE_FRAME, 0.99);
+    assert(fabs(p50 - 50e-3) < 0.04 * 50e-3);
+    assert(fabs(p99 - 99e-3) < 0.04 * 99e-3);
+    assert(fabs(profiler_percentile(PROFILE_ZONE_FRAME, 1) - 100e-3)
+           < 0.04 * 100e-3);
+    assert(fabs(profiler_percentile(PROFILE_ZONE_PHYSICS, 0.99) - 2e-3)
+           < 0.04 * 2e-3);
+    // Zones that never ran took no time.
+    assert(profiler_percentile(PROFILE_ZONE_RENDER, 0.99) == 0);
+    profiler_free();
+    assert(profiler_frame_count() == 0);
+}
+
+void test_profiler_window() {
+    // Slow frames fall out of the window once enough fast ones follow.
+    for (size_t i = 0; i < PROFILER_WINDOW; i++) {
+        profiler_record(PROFILE_ZONE_GC, 0, 10 * MS);
+        profiler_end_frame();
+    }
+    assert(fabs(profiler_percentile(PROFILE_ZONE_GC, 0.5) - 10e-3) < 4e-4);
+    for (size_t i = 0; i < PROFILER_WINDOW - 1; i++) {
+        profiler_record(PROFILE_ZONE_GC, 0, MS);
+        profiler_end_frame();
+    }
+    assert(profiler_frame_count() == PROFILER_WINDOW);
+    assert(fabs(profiler_percentile(PROFILE_ZONE_GC, 0.99) - 1e-3) < 4e-5);
+    assert(fabs(profiler_percentile(PROFILE_ZONE_GC, 1) - 10e-3) < 4e-4);
+    profiler_end_frame();
+    assert(profiler_percentile(PROFILE_ZONE_GC, 1) < 2e-3);
+    profiler_free();
+}
+
+void test_profiler_trace() {
+    // Only zones recorded while tracing are in the trace.
+    profiler_record(PROFILE_ZONE_EVENTS, 0, MS);
+    profiler_start_trace();
+    uint64_t start = profiler_now();
+    profiler_record(PROFILE_ZONE_PHYSICS_FORCES, start, start + 2000);
+    profiler_record(PROFILE_ZONE_CLIENT_TICK, start + 2000, start + 3000);
+    profiler_end_frame();
+    profiler_write_trace(TRACE_PATH);
+    profiler_record(PROFILE_ZONE_RENDER, 0, MS);
+
+    FILE *file = fopen(TRACE_PATH, "r");
+    assert(file != NULL);
+    char json[1024];
+    size_t length = fread(json, 1, sizeof(json) - 1, file);
+    json[length] = '\0';
+    fclose(file);
+    assert(strncmp(json, "{\"traceEvents\":[", 16) == 0);
+    assert(strstr(json, "\"name\":\"physics/forces\"") != NULL);
+    assert(strstr(json, "\"dur\":2.000") != NULL);
+    assert(strstr(json, "\"name\":\"client tick\"") != NULL);
+    assert(strstr(json, "\"dur\":1.000") != NULL);
+    assert(strstr(json, "\"name\":\"events\"") == NULL);
+    assert(strstr(json, "\"name\":\"render\"") == NULL);
+    remove(TRACE_PATH);
+    profiler_free();
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_profiler_percentiles)
+    DO_TEST(test_profiler_window)
+    DO_TEST(test_profiler_trace)
+
+    puts("profiler_test PASS");
+}
@@ -0,0 +1,94 @@
+#include "replay.h"
+#include "test_util.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+const char *REPLAY_PATH = "test_suite_replay.bin";
+
+SDL_KeyboardEvent make_key(Uint8 state, SDL_Keycode sym) {
+    SDL_KeyboardEvent key = {0};
+    key.type = state == SDL_PRESSED ? SDL_KEYDOWN : SDL_KEYUP;
+    key.state = state;
+    key.keysym.sym = sym;
+    return key;
+}
+
+void test_replay_round_trip() {
+    uint32_t params[] = {4, 30};
+    replay_t *replay = replay_init_record(REPLAY_PATH, 1234, params, 2);
+    assert(!replay_is_playback(replay));
+    replay_record_key(replay, make_key(SDL_PRESSED, 'a'));
+    replay_record_tick(replay, 1.0 / 60.0);
+    replay_record_key(replay, make_key(SDL_RELEASED, -5));
+    replay_record_tick(replay, 0.1);
+    replay_record_quit(replay);
+    replay_free(replay);
+
+    replay = replay_init_playback(REPLAY_PATH);
+    assert(replay_is_playback(replay));
+    assert(replay_get_seed(replay) == 1234);
+    size_t param_count;
+    const uint32_t *read_params = replay_get_params(replay, &param_count);
+    assert(param_count == 2 && read_params[0] == 4 && read_params[1] == 30);
+
+    replay_event_t event = replay_read(replay);
+    assert(event.type == REPLAY_EVENT_KEY);
+    assert(event.key.type == SDL_KEYDOWN && event.key.state == SDL_PRESSED);
+    assert(event.key.keysym.sym == 'a');
+    event = replay_read(replay);
+    // Exactly, not just close.
+    assert(event.type == REPLAY_EVENT_TICK && event.dt == 1.0 / 60.0);
+    event = replay_read(replay);
+    assert(event.type == REPLAY_EVENT_KEY);
+    assert(event.key.type == SDL_KEYUP && event.key.state == SDL_RELEASED);
+    assert(event.key.keysym.sym == -5);
+    event = replay_read(replay);
+    assert(event.type == REPLAY_EVENT_TICK && event.dt == 0.1);
+    assert(replay_read(replay).type == REPLAY_EVENT_QUIT);
+    assert(replay_read(replay).type == REPLAY_EVENT_END);
+    assert(replay_read(replay).type == REPLAY_EVENT_END);
+    replay_free(replay);
+
+    remove(REPLAY_PATH);
+}
+
+void test_replay_truncated() {
+    replay_t *replay = replay_init_record(REPLAY_PATH, 0, NULL, 0);
+    replay_record_quit(replay);
+    replay_record_tick(replay, 0.5);
+    replay_free(replay);
+
+    // Chop off the last byte of the tick.
+    FILE *file = fopen(REPLAY_PATH, "rb");
+    assert(file != NULL);
+    char bytes[64];
+    size_t size = fread(bytes, 1, sizeof(bytes), file);
+    fclose(file);
+    file = fopen(REPLAY_PATH, "wb");
+    assert(file != NULL);
+    assert(fwrite(bytes, 1, size - 1, file) == size - 1);
+    fclose(file);
+
+    replay = replay_init_playback(REPLAY_PATH);
+    assert(replay_read(replay).type == REPLAY_EVENT_QUIT);
+    assert(replay_read(replay).type == REPLAY_EVENT_END);
+    replay_free(replay);
+
+    remove(REPLAY_PATH);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_replay_round_trip)
+    DO_TEST(test_replay_truncated)
+
+    puts("replay_test PASS");
+}
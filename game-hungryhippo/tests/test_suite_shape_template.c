@@ -0,0 +1,62 @@
+#include "polygon.h"
+#include "shape_template.h"
+#include "test_util.h"
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+
+const char *BALL_SHAPE_PATH = "static/ball/ball_collision_shape.csv";
+
+void test_shape_template_matches_file() {
+    polygon_t *expected = polygon_init_from_path(BALL_SHAPE_PATH);
+    polygon_scale(expected, 0.5);
+    polygon_set_centroid(expected, VEC_ZERO);
+
+    polygon_t *shape = shape_template_init(BALL_SHAPE_PATH, 0.5);
+    assert(polygon_size(shape) == polygon_size(expected));
+    for (size_t i = 0; i < polygon_size(shape); i++) {
+        assert(vec_isclose(polygon_get(shape, i), polygon_get(expected, i)));
+    }
+    assert(vec_isclose(polygon_centroid(shape), VEC_ZERO));
+
+    polygon_free(expected);
+    polygon_free(shape);
+    shape_template_free_all();
+}
+
+void test_shape_template_copies() {
+    polygon_t *shape1 = shape_template_init(BALL_SHAPE_PATH, 1);
+    polygon_t *shape2 = shape_template_init(BALL_SHAPE_PATH, 1);
+    assert(shape1 != shape2);
+
+    // Instances are independent of each other and of the template.
+    polygon_translate(shape1, (vector_t){10, 20});
+    assert(vec_isclose(polygon_centroid(shape2), VEC_ZERO));
+    polygon_t *shape3 = shape_template_init(BALL_SHAPE_PATH, 1);
+    assert(vec_isclose(polygon_centroid(shape3), VEC_ZERO));
+
+    // A different scale is a different template.
+    polygon_t *shape4 = shape_template_init(BALL_SHAPE_PATH, 2);
+    assert(isclose(polygon_area(shape4), 4 * polygon_area(shape2)));
+
+    polygon_free(shape1);
+    polygon_free(shape2);
+    polygon_free(shape3);
+    polygon_free(shape4);
+    shape_template_free_all();
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_shape_template_matches_file)
+    DO_TEST(test_shape_template_copies)
+
+    puts("shape_template_test PASS");
+}
@@ -0,0 +1,243 @@
+#include "polygon.h"
+#include "sweep_prune.h"
+#include "test_util.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define N_RANDOM_BOXES 60
+#define N_RANDOM_TICKS 200
+
+/**
+ * What the broad phase told us, with objects as indices into 'ids'.
+ */
+typedef struct pair_log {
+    size_t *ids;
+    // Whether each pair overlaps, by the events, and is reported, by the
+    // pairs. Indexed [obj1][obj2].
+    bool overlaps[N_RANDOM_BOXES][N_RANDOM_BOXES];
+    bool reported[N_RANDOM_BOXES][N_RANDOM_BOXES];
+    bool began[N_RANDOM_BOXES][N_RANDOM_BOXES]; // This tick.
+    size_t n_begins;
+    size_t n_ends;
+} pair_log_t;
+
+void log_event(size_t *obj1, size_t *obj2, bool begin, pair_log_t *log) {
+    assert(log->overlaps[*obj1][*obj2] != begin);
+    log->overlaps[*obj1][*obj2] = begin;
+    if (begin) {
+        log->began[*obj1][*obj2] = true;
+        log->n_begins++;
+    } else {
+        log->n_ends++;
+    }
+}
+
+void log_pair(size_t *obj1, size_t *obj2, bool *flag, pair_log_t *log) {
+    assert(!log->reported[*obj1][*obj2]);
+    log->reported[*obj1][*obj2] = true;
+    // Flags start false and then keep whatever they were set to.
+    assert(*flag == !log->began[*obj1][*obj2]);
+    *flag = true;
+}
+
+aabb_t make_box(double x, double y, double w, double h) {
+    return (aabb_t){.min = {x, y}, .max = {x + w, y + h}};
+}
+
+void test_aabb_overlap() {
+    aabb_t box = make_box(0, 0, 10, 10);
+    assert(aabb_overlap(box, make_box(5, 5, 10, 10)));
+    assert(aabb_overlap(box, make_box(2, 2, 1, 1)));
+    // Touching edges count as overlapping.
+    assert(aabb_overlap(box, make_box(10, 0, 10, 10)));
+    assert(!aabb_overlap(box, make_box(11, 0, 10, 10)));
+    // Overlapping in x alone is not enough.
+    assert(!aabb_overlap(box, make_box(5, 20, 10, 10)));
+}
+
+void test_polygon_aabb() {
+    polygon_t *polygon = polygon_init(3);
+    polygon_set(polygon, 0, (vector_t){-1, 2});
+    polygon_set(polygon, 1, (vector_t){3, -4});
+    polygon_set(polygon, 2, (vector_t){0, 5});
+
+    aabb_t box = polygon_aabb(polygon);
+    assert(vec_equal(box.min, (vector_t){-1, -4}));
+    assert(vec_equal(box.max, (vector_t){3, 5}));
+
+    polygon_free(polygon);
+}
+
+/**
+ * Update the broad phase and check what it reports against every pair of
+ * 'boxes' of which 'synced' ones were synced.
+ */
+void check_update(sweep_prune_t *sweep_prune,
+                  bool self,
+                  aabb_t *boxes,
+                  bool *synced,
+                  size_t *sides,
+                  pair_log_t *log) {
+    memset(log->began, 0, sizeof(log->began));
+    memset(log->reported, 0, sizeof(log->reported));
+    sweep_prune_update(sweep_prune, (sweep_prune_event_func_t)log_event, log);
+    sweep_prune_for_each_pair(sweep_prune,
+                              (sweep_prune_pair_func_t)log_pair,
+                              log);
+
+    size_t n_pairs = 0;
+    for (size_t i = 0; i < N_RANDOM_BOXES; i++) {
+        for (size_t j = 0; j < N_RANDOM_BOXES; j++) {
+            bool overlap = i != j && synced[i] && synced[j]
+                           && aabb_overlap(boxes[i], boxes[j]);
+            assert(log->reported[i][j] == log->overlaps[i][j]);
+            if (self) {
+                // Each pair is reported once, in one order or the other.
+                if (i < j) {
+                    assert(!(log->reported[i][j] && log->reported[j][i]));
+                    assert(overlap
+                           == (log->reported[i][j] || log->reported[j][i]));
+                    n_pairs += overlap;
+                }
+            } else {
+                bool expected = overlap && sides[i] == 0 && sides[j] == 1;
+                assert(log->reported[i][j] == expected);
+                n_pairs += expected;
+            }
+        }
+    }
+    assert(sweep_prune_pair_count(sweep_prune) == n_pairs);
+}
+
+void test_sweep_prune_events() {
+    size_t ids[2] = {0, 1};
+    pair_log_t log = {.ids = ids};
+    sweep_prune_t *sweep_prune = sweep_prune_init(false);
+
+    // Two boxes approach each other, touch, overlap, then part.
+    double xs[] = {50, 20, 10, 5, 10, 11, 30};
+    bool overlapping[] = {false, false, true, true, true, false, false};
+    for (size_t t = 0; t < 7; t++) {
+        sweep_prune_begin(sweep_prune);
+        sweep_prune_sync(sweep_prune, &ids[0], 0, make_box(0, 0, 10, 10), 0);
+        sweep_prune_sync(sweep_prune, &ids[1], 0, make_box(xs[t], 5, 5, 5), 1);
+        memset(log.began, 0, sizeof(log.began));
+        memset(log.reported, 0, sizeof(log.reported));
+        sweep_prune_update(sweep_prune,
+                           (sweep_prune_event_func_t)log_event,
+                           &log);
+        sweep_prune_for_each_pair(sweep_prune,
+                                  (sweep_prune_pair_func_t)log_pair,
+                                  &log);
+        assert(sweep_prune_size(sweep_prune) == 2);
+        assert(log.overlaps[0][1] == overlapping[t]);
+        assert(log.reported[0][1] == overlapping[t]);
+    }
+    assert(log.n_begins == 1 && log.n_ends == 1);
+    sweep_prune_free(sweep_prune);
+}
+
+void test_sweep_prune_drop_and_replace() {
+    size_t ids[2] = {0, 1};
+    pair_log_t log = {.ids = ids};
+    sweep_prune_t *sweep_prune = sweep_prune_init(true);
+
+    for (size_t t = 0; t < 4; t++) {
+        sweep_prune_begin(sweep_prune);
+        sweep_prune_sync(sweep_prune, &ids[0], 0, make_box(0, 0, 10, 10), 0);
+        // Gone on the third tick, and back as something else on the fourth.
+        if (t != 2) {
+            sweep_prune_sync(sweep_prune,
+                             &ids[1],
+                             t == 3,
+                             make_box(5, 5, 10, 10),
+                             0);
+        }
+        memset(log.began, 0, sizeof(log.began));
+        memset(log.reported, 0, sizeof(log.reported));
+        sweep_prune_update(sweep_prune,
+                           (sweep_prune_event_func_t)log_event,
+                           &log);
+        sweep_prune_for_each_pair(sweep_prune,
+                                  (sweep_prune_pair_func_t)log_pair,
+                                  &log);
+        assert(sweep_prune_size(sweep_prune) == (t == 2 ? 1 : 2));
+        assert(sweep_prune_pair_count(sweep_prune) == (t == 2 ? 0 : 1));
+    }
+    assert(log.n_begins == 2 && log.n_ends == 1);
+
+    // Replaced without a tick in between.
+    sweep_prune_begin(sweep_prune);
+    sweep_prune_sync(sweep_prune, &ids[0], 0, make_box(0, 0, 10, 10), 0);
+    sweep_prune_sync(sweep_prune, &ids[1], 2, make_box(5, 5, 10, 10), 0);
+    memset(log.began, 0, sizeof(log.began));
+    sweep_prune_update(sweep_prune, (sweep_prune_event_func_t)log_event, &log);
+    assert(log.n_begins == 3 && log.n_ends == 2);
+    assert(sweep_prune_size(sweep_prune) == 2);
+    assert(sweep_prune_pair_count(sweep_prune) == 1);
+    sweep_prune_free(sweep_prune);
+}
+
+void test_sweep_prune_random() {
+    size_t ids[N_RANDOM_BOXES];
+    aabb_t boxes[N_RANDOM_BOXES];
+    bool synced[N_RANDOM_BOXES];
+    size_t sides[N_RANDOM_BOXES];
+
+    srand(11);
+    for (size_t self = 0; self < 2; self++) {
+        pair_log_t *log = calloc(1, sizeof(pair_log_t));
+        assert(log != NULL);
+        log->ids = ids;
+        sweep_prune_t *sweep_prune = sweep_prune_init(self);
+        for (size_t i = 0; i < N_RANDOM_BOXES; i++) {
+            ids[i] = i;
+            boxes[i] = make_box(rand() % 200,
+                                rand() % 200,
+                                1 + rand() % 30,
+                                1 + rand() % 30);
+            sides[i] = self ? 0 : rand() % 2;
+        }
+        for (size_t t = 0; t < N_RANDOM_TICKS; t++) {
+            sweep_prune_begin(sweep_prune);
+            for (size_t i = 0; i < N_RANDOM_BOXES; i++) {
+                // Small moves, on a grid so that ends often coincide.
+                vector_t step = {rand() % 7 - 3, rand() % 7 - 3};
+                boxes[i].min = vec_add(boxes[i].min, step);
+                boxes[i].max = vec_add(boxes[i].max, step);
+                // Some objects come and go, and now and then half of them
+                // come back at once.
+                synced[i] = rand() % (t % 25 == 24 ? 2 : 20) != 0;
+                if (synced[i]) {
+                    sweep_prune_sync(sweep_prune,
+                                     &ids[i],
+                                     0,
+                                     boxes[i],
+                                     sides[i]);
+                }
+            }
+            check_update(sweep_prune, self, boxes, synced, sides, log);
+        }
+        sweep_prune_free(sweep_prune);
+        free(log);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_aabb_overlap)
+    DO_TEST(test_polygon_aabb)
+    DO_TEST(test_sweep_prune_events)
+    DO_TEST(test_sweep_prune_drop_and_replace)
+    DO_TEST(test_sweep_prune_random)
+
+    puts("sweep_prune_test PASS");
+}
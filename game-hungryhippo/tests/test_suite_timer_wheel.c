@@ -0,0 +1,176 @@
+#include "test_util.h"
+#include "timer_wheel.h"
+#include <assert.h>
+#include <stdlib.h>
+
+typedef struct fire_log {
+    uint64_t times[16];
+    size_t count;
+    timer_wheel_t *wheel;
+    uint32_t repeat;      // Interval to return.
+    wheel_timer_t *other; // Timer to cancel when called, if any.
+    bool cancel_all;
+} fire_log_t;
+
+uint32_t log_fire(uint32_t interval, fire_log_t *log) {
+    assert(log->count < 16);
+    log->times[log->count++] = timer_wheel_now(log->wheel);
+    if (log->other != NULL) {
+        timer_wheel_cancel(log->wheel, log->other);
+        log->other = NULL;
+    }
+    if (log->cancel_all) {
+        timer_wheel_cancel_all(log->wheel);
+    }
+    return log->repeat;
+}
+
+size_t order[3];
+size_t order_count;
+
+uint32_t log_order(uint32_t interval, size_t *id) {
+    assert(order_count < 3);
+    order[order_count++] = *id;
+    return 0;
+}
+
+void test_timer_wheel_fires_on_time() {
+    timer_wheel_t *wheel = timer_wheel_init();
+    // One per level, and one past the last level.
+    uint32_t intervals[] = {5, 70, 5000, 300000, 20000000};
+    fire_log_t logs[5] = {0};
+    for (size_t i = 0; i < 5; i++) {
+        logs[i].wheel = wheel;
+        timer_wheel_add(wheel,
+                        intervals[i],
+                        (wheel_timer_func_t)log_fire,
+                        &logs[i]);
+    }
+    assert(timer_wheel_size(wheel) == 5);
+
+    // Advance in uneven steps that don't divide the intervals.
+    while (timer_wheel_now(wheel) < 20000001) {
+        timer_wheel_advance(wheel, 1.0 / 120.0);
+    }
+    for (size_t i = 0; i < 5; i++) {
+        assert(logs[i].count == 1);
+        assert(logs[i].times[0] == intervals[i]);
+    }
+    assert(timer_wheel_size(wheel) == 0);
+    timer_wheel_free(wheel);
+}
+
+void test_timer_wheel_repeat_and_order() {
+    timer_wheel_t *wheel = timer_wheel_init();
+    fire_log_t log = {0};
+    log.wheel = wheel;
+    log.repeat = 3;
+    timer_wheel_add(wheel, 2, (wheel_timer_func_t)log_fire, &log);
+    timer_wheel_advance(wheel, 0.0115);
+    // Fired at 2, 5, 8 and 11 ms, and the half millisecond carries over.
+    assert(log.count == 4);
+    for (size_t i = 0; i < 4; i++) {
+        assert(log.times[i] == 2 + 3 * i);
+    }
+    timer_wheel_advance(wheel, 0.0005);
+    assert(timer_wheel_now(wheel) == 12);
+    log.repeat = 0;
+    timer_wheel_advance(wheel, 0.002);
+    assert(log.count == 5 && timer_wheel_size(wheel) == 0);
+
+    // Same expiry, first added goes off first, even from different levels.
+    size_t ids[] = {0, 1, 2};
+    order_count = 0;
+    timer_wheel_add(wheel, 100, (wheel_timer_func_t)log_order, &ids[0]);
+    timer_wheel_advance(wheel, 0.060);
+    timer_wheel_add(wheel, 40, (wheel_timer_func_t)log_order, &ids[1]);
+    timer_wheel_add(wheel, 40, (wheel_timer_func_t)log_order, &ids[2]);
+    timer_wheel_advance(wheel, 0.040);
+    assert(order_count == 3);
+    for (size_t i = 0; i < 3; i++) {
+        assert(order[i] == i);
+    }
+    timer_wheel_free(wheel);
+}
+
+void test_timer_wheel_order_across_levels() {
+    timer_wheel_t *wheel = timer_wheel_init();
+    size_t ids[] = {0, 1, 2};
+
+    // The first is cascaded into the slot the second was added to directly.
+    order_count = 0;
+    timer_wheel_add(wheel, 100, (wheel_timer_func_t)log_order, &ids[0]);
+    timer_wheel_advance(wheel, 0.050);
+    timer_wheel_add(wheel, 50, (wheel_timer_func_t)log_order, &ids[1]);
+    timer_wheel_advance(wheel, 0.050);
+    assert(order_count == 2 && order[0] == 0 && order[1] == 1);
+
+    // Cascaded twice, past timers added to each level below.
+    order_count = 0;
+    timer_wheel_add(wheel, 5000, (wheel_timer_func_t)log_order, &ids[0]);
+    timer_wheel_advance(wheel, 4.0);
+    timer_wheel_add(wheel, 1000, (wheel_timer_func_t)log_order, &ids[1]);
+    timer_wheel_advance(wheel, 0.990);
+    timer_wheel_add(wheel, 10, (wheel_timer_func_t)log_order, &ids[2]);
+    assert(order_count == 0);
+    timer_wheel_advance(wheel, 0.010);
+    assert(order_count == 3);
+    for (size_t i = 0; i < 3; i++) {
+        assert(order[i] == i);
+    }
+    timer_wheel_free(wheel);
+}
+
+void test_timer_wheel_cancel() {
+    timer_wheel_t *wheel = timer_wheel_init();
+    fire_log_t a = {0}, b = {0}, c = {0};
+    a.wheel = b.wheel = c.wheel = wheel;
+
+    // Cancel before it goes off.
+    wheel_timer_t *timer
+        = timer_wheel_add(wheel, 100, (wheel_timer_func_t)log_fire, &a);
+    timer_wheel_cancel(wheel, timer);
+    assert(timer_wheel_size(wheel) == 0);
+
+    // Cancel a timer due at the same time from another's callback.
+    timer_wheel_add(wheel, 10, (wheel_timer_func_t)log_fire, &b);
+    b.other = timer_wheel_add(wheel, 10, (wheel_timer_func_t)log_fire, &a);
+    // A repeating timer that cancels itself is not re-armed.
+    c.repeat = 1;
+    c.other = timer_wheel_add(wheel, 20, (wheel_timer_func_t)log_fire, &c);
+    timer_wheel_advance(wheel, 1);
+    assert(a.count == 0);
+    assert(b.count == 1);
+    assert(c.count == 1);
+    assert(timer_wheel_size(wheel) == 0);
+
+    // Cancel everything from a callback.
+    fire_log_t d = {0};
+    d.wheel = wheel;
+    d.cancel_all = true;
+    d.repeat = 1;
+    timer_wheel_add(wheel, 5, (wheel_timer_func_t)log_fire, &d);
+    timer_wheel_add(wheel, 5, (wheel_timer_func_t)log_fire, &a);
+    timer_wheel_add(wheel, 5000, (wheel_timer_func_t)log_fire, &a);
+    timer_wheel_advance(wheel, 10);
+    assert(d.count == 1 && a.count == 0);
+    assert(timer_wheel_size(wheel) == 0);
+    timer_wheel_free(wheel);
+}
+
+int main(int argc, char *argv[]) {
+    // Run all tests if there are no command-line arguments
+    bool all_tests = argc == 1;
+    // Read test name from file
+    char testname[100];
+    if (!all_tests) {
+        read_testname(argv[1], testname, sizeof(testname));
+    }
+
+    DO_TEST(test_timer_wheel_fires_on_time)
+    DO_TEST(test_timer_wheel_repeat_and_order)
+    DO_TEST(test_timer_wheel_order_across_levels)
+    DO_TEST(test_timer_wheel_cancel)
+
+    puts("timer_wheel_test PASS");
+}